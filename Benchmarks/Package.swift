@@ -0,0 +1,27 @@
+// swift-tools-version:5.9
+//
+//  Linux-buildable benchmarks for the portable clip search and face
+//  matching kernels. The app's Foundation-only sources are symlinked into
+//  the target, so the benchmarks always measure the code that ships.
+//  AllocationCounter counts heap allocations per query on glibc.
+//
+//  Run from this directory:
+//    swift run -c release ClipSearchBenchmarks --help
+//
+
+import PackageDescription
+
+let package = Package(
+    name: "ClipSearchBenchmarks",
+    targets: [
+        .target(
+            name: "AllocationCounter",
+            path: "Sources/AllocationCounter"
+        ),
+        .executableTarget(
+            name: "ClipSearchBenchmarks",
+            dependencies: ["AllocationCounter"],
+            path: "Sources/ClipSearchBenchmarks"
+        ),
+    ]
+)
@@ -0,0 +1,86 @@
+//
+//  AllocationCounter.c
+//  ClipSearchBenchmarks
+//
+//  Counts heap allocations by interposing the glibc allocation entry
+//  points: definitions in the executable take precedence over libc's for
+//  every library, including the Swift runtime, and forward to glibc's
+//  own implementations. Elsewhere the counter reports itself unavailable.
+//
+
+#include "AllocationCounter.h"
+
+#if defined(__GLIBC__)
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static _Atomic uint64_t allocations;
+
+static inline void count_allocation(void) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    count_allocation();
+    return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    count_allocation();
+    void *pointer = __libc_memalign(alignment, size);
+    if (pointer == NULL) {
+        return ENOMEM;
+    }
+    *out = pointer;
+    return 0;
+}
+
+bool allocation_counter_available(void) {
+    return true;
+}
+
+uint64_t allocation_counter_total(void) {
+    return atomic_load_explicit(&allocations, memory_order_relaxed);
+}
+
+#else
+
+bool allocation_counter_available(void) {
+    return false;
+}
+
+uint64_t allocation_counter_total(void) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,20 @@
+//
+//  AllocationCounter.h
+//  ClipSearchBenchmarks
+//
+//  Process-wide heap allocation counter for the benchmarks.
+//
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Whether allocations are being counted (glibc only).
+bool allocation_counter_available(void);
+
+/// Heap allocations made by any thread since launch.
+uint64_t allocation_counter_total(void);
+
+#endif
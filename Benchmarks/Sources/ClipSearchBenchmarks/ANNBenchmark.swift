@@ -0,0 +1,122 @@
+//
+//  ANNBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  Recall@k and latency of HNSWIndex against the exact EmbeddingMatrix
+//  scan, on clustered synthetic vectors. After the first measurement the
+//  benchmark replays the app's lifecycle — prune the oldest clips, add new
+//  ones into the freed slots, re-embed some in place — and measures again,
+//  since delete and update are where graph indexes usually degrade.
+//
+
+import Foundation
+
+func runANNBenchmark(_ options: BenchmarkOptions) {
+    print("== ANN: HNSW vs exact scan (dim \(options.dimension), k \(options.k), \(options.queries) queries) ==")
+    for size in options.sizes where size > 0 {
+        runANNBenchmark(size: size, options: options)
+    }
+}
+
+private func runANNBenchmark(size: Int, options: BenchmarkOptions) {
+    var data = SyntheticEmbeddings(dimension: options.dimension, seed: options.seed)
+    var exact = EmbeddingMatrix()
+    var hnsw = HNSWIndex()
+    var ids: [UUID] = []
+    ids.reserveCapacity(size)
+
+    var exactBuild: UInt64 = 0
+    var hnswBuild: UInt64 = 0
+    for _ in 0..<size {
+        let id = UUID()
+        let vector = data.next()
+        ids.append(id)
+
+        var start = nowNanoseconds()
+        exact.upsert(vector, for: id)
+        exactBuild += nowNanoseconds() - start
+
+        start = nowNanoseconds()
+        hnsw.upsert(vector, for: id)
+        hnswBuild += nowNanoseconds() - start
+    }
+
+    print("\n-- \(size) vectors --")
+    print("build: exact \(formatDuration(Double(exactBuild))), hnsw \(formatDuration(Double(hnswBuild)))"
+          + " (\(formatDuration(Double(hnswBuild) / Double(size)))/insert)")
+
+    var queries = makeQueries(from: exact, count: options.queries, data: &data)
+    report("insert", exact: exact, hnsw: hnsw, queries: queries, k: options.k)
+
+    // Prune the oldest 10%, as ClipManager does when clips age out.
+    let pruned = size / 10
+    for id in ids.prefix(pruned) {
+        exact.remove(id)
+        hnsw.remove(id)
+    }
+    ids.removeFirst(pruned)
+
+    // New clips arrive into the freed slots.
+    for _ in 0..<pruned {
+        let id = UUID()
+        let vector = data.next()
+        ids.append(id)
+        exact.upsert(vector, for: id)
+        hnsw.upsert(vector, for: id)
+    }
+
+    // Re-embed 5% in place, as vision enhancement does.
+    var rng = SplitMix64(seed: options.seed &+ 1)
+    for _ in 0..<max(1, ids.count / 20) where !ids.isEmpty {
+        let id = ids[Int(rng.next() % UInt64(ids.count))]
+        let vector = data.next()
+        exact.upsert(vector, for: id)
+        hnsw.upsert(vector, for: id)
+    }
+
+    queries = makeQueries(from: exact, count: options.queries, data: &data)
+    report("churn", exact: exact, hnsw: hnsw, queries: queries, k: options.k)
+}
+
+/// Queries near stored vectors, like a spoken question about a recorded moment.
+private func makeQueries(from index: EmbeddingMatrix, count: Int, data: inout SyntheticEmbeddings) -> [[Float]] {
+    guard index.count > 0 else { return [] }
+    let dim = index.dimension
+    var rng = SplitMix64(seed: UInt64(index.count))
+    return (0..<count).map { _ in
+        let row = Int(rng.next() % UInt64(index.count))
+        let stored = Array(index.storage[row * dim..<(row + 1) * dim])
+        return data.perturbed(stored, by: 0.05)
+    }
+}
+
+private func report(_ phase: String, exact: EmbeddingMatrix, hnsw: HNSWIndex, queries: [[Float]], k: Int) {
+    var exactTimes: [UInt64] = []
+    var hnswTimes: [UInt64] = []
+    exactTimes.reserveCapacity(queries.count)
+    hnswTimes.reserveCapacity(queries.count)
+    var found = 0
+    var expected = 0
+
+    for query in queries {
+        var start = nowNanoseconds()
+        let truth = exact.search(query, k: k)
+        exactTimes.append(nowNanoseconds() - start)
+
+        start = nowNanoseconds()
+        let approx = hnsw.search(query, k: k)
+        hnswTimes.append(nowNanoseconds() - start)
+
+        let truthIDs = Set(truth.map(\.id))
+        found += approx.reduce(0) { $0 + (truthIDs.contains($1.id) ? 1 : 0) }
+        expected += truth.count
+    }
+
+    let exactStats = LatencyStats(exactTimes)
+    let hnswStats = LatencyStats(hnswTimes)
+    let recall = expected > 0 ? Double(found) / Double(expected) : 1
+    print("[\(phase)] \(hnsw.count) live, recall@\(k) \(String(format: "%.4f", recall))")
+    print("  exact p50 \(formatDuration(exactStats.p50)), p99 \(formatDuration(exactStats.p99))")
+    print("  hnsw  p50 \(formatDuration(hnswStats.p50)), p99 \(formatDuration(hnswStats.p99))"
+          + String(format: " (%.1fx faster at p99)", hnswStats.p99 > 0 ? exactStats.p99 / hnswStats.p99 : 0))
+}
@@ -0,0 +1,207 @@
+//
+//  BenchmarkSupport.swift
+//  ClipSearchBenchmarks
+//
+//  Command-line options, timing, percentile statistics, allocation
+//  counting and synthetic embedding generation shared by the benchmarks.
+//
+
+import AllocationCounter
+import Foundation
+
+// MARK: - Options
+
+struct BenchmarkOptions {
+
+    static let usage = """
+    Usage: ClipSearchBenchmarks [options]
+      --sizes N,N,...   Corpus sizes (default 10000,100000,1000000)
+      --dim N           Vector dimension (default 512, NLEmbedding's sentence size)
+      --queries N       Queries per corpus size (default 200)
+      --k N             Neighbours per query (default 10)
+      --seed N          Random seed (default 1)
+      --people N,N,...  Contact counts for face matching (default 10,100,1000)
+      --photos N        Reference embeddings per contact (default 5)
+      --bench a,b,...   Benchmarks to run: ann, quant, persist, search, face, features (default all)
+    """
+
+    var sizes = [10_000, 100_000, 1_000_000]
+    var dimension = 512
+    var queries = 200
+    var k = 10
+    var seed: UInt64 = 1
+    var people = [10, 100, 1_000]
+    var photos = 5
+    var benchmarks: Set<String> = ["ann", "quant", "persist", "search", "face", "features"]
+    var showHelp = false
+
+    init(arguments: [String]) {
+        var i = 0
+        func value() -> String? {
+            i += 1
+            return i < arguments.count ? arguments[i] : nil
+        }
+        while i < arguments.count {
+            switch arguments[i] {
+            case "--sizes":
+                sizes = (value() ?? "").split(separator: ",").compactMap { Int($0) }
+            case "--dim":
+                dimension = value().flatMap { Int($0) } ?? dimension
+            case "--queries":
+                queries = value().flatMap { Int($0) } ?? queries
+            case "--k":
+                k = value().flatMap { Int($0) } ?? k
+            case "--seed":
+                seed = value().flatMap { UInt64($0) } ?? seed
+            case "--people":
+                people = (value() ?? "").split(separator: ",").compactMap { Int($0) }
+            case "--photos":
+                photos = value().flatMap { Int($0) } ?? photos
+            case "--bench":
+                benchmarks = Set((value() ?? "").split(separator: ",").map(String.init))
+            case "--help", "-h":
+                showHelp = true
+            default:
+                print("Ignoring unknown option \(arguments[i])")
+            }
+            i += 1
+        }
+    }
+}
+
+// MARK: - Timing
+
+/// Monotonic nanoseconds.
+@inline(__always)
+func nowNanoseconds() -> UInt64 {
+    DispatchTime.now().uptimeNanoseconds
+}
+
+/// Latency distribution of a set of samples, in nanoseconds.
+struct LatencyStats {
+
+    let count: Int
+    let mean: Double
+    let p50: Double
+    let p99: Double
+
+    init(_ samples: [UInt64]) {
+        let sorted = samples.sorted()
+        count = sorted.count
+        mean = sorted.isEmpty ? 0 : Double(sorted.reduce(0, +)) / Double(sorted.count)
+        p50 = Self.percentile(0.50, of: sorted)
+        p99 = Self.percentile(0.99, of: sorted)
+    }
+
+    private static func percentile(_ p: Double, of sorted: [UInt64]) -> Double {
+        guard !sorted.isEmpty else { return 0 }
+        let rank = Int((p * Double(sorted.count - 1)).rounded(.up))
+        return Double(sorted[min(rank, sorted.count - 1)])
+    }
+}
+
+/// Per-query latency, heap allocations and single-thread throughput of a query loop.
+struct QueryMeasurement {
+
+    let latency: LatencyStats
+    /// Nil where allocations cannot be counted (non-glibc platforms).
+    let allocationsPerQuery: Double?
+    let queriesPerSecond: Double
+
+    /// Run `body` once per query. It returns something derived from its result
+    /// (e.g. a hit count) so the optimizer cannot discard the work.
+    init<Query>(_ queries: [Query], _ body: (Query) -> Int) {
+        var samples: [UInt64] = []
+        samples.reserveCapacity(queries.count)
+        var sink = 0
+        let allocationsBefore = allocation_counter_total()
+        let loopStart = nowNanoseconds()
+        for query in queries {
+            let start = nowNanoseconds()
+            sink &+= body(query)
+            samples.append(nowNanoseconds() - start)
+        }
+        let elapsed = nowNanoseconds() - loopStart
+        let allocations = allocation_counter_total() - allocationsBefore
+        blackHole(sink)
+
+        latency = LatencyStats(samples)
+        allocationsPerQuery = allocation_counter_available() && !queries.isEmpty
+            ? Double(allocations) / Double(queries.count) : nil
+        queriesPerSecond = elapsed > 0 ? Double(queries.count) * 1e9 / Double(elapsed) : 0
+    }
+
+    /// One line: ns/query, percentiles, allocations/query and queries/s.
+    var summary: String {
+        let allocations = allocationsPerQuery.map { String(format: "%.1f allocs/query", $0) } ?? "allocs n/a"
+        return String(format: "%.0f ns/query", latency.mean)
+            + " (p50 \(formatDuration(latency.p50)), p99 \(formatDuration(latency.p99))), "
+            + allocations + String(format: ", %.0f queries/s", queriesPerSecond)
+    }
+}
+
+/// Keep `value` alive past the optimizer.
+@inline(never)
+func blackHole<T>(_ value: T) {
+    withExtendedLifetime(value) {}
+}
+
+/// Format nanoseconds with a readable unit.
+func formatDuration(_ nanoseconds: Double) -> String {
+    switch nanoseconds {
+    case ..<1_000:         return String(format: "%.0f ns", nanoseconds)
+    case ..<1_000_000:     return String(format: "%.1f µs", nanoseconds / 1_000)
+    case ..<1_000_000_000: return String(format: "%.2f ms", nanoseconds / 1_000_000)
+    default:               return String(format: "%.2f s", nanoseconds / 1_000_000_000)
+    }
+}
+
+// MARK: - Synthetic Data
+
+/// Clustered unit vectors. Real sentence embeddings are far from uniform,
+/// and uniform random vectors make every ANN index look worse than it is.
+struct SyntheticEmbeddings {
+
+    let dimension: Int
+    private var rng: SplitMix64
+    private var centers: [[Float]] = []
+    private let spread: Float
+
+    init(dimension: Int, clusters: Int = 256, spread: Float = 0.6, seed: UInt64) {
+        self.dimension = dimension
+        self.spread = spread
+        rng = SplitMix64(seed: seed)
+        for _ in 0..<clusters {
+            centers.append((0..<dimension).map { _ in gaussian() })
+        }
+    }
+
+    /// A new vector drawn around a random cluster center.
+    mutating func next() -> [Float] {
+        let center = centers[Int(rng.next() % UInt64(centers.count))]
+        return perturbed(center, by: spread)
+    }
+
+    /// A unit vector near `vector`, used to build queries close to stored clips.
+    mutating func perturbed(_ vector: [Float], by amount: Float) -> [Float] {
+        var out = vector
+        for i in 0..<out.count {
+            out[i] += amount * gaussian()
+        }
+        return Self.unit(out)
+    }
+
+    private mutating func gaussian() -> Float {
+        // Box-Muller; one sample per call keeps the generator state simple.
+        let u1 = max(Double(rng.next() >> 11) * 0x1.0p-53, .leastNonzeroMagnitude)
+        let u2 = Double(rng.next() >> 11) * 0x1.0p-53
+        return Float((-2 * log(u1)).squareRoot() * cos(2 * .pi * u2))
+    }
+
+    static func unit(_ v: [Float]) -> [Float] {
+        var sum: Float = 0
+        for x in v { sum += x * x }
+        let scale = sum > 0 ? 1 / sum.squareRoot() : 0
+        return v.map { $0 * scale }
+    }
+}
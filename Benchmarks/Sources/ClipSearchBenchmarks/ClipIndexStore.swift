@@ -0,0 +1 @@
+../../../treehacks/Services/ClipIndexStore.swift
\ No newline at end of file
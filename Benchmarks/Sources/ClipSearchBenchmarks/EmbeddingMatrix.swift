@@ -0,0 +1 @@
+../../../treehacks/Services/EmbeddingMatrix.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Services/FaceDescriptor.swift
\ No newline at end of file
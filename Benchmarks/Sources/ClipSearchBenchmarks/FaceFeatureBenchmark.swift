@@ -0,0 +1,95 @@
+//
+//  FaceFeatureBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  Cost of turning one face's landmarks into a feature vector, on the
+//  shared landmark fixtures: the old append/flatMap pipeline both callers
+//  used to carry, `FaceFeatureBuilder` into a reused buffer (the live
+//  path), and a new `FaceDescriptor` per face.
+//
+
+import Foundation
+
+func runFaceFeatureBenchmark(_ options: BenchmarkOptions) {
+    print("== Face feature building (\(FaceLandmarkFixtures.all.count) landmark fixtures, \(options.queries) faces) ==")
+    let faces = (0..<options.queries).map { FaceLandmarkFixtures.all[$0 % FaceLandmarkFixtures.all.count] }
+    // What Vision hands the old pipeline: one [CGPoint] per present region.
+    let points: [[[CGPoint]]] = faces.map { face in
+        face.map { region in
+            stride(from: 0, to: region.count, by: 2).map { CGPoint(x: region[$0], y: region[$0 + 1]) }
+        }
+    }
+
+    let reference = QueryMeasurement(points) { face in
+        appendedFeatures(face).count
+    }
+
+    let buffer = UnsafeMutablePointer<Float>.allocate(capacity: FaceDescriptor.dimension)
+    defer { buffer.deallocate() }
+    let builder = QueryMeasurement(faces) { face in
+        var builder = FaceFeatureBuilder(writingInto: buffer)
+        for (region, points) in zip(FaceDescriptor.Region.allCases, face) {
+            points.withUnsafeBufferPointer { builder.add(region, points: $0) }
+        }
+        return Int(builder.finish())
+    }
+
+    let descriptor = QueryMeasurement(faces) { face in
+        Int(faceDescriptor(face).mask)
+    }
+
+    print("  append pipeline  " + reference.summary)
+    print("  builder          " + builder.summary)
+    print("  descriptor       " + descriptor.summary)
+}
+
+/// The variable-length pipeline `FaceRecognitionModel` and
+/// `FaceEmbeddingExtractor` each carried before the shared builder.
+private func appendedFeatures(_ regions: [[CGPoint]]) -> [Float] {
+    func normalizePoints(_ points: [CGPoint]) -> [Float] {
+        points.flatMap { [Float($0.x), Float($0.y)] }
+    }
+    func width(_ points: [CGPoint]) -> CGFloat {
+        let xs = points.map(\.x)
+        guard let lo = xs.min(), let hi = xs.max() else { return 0 }
+        return hi - lo
+    }
+    func height(_ points: [CGPoint]) -> CGFloat {
+        let ys = points.map(\.y)
+        guard let lo = ys.min(), let hi = ys.max() else { return 0 }
+        return hi - lo
+    }
+    func region(_ region: FaceDescriptor.Region) -> [CGPoint]? {
+        let points = regions[region.rawValue]
+        return points.isEmpty ? nil : points
+    }
+
+    var features: [Float] = []
+    for points in regions where !points.isEmpty {
+        features.append(contentsOf: normalizePoints(points))
+    }
+
+    var geo: [Float] = []
+    if let leftEye = region(.leftEye), let rightEye = region(.rightEye) {
+        let lw = width(leftEye)
+        let rw = width(rightEye)
+        if rw > 0 { geo.append(Float(lw / rw)) }
+    }
+    if let lp = region(.leftPupil)?.first, let rp = region(.rightPupil)?.first {
+        geo.append(Float(sqrt(pow(rp.x - lp.x, 2) + pow(rp.y - lp.y, 2))))
+    }
+    if let nose = region(.nose), let outerLips = region(.outerLips) {
+        let noseCY = nose.map(\.y).reduce(0, +) / CGFloat(nose.count)
+        let mouthCY = outerLips.map(\.y).reduce(0, +) / CGFloat(outerLips.count)
+        geo.append(Float(abs(mouthCY - noseCY)))
+    }
+    if let contour = region(.faceContour) {
+        let h = height(contour)
+        if h > 0 { geo.append(Float(width(contour) / h)) }
+    }
+    if let outerLips = region(.outerLips) {
+        geo.append(Float(width(outerLips)))
+    }
+    features.append(contentsOf: geo)
+    return features
+}
@@ -0,0 +1 @@
+../../../treehacks/Services/FaceFeatureBuilder.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacksTests/FaceLandmarkFixtures.swift
\ No newline at end of file
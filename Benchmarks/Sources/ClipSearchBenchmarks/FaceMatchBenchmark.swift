@@ -0,0 +1,100 @@
+//
+//  FaceMatchBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  Face matching as `FaceRecognitionModel` drives it: live landmark
+//  descriptors against every contact's reference descriptors, through the
+//  per-contact reference loop and through the compiled `FaceGallery`
+//  (one face at a time and a frame of several faces at once). Some live
+//  faces miss a landmark region, as Vision's do, to exercise masked matching.
+//
+
+import Foundation
+
+/// Faces per frame for the batched gallery run.
+private let facesPerFrame = 4
+
+/// Fraction of live faces with one landmark region missing.
+private let partialFaceRate = 0.25
+
+func runFaceMatchBenchmark(_ options: BenchmarkOptions) {
+    print("== Face matching (\(FaceDescriptor.dimension)-float descriptors, \(options.photos) photos/contact, \(options.queries) queries) ==")
+    for people in options.people where people > 0 {
+        runFaceMatchBenchmark(people: people, options: options)
+    }
+}
+
+private func runFaceMatchBenchmark(people: Int, options: BenchmarkOptions) {
+    var rng = SplitMix64(seed: options.seed &+ 3)
+    func uniform() -> Float { Float(rng.next() >> 40) * 0x1.0p-24 }
+
+    // Normalized landmark points, x/y interleaved per region: each contact's
+    // photos scatter around their face.
+    func jittered(_ face: [[Double]], by amount: Float) -> [[Double]] {
+        face.map { points in points.map { $0 + Double(amount * (uniform() - 0.5)) } }
+    }
+    let faces: [[[Double]]] = (0..<people).map { _ in
+        FaceDescriptor.Region.allCases.map { region in (0..<region.pointCount * 2).map { _ in Double(uniform()) } }
+    }
+    let galleries: [[FaceDescriptor]] = faces.map { face in
+        (0..<max(1, options.photos)).map { _ in faceDescriptor(jittered(face, by: 0.02)) }
+    }
+    let queries: [(face: Int, features: FaceDescriptor)] = (0..<options.queries).map { _ in
+        let face = Int(rng.next() % UInt64(people))
+        var landmarks = jittered(faces[face], by: 0.04)
+        if Double(uniform()) < partialFaceRate {
+            landmarks[Int(rng.next() % UInt64(landmarks.count))] = []
+        }
+        return (face, faceDescriptor(landmarks))
+    }
+
+    var correct = 0
+    for query in queries {
+        let similarities = FaceMatcher.bestSimilarities(for: query.features, in: galleries)
+        if FaceMatcher.bestMatch(in: similarities) == query.face { correct += 1 }
+    }
+
+    let reference = QueryMeasurement(queries) { query in
+        FaceMatcher.bestMatch(in: FaceMatcher.bestSimilarities(for: query.features, in: galleries)) ?? -1
+    }
+
+    let gallery = FaceGallery(galleries: galleries)
+    let workspace = FaceGallery.Workspace()
+    let single: [[FaceDescriptor?]] = queries.map { [$0.features] }
+    var galleryCorrect = 0
+    for (query, faces) in zip(queries, single) {
+        gallery.match(faces, in: workspace)
+        if workspace.matches[0]?.owner == query.face { galleryCorrect += 1 }
+    }
+    let compiled = QueryMeasurement(single) { faces in
+        gallery.match(faces, in: workspace)
+        return workspace.matches[0]?.owner ?? -1
+    }
+
+    let frames: [[FaceDescriptor?]] = stride(from: 0, to: queries.count, by: facesPerFrame).map { start in
+        queries[start..<min(start + facesPerFrame, queries.count)].map(\.features)
+    }
+    let batched = QueryMeasurement(frames) { faces in
+        gallery.match(faces, in: workspace)
+        return workspace.matches.count
+    }
+
+    func accuracy(_ hits: Int) -> String {
+        String(format: ", %.1f%% correct", queries.isEmpty ? 0 : 100 * Double(hits) / Double(queries.count))
+    }
+    print("\n-- \(people) contacts, \(people * max(1, options.photos)) embeddings --")
+    print("  reference  " + reference.summary + accuracy(correct))
+    print("  gallery    " + compiled.summary + accuracy(galleryCorrect))
+    // Each "query" here is a whole frame of faces.
+    print("  frame of \(facesPerFrame) faces  " + batched.summary)
+}
+
+/// Descriptor of one face's landmarks, regions in `FaceDescriptor.Region`
+/// order (empty when absent), as `FaceFeatureBuilder` takes them.
+func faceDescriptor(_ landmarks: [[Double]]) -> FaceDescriptor {
+    FaceDescriptor { builder in
+        for (region, points) in zip(FaceDescriptor.Region.allCases, landmarks) {
+            points.withUnsafeBufferPointer { builder.add(region, points: $0) }
+        }
+    }
+}
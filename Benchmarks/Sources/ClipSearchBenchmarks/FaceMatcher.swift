@@ -0,0 +1 @@
+../../../treehacks/Services/FaceMatcher.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Services/HNSWIndex.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Models/IndexedClip.swift
\ No newline at end of file
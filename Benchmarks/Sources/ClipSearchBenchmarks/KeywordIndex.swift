@@ -0,0 +1 @@
+../../../treehacks/Services/KeywordIndex.swift
\ No newline at end of file
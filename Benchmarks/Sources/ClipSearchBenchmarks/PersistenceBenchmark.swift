@@ -0,0 +1,78 @@
+//
+//  PersistenceBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  Reopen cost of the on-disk clip index: write a history of synthetic
+//  clips, then time opening the store, loading its clips (records only),
+//  the first query served from the mapped vectors, and decoding every
+//  clip's keywords and vector from the mapping (the background work of a
+//  restore, before the in-memory index inserts them).
+//
+
+import Foundation
+
+func runPersistenceBenchmark(_ options: BenchmarkOptions) {
+    print("== Persistent clip index reopen (dim \(options.dimension)) ==")
+    for size in options.sizes where size > 0 {
+        runPersistenceBenchmark(size: size, options: options)
+    }
+}
+
+private func runPersistenceBenchmark(size: Int, options: BenchmarkOptions) {
+    let root = FileManager.default.temporaryDirectory
+        .appendingPathComponent("clip_index_bench_\(UUID().uuidString)", isDirectory: true)
+    let directory = root.appendingPathComponent("clip_index", isDirectory: true)
+    let videos = root.appendingPathComponent("videos", isDirectory: true)
+    defer { try? FileManager.default.removeItem(at: root) }
+
+    var data = SyntheticEmbeddings(dimension: options.dimension, seed: options.seed)
+    var probe: [Float] = []
+    var start = nowNanoseconds()
+    do {
+        let store = ClipIndexStore(directory: directory, dimension: options.dimension)
+        let epoch = Date(timeIntervalSinceReferenceDate: 700_000_000)
+        for i in 0..<size {
+            let vector = data.next()
+            if i == size / 2 { probe = vector }
+            let clip = IndexedClip(
+                fileURL: videos.appendingPathComponent("clip_\(i).mov"),
+                startTime: epoch.addingTimeInterval(Double(i) * 6),
+                endTime: epoch.addingTimeInterval(Double(i + 1) * 6),
+                keywords: ["person", "desk", "laptop", "cup"],
+                description: "I see person, desk, laptop, cup",
+                hasEmbedding: true
+            )
+            store.append(clip, embedding: vector.map(Double.init))
+        }
+        // Drain the store's write queue before timing the reopen.
+        _ = store.load(videoDirectory: videos)
+    }
+    let writeTime = nowNanoseconds() - start
+
+    start = nowNanoseconds()
+    let reopened = ClipIndexStore(directory: directory, dimension: options.dimension)
+    let openTime = nowNanoseconds() - start
+
+    start = nowNanoseconds()
+    let restored = reopened.load(videoDirectory: videos)
+    let loadTime = nowNanoseconds() - start
+
+    start = nowNanoseconds()
+    let hits = restored.vectors?.search(probe, k: 10, excluding: []) ?? []
+    let queryTime = nowNanoseconds() - start
+
+    start = nowNanoseconds()
+    let keywordCount = restored.clips.reduce(0) { $0 + $1.keywords.count }
+    let decodeTime = nowNanoseconds() - start
+
+    start = nowNanoseconds()
+    let vectorCount = restored.clips.reduce(0) { $0 + (restored.vectors?.unitVector(for: $1.id) == nil ? 0 : 1) }
+    let vectorDecodeTime = nowNanoseconds() - start
+
+    print("\n-- \(size) clips --")
+    print("write \(formatDuration(Double(writeTime))), open \(formatDuration(Double(openTime))),"
+          + " load \(restored.clips.count) clips \(formatDuration(Double(loadTime))),"
+          + " first mapped query \(formatDuration(Double(queryTime))) (\(hits.count) hits),"
+          + " decode \(keywordCount) keywords \(formatDuration(Double(decodeTime))),"
+          + " decode \(vectorCount) vectors \(formatDuration(Double(vectorDecodeTime)))")
+}
@@ -0,0 +1,92 @@
+//
+//  QuantizationBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  Memory, recall@1 and latency of quantized clip vector stores against
+//  the exact Float32 scan. The baseline memory figure is what an
+//  `IndexedClip` used to carry: a [Double] NLEmbedding vector per clip.
+//
+
+import Foundation
+
+func runQuantizationBenchmark(_ options: BenchmarkOptions) {
+    print("== Quantized storage vs exact Float32 (dim \(options.dimension), \(options.queries) queries) ==")
+    for size in options.sizes where size > 0 {
+        runQuantizationBenchmark(size: size, options: options)
+    }
+}
+
+private func runQuantizationBenchmark(size: Int, options: BenchmarkOptions) {
+    var data = SyntheticEmbeddings(dimension: options.dimension, seed: options.seed)
+    var exact = EmbeddingMatrix()
+    var stores: [(name: String, index: QuantizedEmbeddingStore)] = [
+        ("int8", QuantizedEmbeddingStore(encoding: .int8, rerankCount: 0)),
+        ("int8+rerank", QuantizedEmbeddingStore(encoding: .int8, rerankCount: 32)),
+        ("float16", QuantizedEmbeddingStore(encoding: .float16, rerankCount: 0)),
+    ]
+    var graphs: [(name: String, index: HNSWIndex)] = [
+        ("hnsw float32", HNSWIndex(encoding: .float32)),
+        ("hnsw int8", HNSWIndex(encoding: .int8)),
+    ]
+
+    for _ in 0..<size {
+        let id = UUID()
+        let vector = data.next()
+        exact.upsert(vector, for: id)
+        for i in stores.indices { stores[i].index.upsert(vector, for: id) }
+        for i in graphs.indices { graphs[i].index.upsert(vector, for: id) }
+    }
+
+    // Queries close to stored clips, with the exact nearest clip as ground truth.
+    var rng = SplitMix64(seed: options.seed &+ 2)
+    let dim = exact.dimension
+    let queries: [[Float]] = (0..<options.queries).map { _ in
+        let row = Int(rng.next() % UInt64(exact.count))
+        return data.perturbed(Array(exact.storage[row * dim..<(row + 1) * dim]), by: 0.05)
+    }
+    let truth = queries.map { exact.search($0, k: 1).first?.id }
+
+    let baselineBytes = size * (options.dimension * MemoryLayout<Double>.size)
+    print("\n-- \(size) vectors (baseline [Double]: \(formatBytes(baselineBytes))) --")
+    report("float32 exact", bytes: exact.storage.count * MemoryLayout<Float>.size,
+           baselineBytes: baselineBytes, index: exact, queries: queries, truth: truth)
+    for store in stores {
+        report(store.name, bytes: store.index.vectorBytes,
+               baselineBytes: baselineBytes, index: store.index, queries: queries, truth: truth)
+    }
+    for graph in graphs {
+        report(graph.name, bytes: graph.index.vectorBytes,
+               baselineBytes: baselineBytes, index: graph.index, queries: queries, truth: truth)
+    }
+}
+
+private func report(
+    _ name: String, bytes: Int, baselineBytes: Int,
+    index: some VectorIndex, queries: [[Float]], truth: [UUID?]
+) {
+    var times: [UInt64] = []
+    times.reserveCapacity(queries.count)
+    var correct = 0
+    for (query, expected) in zip(queries, truth) {
+        let start = nowNanoseconds()
+        let best = index.search(query, k: 1).first
+        times.append(nowNanoseconds() - start)
+        if best?.id == expected { correct += 1 }
+    }
+    let stats = LatencyStats(times)
+    let recall = queries.isEmpty ? 1 : Double(correct) / Double(queries.count)
+    let ratio = bytes > 0 ? Double(baselineBytes) / Double(bytes) : 0
+    print(name.padding(toLength: 14, withPad: " ", startingAt: 0)
+          + " vectors \(formatBytes(bytes)) (\(String(format: "%.1fx", ratio)) smaller),"
+          + " recall@1 \(String(format: "%.4f", recall)),"
+          + " p50 \(formatDuration(stats.p50)), p99 \(formatDuration(stats.p99))")
+}
+
+private func formatBytes(_ bytes: Int) -> String {
+    let value = Double(bytes)
+    switch value {
+    case ..<1_048_576:     return String(format: "%.1f KiB", value / 1024)
+    case ..<1_073_741_824: return String(format: "%.1f MiB", value / 1_048_576)
+    default:               return String(format: "%.2f GiB", value / 1_073_741_824)
+    }
+}
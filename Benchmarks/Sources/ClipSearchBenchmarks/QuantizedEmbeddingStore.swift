@@ -0,0 +1 @@
+../../../treehacks/Services/QuantizedEmbeddingStore.swift
\ No newline at end of file
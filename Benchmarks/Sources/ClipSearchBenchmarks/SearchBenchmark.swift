@@ -0,0 +1,61 @@
+//
+//  SearchBenchmark.swift
+//  ClipSearchBenchmarks
+//
+//  The clip search paths behind `ClipSearchEngine`, minus the NLEmbedding
+//  call: nearest-vector search and BM25 keyword scoring over the
+//  hour-partitioned index, over all history and restricted to the last
+//  hour, plus parsing the time phrase out of a query.
+//
+
+import Foundation
+
+func runSearchBenchmark(_ options: BenchmarkOptions) {
+    print("== Clip search (dim \(options.dimension), k \(options.k), \(options.queries) queries) ==")
+    for size in options.sizes where size > 0 {
+        runSearchBenchmark(size: size, options: options)
+    }
+}
+
+/// Object and scene labels clips are tagged with.
+private let vocabulary: [String] = (0..<500).map { "label\($0)" }
+
+private func runSearchBenchmark(size: Int, options: BenchmarkOptions) {
+    var data = SyntheticEmbeddings(dimension: options.dimension, seed: options.seed)
+    var rng = SplitMix64(seed: options.seed &+ 2)
+    var index = TimePartitionedIndex(makeVectorIndex: { HNSWIndex() })
+    var stored: [(vector: [Float], keywords: Set<String>)] = []
+    stored.reserveCapacity(size)
+
+    // One 6-second clip after another, as ClipManager records them.
+    let epoch = Date(timeIntervalSinceReferenceDate: 700_000_000)
+    let start = nowNanoseconds()
+    for i in 0..<size {
+        let vector = data.next()
+        var keywords: Set<String> = []
+        while keywords.count < 4 {
+            keywords.insert(vocabulary[Int(rng.next() % UInt64(vocabulary.count))])
+        }
+        index.upsert(id: UUID(), endTime: epoch.addingTimeInterval(Double(i + 1) * 6), keywords: keywords,
+                     description: "I see " + keywords.sorted().joined(separator: ", "), unitVector: vector)
+        stored.append((vector, keywords))
+    }
+    let buildTime = nowNanoseconds() - start
+    let now = epoch.addingTimeInterval(Double(size) * 6)
+
+    // Queries about a stored moment: a nearby vector and two of its labels.
+    let queries: [(vector: [Float], terms: Set<String>)] = (0..<options.queries).map { _ in
+        let clip = stored[Int(rng.next() % UInt64(stored.count))]
+        return (data.perturbed(clip.vector, by: 0.05), Set(clip.keywords.sorted().prefix(2)))
+    }
+    let spoken = queries.map { "where was the " + $0.terms.sorted().joined(separator: " ") + " in the last hour" }
+    let lastHour = TemporalQuery(spoken.first ?? "", now: now).range
+
+    print("\n-- \(size) clips, \(Int((Double(size) * 6 / TimePartitionedIndex.segmentDuration).rounded(.up))) hour segments --")
+    print("build \(formatDuration(Double(buildTime))) (\(formatDuration(Double(buildTime) / Double(size)))/clip)")
+    print("  vector, all      " + QueryMeasurement(queries) { index.search($0.vector, k: options.k, in: nil).count }.summary)
+    print("  vector, 1 hour   " + QueryMeasurement(queries) { index.search($0.vector, k: options.k, in: lastHour).count }.summary)
+    print("  bm25, all        " + QueryMeasurement(queries) { index.bm25Scores(for: $0.terms, in: nil).count }.summary)
+    print("  bm25, 1 hour     " + QueryMeasurement(queries) { index.bm25Scores(for: $0.terms, in: lastHour).count }.summary)
+    print("  time phrase      " + QueryMeasurement(spoken) { TemporalQuery($0, now: now).text.count }.summary)
+}
@@ -0,0 +1 @@
+../../../treehacks/Services/TemporalQuery.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Services/TimePartitionedIndex.swift
\ No newline at end of file
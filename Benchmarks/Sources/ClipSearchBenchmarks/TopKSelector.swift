@@ -0,0 +1 @@
+../../../treehacks/Services/TopKSelector.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Services/VectorCodes.swift
\ No newline at end of file
@@ -0,0 +1 @@
+../../../treehacks/Services/VectorIndex.swift
\ No newline at end of file
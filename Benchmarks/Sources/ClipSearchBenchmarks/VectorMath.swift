@@ -0,0 +1 @@
+../../../treehacks/Services/VectorMath.swift
\ No newline at end of file
@@ -0,0 +1,33 @@
+//
+//  main.swift
+//  ClipSearchBenchmarks
+//
+//  Entry point: parses options and runs each benchmark in turn.
+//
+
+import Foundation
+
+let options = BenchmarkOptions(arguments: Array(CommandLine.arguments.dropFirst()))
+if options.showHelp {
+    print(BenchmarkOptions.usage)
+    exit(0)
+}
+
+if options.benchmarks.contains("ann") {
+    runANNBenchmark(options)
+}
+if options.benchmarks.contains("quant") {
+    runQuantizationBenchmark(options)
+}
+if options.benchmarks.contains("persist") {
+    runPersistenceBenchmark(options)
+}
+if options.benchmarks.contains("search") {
+    runSearchBenchmark(options)
+}
+if options.benchmarks.contains("face") {
+    runFaceMatchBenchmark(options)
+}
+if options.benchmarks.contains("features") {
+    runFaceFeatureBenchmark(options)
+}
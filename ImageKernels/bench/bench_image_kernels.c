@@ -0,0 +1,136 @@
+//
+//  bench_image_kernels.c
+//  ImageKernels
+//
+//  Times each kernel on synthetic frames at ARKit's capture size for every
+//  supported instruction set. Usage: bench_image_kernels [iterations]
+//
+
+#include "image_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+    frame_width = 1920,
+    frame_height = 1440,
+    // The thumbnail size sent for vision analysis.
+    thumb_width = 480,
+    thumb_height = 360,
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/// A frame with some structure: diagonal gradients plus noise.
+static uint8_t *synthetic_plane(size_t stride, size_t height, unsigned seed) {
+    uint8_t *plane = malloc(stride * height);
+    uint32_t state = 0x9E3779B9u ^ seed;
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < stride; x++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            plane[y * stride + x] = (uint8_t)((x + 2 * y) / 8 + (state >> 28));
+        }
+    }
+    return plane;
+}
+
+static volatile uint64_t sink;
+
+typedef struct {
+    const uint8_t *bgra, *luma, *y, *uv, *u, *v;
+    uint8_t *out_a, *out_b, *out_c;
+} frames;
+
+static void run(const char *name, int iterations, size_t pixels, const frames *f,
+                void (*body)(const frames *)) {
+    body(f);  // warm up
+    double start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        body(f);
+    }
+    double elapsed = now_seconds() - start;
+    double ms = elapsed * 1e3 / iterations;
+    printf("  %-22s %8.3f ms/frame %9.1f Mpx/s\n", name, ms, (double)pixels * iterations / elapsed / 1e6);
+}
+
+static void luma_body(const frames *f) {
+    ik_bgra_to_luma(f->bgra, frame_width * 4, f->out_a, frame_width, frame_width, frame_height);
+}
+
+static void downscale_bgra_body(const frames *f) {
+    ik_downscale_box(f->bgra, frame_width * 4, frame_width, frame_height, 4,
+                     f->out_a, thumb_width * 4, thumb_width, thumb_height);
+}
+
+static void downscale_nv12_body(const frames *f) {
+    ik_downscale_nv12(f->y, frame_width, f->uv, frame_width, frame_width, frame_height,
+                      f->out_a, thumb_width, f->out_b, thumb_width, thumb_width, thumb_height);
+}
+
+static void downscale_i420_body(const frames *f) {
+    ik_downscale_i420(f->y, frame_width, f->u, frame_width / 2, f->v, frame_width / 2,
+                      frame_width, frame_height,
+                      f->out_a, thumb_width, f->out_b, thumb_width / 2, f->out_c, thumb_width / 2,
+                      thumb_width, thumb_height);
+}
+
+static void laplacian_body(const frames *f) {
+    sink += (uint64_t)ik_laplacian_variance(f->luma, frame_width, frame_width, frame_height);
+}
+
+static void dhash_body(const frames *f) {
+    sink += ik_dhash(f->luma, frame_width, frame_width, frame_height);
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    if (iterations <= 0) {
+        iterations = 50;
+    }
+
+    frames f = {
+        .bgra = synthetic_plane(frame_width * 4, frame_height, 1),
+        .luma = synthetic_plane(frame_width, frame_height, 2),
+        .y = synthetic_plane(frame_width, frame_height, 3),
+        .uv = synthetic_plane(frame_width, frame_height / 2, 4),
+        .u = synthetic_plane(frame_width / 2, frame_height / 2, 5),
+        .v = synthetic_plane(frame_width / 2, frame_height / 2, 6),
+        .out_a = malloc(frame_width * frame_height * 4),
+        .out_b = malloc(frame_width * frame_height),
+        .out_c = malloc(frame_width * frame_height),
+    };
+    const size_t pixels = (size_t)frame_width * frame_height;
+
+    printf("%dx%d frames, %d iterations, best ISA %s\n",
+           frame_width, frame_height, iterations, ik_isa_name(ik_best_isa()));
+    for (int isa = 0; isa < IK_ISA_COUNT; isa++) {
+        if (ik_set_isa((ik_isa)isa) != 0) {
+            continue;
+        }
+        printf("%s\n", ik_isa_name((ik_isa)isa));
+        run("bgra_to_luma", iterations, pixels, &f, luma_body);
+        run("downscale_bgra 1/4", iterations, pixels, &f, downscale_bgra_body);
+        run("downscale_nv12 1/4", iterations, pixels, &f, downscale_nv12_body);
+        run("downscale_i420 1/4", iterations, pixels, &f, downscale_i420_body);
+        run("laplacian_variance", iterations, pixels, &f, laplacian_body);
+        run("dhash", iterations, pixels, &f, dhash_body);
+    }
+
+    free((void *)f.bgra);
+    free((void *)f.luma);
+    free((void *)f.y);
+    free((void *)f.uv);
+    free((void *)f.u);
+    free((void *)f.v);
+    free(f.out_a);
+    free(f.out_b);
+    free(f.out_c);
+    return 0;
+}
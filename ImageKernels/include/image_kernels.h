@@ -0,0 +1,106 @@
+//
+//  image_kernels.h
+//  ImageKernels
+//
+//  Portable 8-bit image kernels for the frame pipeline: box downscale of
+//  BGRA, NV12 and I420 frames, BGRA to luma, a Laplacian sharpness metric
+//  and a 64-bit difference hash. Every kernel has a scalar reference and
+//  SSE2/AVX2 (x86-64) or NEON (arm64) paths that produce bit-identical
+//  results; the best path for the running CPU is picked on first use.
+//
+
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Instruction set a kernel implementation targets.
+typedef enum {
+    IK_ISA_SCALAR = 0,
+    IK_ISA_SSE2,
+    IK_ISA_AVX2,
+    IK_ISA_NEON,
+    IK_ISA_COUNT
+} ik_isa;
+
+/// Whether this build and CPU can run `isa`.
+int ik_isa_supported(ik_isa isa);
+
+/// Fastest supported instruction set.
+ik_isa ik_best_isa(void);
+
+/// Instruction set the kernels currently use (the best one unless overridden).
+ik_isa ik_active_isa(void);
+
+/// Force an instruction set, e.g. the scalar reference for comparisons.
+/// Returns 0, or -1 if `isa` is not supported. Safe to call while kernels
+/// run on other threads; calls already running finish on the previous set.
+int ik_set_isa(ik_isa isa);
+
+const char *ik_isa_name(ik_isa isa);
+
+// MARK: - Conversion
+
+/// Luma of each BGRA pixel: (38 R + 75 G + 15 B + 64) >> 7, BT.601 weights
+/// in 7-bit fixed point.
+void ik_bgra_to_luma(const uint8_t *bgra, size_t bgra_stride,
+                     uint8_t *luma, size_t luma_stride,
+                     size_t width, size_t height);
+
+// MARK: - Downscale
+
+/// Box-filter downscale of an interleaved 8-bit image with 1, 2 (NV12 CbCr)
+/// or 4 (BGRA) channels. Output pixel (x, y) is the rounded mean of the source
+/// pixels in [x * W / w, (x + 1) * W / w) × [y * H / h, (y + 1) * H / h).
+/// Returns 0, or -1 for unsupported channels, an upscale or a failed allocation.
+int ik_downscale_box(const uint8_t *src, size_t src_stride,
+                     size_t src_width, size_t src_height, size_t channels,
+                     uint8_t *dst, size_t dst_stride,
+                     size_t dst_width, size_t dst_height);
+
+/// Downscale an NV12 frame (full-size Y plane, half-size interleaved CbCr plane).
+/// All widths and heights must be even. Returns 0 or -1.
+int ik_downscale_nv12(const uint8_t *y, size_t y_stride,
+                      const uint8_t *uv, size_t uv_stride,
+                      size_t width, size_t height,
+                      uint8_t *dst_y, size_t dst_y_stride,
+                      uint8_t *dst_uv, size_t dst_uv_stride,
+                      size_t dst_width, size_t dst_height);
+
+/// Downscale an I420 frame (full-size Y, half-size U and V planes), e.g. the
+/// yBuffer/uBuffer/vBuffer of a Zoom raw video frame. Dimensions must be even.
+/// Returns 0 or -1.
+int ik_downscale_i420(const uint8_t *y, size_t y_stride,
+                      const uint8_t *u, size_t u_stride,
+                      const uint8_t *v, size_t v_stride,
+                      size_t width, size_t height,
+                      uint8_t *dst_y, size_t dst_y_stride,
+                      uint8_t *dst_u, size_t dst_u_stride,
+                      uint8_t *dst_v, size_t dst_v_stride,
+                      size_t dst_width, size_t dst_height);
+
+// MARK: - Metrics
+
+/// Variance of the 4-neighbour Laplacian over interior pixels of a luma plane.
+/// Higher is sharper; motion blur and defocus drive it toward 0.
+/// Returns 0 for planes smaller than 3×3.
+double ik_laplacian_variance(const uint8_t *luma, size_t stride, size_t width, size_t height);
+
+/// Difference hash of a luma plane: a 9×8 box thumbnail, where bit
+/// `row * 8 + column` is set when cell (row, column) is brighter than
+/// (row, column + 1). Returns 0 for planes smaller than 9×8 or on allocation failure.
+uint64_t ik_dhash(const uint8_t *luma, size_t stride, size_t width, size_t height);
+
+/// Number of differing bits between two hashes.
+int ik_hamming_distance(uint64_t a, uint64_t b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
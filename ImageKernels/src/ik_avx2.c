@@ -0,0 +1,108 @@
+//
+//  ik_avx2.c
+//  ImageKernels
+//
+//  AVX2 kernels. Built with -mavx2 and only called after a runtime check.
+//
+
+#include "ik_internal.h"
+
+#if defined(IK_HAVE_AVX2) && defined(__AVX2__)
+
+#include <immintrin.h>
+
+/// Luma of 8 BGRA pixels as 32-bit lanes; see the SSE2 version.
+static inline __m256i luma8(__m256i pixels) {
+    const __m256i mask = _mm256_set1_epi32(0x00FF00FF);
+    const __m256i weights_br = _mm256_set1_epi32(15 | (38 << 16));
+    const __m256i weights_ga = _mm256_set1_epi32(75);
+    __m256i br = _mm256_and_si256(pixels, mask);
+    __m256i ga = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), mask);
+    __m256i y = _mm256_add_epi32(_mm256_madd_epi16(br, weights_br), _mm256_madd_epi16(ga, weights_ga));
+    return _mm256_srli_epi32(_mm256_add_epi32(y, _mm256_set1_epi32(64)), 7);
+}
+
+static void bgra_to_luma_row(const uint8_t *bgra, uint8_t *luma, size_t width) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i a = luma8(_mm256_loadu_si256((const __m256i *)(bgra + x * 4)));
+        __m256i b = luma8(_mm256_loadu_si256((const __m256i *)(bgra + x * 4 + 32)));
+        // Packing works per 128-bit lane; restore pixel order before narrowing again.
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+        _mm_storeu_si128((__m128i *)(luma + x), bytes);
+    }
+    ik_scalar_bgra_to_luma_row(bgra + x * 4, luma + x, width - x);
+}
+
+static inline void add_widened(uint32_t *acc, __m128i eight_bytes) {
+    __m256i *out = (__m256i *)acc;
+    _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), _mm256_cvtepu8_epi32(eight_bytes)));
+}
+
+static void accumulate_row(const uint8_t *row, uint32_t *acc, size_t count) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(row + i + 16));
+        add_widened(acc + i, lo);
+        add_widened(acc + i + 8, _mm_srli_si128(lo, 8));
+        add_widened(acc + i + 16, hi);
+        add_widened(acc + i + 24, _mm_srli_si128(hi, 8));
+    }
+    ik_scalar_accumulate_row(row + i, acc + i, count - i);
+}
+
+static inline __m256i load16_epi16(const uint8_t *p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+static void flush(__m256i *sum, __m256i *squares, int64_t *total, uint64_t *total_squares) {
+    int32_t s[8], q[8];
+    _mm256_storeu_si256((__m256i *)s, *sum);
+    _mm256_storeu_si256((__m256i *)q, *squares);
+    for (int i = 0; i < 8; i++) {
+        *total += s[i];
+        *total_squares += (uint32_t)q[i];
+    }
+    *sum = _mm256_setzero_si256();
+    *squares = _mm256_setzero_si256();
+}
+
+static void laplacian_row(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                          size_t width, int64_t *total, uint64_t *total_squares) {
+    if (width < 3) {
+        return;
+    }
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    __m256i squares = _mm256_setzero_si256();
+    int steps = 0;
+    size_t x = 1;
+    for (; x + 17 <= width; x += 16) {
+        __m256i center = _mm256_slli_epi16(load16_epi16(row + x), 2);
+        __m256i neighbours = _mm256_add_epi16(_mm256_add_epi16(load16_epi16(row + x - 1), load16_epi16(row + x + 1)),
+                                              _mm256_add_epi16(load16_epi16(above + x), load16_epi16(below + x)));
+        __m256i l = _mm256_sub_epi16(center, neighbours);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(l, ones));
+        squares = _mm256_add_epi32(squares, _mm256_madd_epi16(l, l));
+        if (++steps == 512) {
+            flush(&sum, &squares, total, total_squares);
+            steps = 0;
+        }
+    }
+    flush(&sum, &squares, total, total_squares);
+    ik_scalar_laplacian_span(above, row, below, x, width - 1, total, total_squares);
+}
+
+const ik_kernels ik_kernels_avx2 = {
+    bgra_to_luma_row,
+    accumulate_row,
+    laplacian_row,
+};
+
+#else
+
+typedef int ik_avx2_unavailable;
+
+#endif
@@ -0,0 +1,275 @@
+//
+//  ik_dispatch.c
+//  ImageKernels
+//
+//  Public entry points. Plane-level loops live here once; the per-ISA
+//  tables only supply row kernels, so every path shares the same edge
+//  handling and rounding.
+//
+
+#include "image_kernels.h"
+#include "ik_internal.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Selected instruction set, or -1 until the first kernel call picks the best.
+static atomic_int active = -1;
+
+static const ik_kernels *kernels_for(ik_isa isa) {
+    switch (isa) {
+    case IK_ISA_SCALAR:
+        return &ik_kernels_scalar;
+#if defined(IK_HAVE_SSE2)
+    case IK_ISA_SSE2:
+        return &ik_kernels_sse2;
+#endif
+#if defined(IK_HAVE_AVX2)
+    case IK_ISA_AVX2:
+        return __builtin_cpu_supports("avx2") ? &ik_kernels_avx2 : NULL;
+#endif
+#if defined(IK_HAVE_NEON)
+    case IK_ISA_NEON:
+        return &ik_kernels_neon;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+int ik_isa_supported(ik_isa isa) {
+    return kernels_for(isa) != NULL;
+}
+
+ik_isa ik_best_isa(void) {
+    static const ik_isa preference[] = { IK_ISA_AVX2, IK_ISA_NEON, IK_ISA_SSE2 };
+    for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+        if (ik_isa_supported(preference[i])) {
+            return preference[i];
+        }
+    }
+    return IK_ISA_SCALAR;
+}
+
+ik_isa ik_active_isa(void) {
+    int isa = atomic_load_explicit(&active, memory_order_relaxed);
+    if (isa < 0) {
+        // Racing first calls agree on the best set; whichever stores first
+        // wins, and a concurrent ik_set_isa is never overwritten.
+        int unset = -1;
+        isa = ik_best_isa();
+        if (!atomic_compare_exchange_strong(&active, &unset, isa)) {
+            isa = unset;
+        }
+    }
+    return (ik_isa)isa;
+}
+
+/// The selected table. Each plane-level call reads it once, so a kernel
+/// running during ik_set_isa finishes on the set it started with.
+static const ik_kernels *kernels(void) {
+    return kernels_for(ik_active_isa());
+}
+
+int ik_set_isa(ik_isa isa) {
+    if (kernels_for(isa) == NULL) {
+        return -1;
+    }
+    atomic_store_explicit(&active, (int)isa, memory_order_relaxed);
+    return 0;
+}
+
+const char *ik_isa_name(ik_isa isa) {
+    switch (isa) {
+    case IK_ISA_SCALAR: return "scalar";
+    case IK_ISA_SSE2: return "sse2";
+    case IK_ISA_AVX2: return "avx2";
+    case IK_ISA_NEON: return "neon";
+    default: return "unknown";
+    }
+}
+
+// MARK: - Conversion
+
+void ik_bgra_to_luma(const uint8_t *bgra, size_t bgra_stride,
+                     uint8_t *luma, size_t luma_stride,
+                     size_t width, size_t height) {
+    const ik_kernels *k = kernels();
+    for (size_t y = 0; y < height; y++) {
+        k->bgra_to_luma_row(bgra + y * bgra_stride, luma + y * luma_stride, width);
+    }
+}
+
+// MARK: - Downscale
+
+/// Boxes up to this many source pixels divide by multiplying with a 32-bit
+/// reciprocal, which is exact while sum × count < 2^32 (sum ≤ 256 × count).
+#define IK_RECIPROCAL_MAX_COUNT 4096
+
+/// Rounded means of `channels`-interleaved column sums over each output pixel's
+/// columns. `x0` holds each output column's first source column, plus the end.
+/// Inlined per channel count so the inner loops unroll.
+static inline void box_row(const uint32_t *columns, const size_t *x0, size_t narrow, size_t rows,
+                           size_t channels, uint8_t *out, size_t dst_width) {
+    // Output columns are `narrow` or `narrow + 1` wide, so there are two divisors per row.
+    const uint64_t counts[2] = { (uint64_t)narrow * rows, (uint64_t)(narrow + 1) * rows };
+    const int fast = counts[1] < IK_RECIPROCAL_MAX_COUNT;
+    const uint64_t reciprocals[2] = {
+        fast ? (((uint64_t)1 << 32) + counts[0] - 1) / counts[0] : 0,
+        fast ? (((uint64_t)1 << 32) + counts[1] - 1) / counts[1] : 0,
+    };
+
+    for (size_t x = 0; x < dst_width; x++) {
+        const size_t wide = x0[x + 1] - x0[x] > narrow;
+        const uint64_t count = counts[wide];
+        for (size_t c = 0; c < channels; c++) {
+            uint64_t sum = count / 2;
+            for (size_t sx = x0[x]; sx < x0[x + 1]; sx++) {
+                sum += columns[sx * channels + c];
+            }
+            out[x * channels + c] = (uint8_t)(fast ? (sum * reciprocals[wide]) >> 32 : sum / count);
+        }
+    }
+}
+
+int ik_downscale_box(const uint8_t *src, size_t src_stride,
+                     size_t src_width, size_t src_height, size_t channels,
+                     uint8_t *dst, size_t dst_stride,
+                     size_t dst_width, size_t dst_height) {
+    if (channels != 1 && channels != 2 && channels != 4) {
+        return -1;
+    }
+    if (dst_width > src_width || dst_height > src_height) {
+        return -1;
+    }
+    if (dst_width == 0 || dst_height == 0) {
+        return 0;
+    }
+
+    // Column sums of the source rows each output row covers (vector), then
+    // sums across each output pixel's columns (scalar, a handful per pixel).
+    const size_t row_length = src_width * channels;
+    const size_t padded_length = (row_length + 1) & ~(size_t)1;
+    uint32_t *columns = malloc(padded_length * sizeof(uint32_t) + (dst_width + 1) * sizeof(size_t));
+    if (columns == NULL) {
+        return -1;
+    }
+    size_t *x0 = (size_t *)(columns + padded_length);
+    for (size_t x = 0; x <= dst_width; x++) {
+        x0[x] = x * src_width / dst_width;
+    }
+    const ik_kernels *k = kernels();
+
+    for (size_t y = 0; y < dst_height; y++) {
+        const size_t y0 = y * src_height / dst_height;
+        const size_t y1 = (y + 1) * src_height / dst_height;
+        memset(columns, 0, row_length * sizeof(uint32_t));
+        for (size_t sy = y0; sy < y1; sy++) {
+            k->accumulate_row(src + sy * src_stride, columns, row_length);
+        }
+        const size_t rows = y1 - y0;
+        const size_t narrow = src_width / dst_width;
+
+        uint8_t *out = dst + y * dst_stride;
+        switch (channels) {
+        case 1:
+            box_row(columns, x0, narrow, rows, 1, out, dst_width);
+            break;
+        case 2:
+            box_row(columns, x0, narrow, rows, 2, out, dst_width);
+            break;
+        default:
+            box_row(columns, x0, narrow, rows, 4, out, dst_width);
+            break;
+        }
+    }
+
+    free(columns);
+    return 0;
+}
+
+static int is_even(size_t value) {
+    return (value & 1) == 0;
+}
+
+int ik_downscale_nv12(const uint8_t *y, size_t y_stride,
+                      const uint8_t *uv, size_t uv_stride,
+                      size_t width, size_t height,
+                      uint8_t *dst_y, size_t dst_y_stride,
+                      uint8_t *dst_uv, size_t dst_uv_stride,
+                      size_t dst_width, size_t dst_height) {
+    if (!is_even(width) || !is_even(height) || !is_even(dst_width) || !is_even(dst_height)) {
+        return -1;
+    }
+    if (ik_downscale_box(y, y_stride, width, height, 1,
+                         dst_y, dst_y_stride, dst_width, dst_height) != 0) {
+        return -1;
+    }
+    return ik_downscale_box(uv, uv_stride, width / 2, height / 2, 2,
+                            dst_uv, dst_uv_stride, dst_width / 2, dst_height / 2);
+}
+
+int ik_downscale_i420(const uint8_t *y, size_t y_stride,
+                      const uint8_t *u, size_t u_stride,
+                      const uint8_t *v, size_t v_stride,
+                      size_t width, size_t height,
+                      uint8_t *dst_y, size_t dst_y_stride,
+                      uint8_t *dst_u, size_t dst_u_stride,
+                      uint8_t *dst_v, size_t dst_v_stride,
+                      size_t dst_width, size_t dst_height) {
+    if (!is_even(width) || !is_even(height) || !is_even(dst_width) || !is_even(dst_height)) {
+        return -1;
+    }
+    if (ik_downscale_box(y, y_stride, width, height, 1,
+                         dst_y, dst_y_stride, dst_width, dst_height) != 0) {
+        return -1;
+    }
+    if (ik_downscale_box(u, u_stride, width / 2, height / 2, 1,
+                         dst_u, dst_u_stride, dst_width / 2, dst_height / 2) != 0) {
+        return -1;
+    }
+    return ik_downscale_box(v, v_stride, width / 2, height / 2, 1,
+                            dst_v, dst_v_stride, dst_width / 2, dst_height / 2);
+}
+
+// MARK: - Metrics
+
+double ik_laplacian_variance(const uint8_t *luma, size_t stride, size_t width, size_t height) {
+    if (width < 3 || height < 3) {
+        return 0;
+    }
+    const ik_kernels *k = kernels();
+    // Exact integer sums, so every instruction set gives the same double.
+    int64_t sum = 0;
+    uint64_t sum_squares = 0;
+    for (size_t y = 1; y + 1 < height; y++) {
+        const uint8_t *row = luma + y * stride;
+        k->laplacian_row(row - stride, row, row + stride, width, &sum, &sum_squares);
+    }
+    const double n = (double)(width - 2) * (double)(height - 2);
+    const double mean = (double)sum / n;
+    return (double)sum_squares / n - mean * mean;
+}
+
+uint64_t ik_dhash(const uint8_t *luma, size_t stride, size_t width, size_t height) {
+    enum { columns = 9, rows = 8 };
+    uint8_t cells[columns * rows];
+    if (ik_downscale_box(luma, stride, width, height, 1, cells, columns, columns, rows) != 0) {
+        return 0;
+    }
+    uint64_t hash = 0;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns - 1; column++) {
+            const uint8_t *cell = cells + row * columns + column;
+            if (cell[0] > cell[1]) {
+                hash |= (uint64_t)1 << (row * 8 + column);
+            }
+        }
+    }
+    return hash;
+}
+
+int ik_hamming_distance(uint64_t a, uint64_t b) {
+    return __builtin_popcountll(a ^ b);
+}
@@ -0,0 +1,51 @@
+//
+//  ik_internal.h
+//  ImageKernels
+//
+//  Row kernels each instruction set implements. Vector paths handle the
+//  bulk of a row and finish its tail with the scalar versions, so every
+//  path produces the same bytes and sums as the reference.
+//
+
+#ifndef IK_INTERNAL_H
+#define IK_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    /// luma[i] = (38 R + 75 G + 15 B + 64) >> 7 for `width` BGRA pixels.
+    void (*bgra_to_luma_row)(const uint8_t *bgra, uint8_t *luma, size_t width);
+    /// acc[i] += row[i] for `count` bytes.
+    void (*accumulate_row)(const uint8_t *row, uint32_t *acc, size_t count);
+    /// Add the Laplacian 4 c - l - r - u - d of columns [1, width - 1) of `row`
+    /// to `sum`, and its square to `sum_squares`.
+    void (*laplacian_row)(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                          size_t width, int64_t *sum, uint64_t *sum_squares);
+} ik_kernels;
+
+extern const ik_kernels ik_kernels_scalar;
+
+#if defined(__SSE2__)
+#define IK_HAVE_SSE2 1
+extern const ik_kernels ik_kernels_sse2;
+#endif
+
+#if defined(IK_HAVE_AVX2)
+extern const ik_kernels ik_kernels_avx2;
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define IK_HAVE_NEON 1
+extern const ik_kernels ik_kernels_neon;
+#endif
+
+// Scalar row kernels over a sub-range, used for vector tails.
+
+void ik_scalar_bgra_to_luma_row(const uint8_t *bgra, uint8_t *luma, size_t width);
+void ik_scalar_accumulate_row(const uint8_t *row, uint32_t *acc, size_t count);
+/// Laplacian over columns [first, end) of a row, each needing neighbours at ±1.
+void ik_scalar_laplacian_span(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                              size_t first, size_t end, int64_t *sum, uint64_t *sum_squares);
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  ik_neon.c
+//  ImageKernels
+//
+//  NEON kernels for arm64 (iPhone, Apple silicon, Linux arm64).
+//
+
+#include "ik_internal.h"
+
+#if defined(IK_HAVE_NEON)
+
+#include <arm_neon.h>
+
+static void bgra_to_luma_row(const uint8_t *bgra, uint8_t *luma, size_t width) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t p = vld4q_u8(bgra + x * 4);  // p.val[0] = B, [1] = G, [2] = R
+        uint16x8_t lo = vmull_u8(vget_low_u8(p.val[2]), vdup_n_u8(38));
+        lo = vmlal_u8(lo, vget_low_u8(p.val[1]), vdup_n_u8(75));
+        lo = vmlal_u8(lo, vget_low_u8(p.val[0]), vdup_n_u8(15));
+        uint16x8_t hi = vmull_u8(vget_high_u8(p.val[2]), vdup_n_u8(38));
+        hi = vmlal_u8(hi, vget_high_u8(p.val[1]), vdup_n_u8(75));
+        hi = vmlal_u8(hi, vget_high_u8(p.val[0]), vdup_n_u8(15));
+        // Rounding narrow: (v + 64) >> 7.
+        vst1q_u8(luma + x, vcombine_u8(vrshrn_n_u16(lo, 7), vrshrn_n_u16(hi, 7)));
+    }
+    ik_scalar_bgra_to_luma_row(bgra + x * 4, luma + x, width - x);
+}
+
+static void accumulate_row(const uint8_t *row, uint32_t *acc, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t bytes = vld1q_u8(row + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+        vst1q_u32(acc + i, vaddw_u16(vld1q_u32(acc + i), vget_low_u16(lo)));
+        vst1q_u32(acc + i + 4, vaddw_u16(vld1q_u32(acc + i + 4), vget_high_u16(lo)));
+        vst1q_u32(acc + i + 8, vaddw_u16(vld1q_u32(acc + i + 8), vget_low_u16(hi)));
+        vst1q_u32(acc + i + 12, vaddw_u16(vld1q_u32(acc + i + 12), vget_high_u16(hi)));
+    }
+    ik_scalar_accumulate_row(row + i, acc + i, count - i);
+}
+
+static inline int16x8_t load8_s16(const uint8_t *p) {
+    return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p)));
+}
+
+static void laplacian_row(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                          size_t width, int64_t *total, uint64_t *total_squares) {
+    if (width < 3) {
+        return;
+    }
+    int32x4_t sum = vdupq_n_s32(0);
+    uint32x4_t squares = vdupq_n_u32(0);
+    // Each 32-bit lane gains at most 2 × 1020² per step; flush well before overflow.
+    int steps = 0;
+    size_t x = 1;
+    for (; x + 9 <= width; x += 8) {
+        int16x8_t center = vshlq_n_s16(load8_s16(row + x), 2);
+        int16x8_t neighbours = vaddq_s16(vaddq_s16(load8_s16(row + x - 1), load8_s16(row + x + 1)),
+                                         vaddq_s16(load8_s16(above + x), load8_s16(below + x)));
+        int16x8_t l = vsubq_s16(center, neighbours);
+        sum = vpadalq_s16(sum, l);
+        int32x4_t sq = vmull_s16(vget_low_s16(l), vget_low_s16(l));
+        sq = vmlal_s16(sq, vget_high_s16(l), vget_high_s16(l));
+        squares = vaddq_u32(squares, vreinterpretq_u32_s32(sq));
+        if (++steps == 512) {
+            *total += vaddlvq_s32(sum);
+            *total_squares += vaddlvq_u32(squares);
+            sum = vdupq_n_s32(0);
+            squares = vdupq_n_u32(0);
+            steps = 0;
+        }
+    }
+    *total += vaddlvq_s32(sum);
+    *total_squares += vaddlvq_u32(squares);
+    ik_scalar_laplacian_span(above, row, below, x, width - 1, total, total_squares);
+}
+
+const ik_kernels ik_kernels_neon = {
+    bgra_to_luma_row,
+    accumulate_row,
+    laplacian_row,
+};
+
+#else
+
+typedef int ik_neon_unavailable;
+
+#endif
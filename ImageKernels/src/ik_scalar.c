@@ -0,0 +1,48 @@
+//
+//  ik_scalar.c
+//  ImageKernels
+//
+//  Scalar reference kernels. Vector paths must match these exactly.
+//
+
+#include "ik_internal.h"
+
+void ik_scalar_bgra_to_luma_row(const uint8_t *bgra, uint8_t *luma, size_t width) {
+    for (size_t x = 0; x < width; x++) {
+        const uint8_t *p = bgra + x * 4;
+        luma[x] = (uint8_t)((38u * p[2] + 75u * p[1] + 15u * p[0] + 64u) >> 7);
+    }
+}
+
+void ik_scalar_accumulate_row(const uint8_t *row, uint32_t *acc, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        acc[i] += row[i];
+    }
+}
+
+void ik_scalar_laplacian_span(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                              size_t first, size_t end, int64_t *sum, uint64_t *sum_squares) {
+    int64_t s = 0;
+    uint64_t ss = 0;
+    for (size_t x = first; x < end; x++) {
+        int32_t l = 4 * (int32_t)row[x] - row[x - 1] - row[x + 1] - above[x] - below[x];
+        s += l;
+        ss += (uint64_t)((int64_t)l * l);
+    }
+    *sum += s;
+    *sum_squares += ss;
+}
+
+static void laplacian_row(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                          size_t width, int64_t *sum, uint64_t *sum_squares) {
+    if (width < 3) {
+        return;
+    }
+    ik_scalar_laplacian_span(above, row, below, 1, width - 1, sum, sum_squares);
+}
+
+const ik_kernels ik_kernels_scalar = {
+    ik_scalar_bgra_to_luma_row,
+    ik_scalar_accumulate_row,
+    laplacian_row,
+};
@@ -0,0 +1,106 @@
+//
+//  ik_sse2.c
+//  ImageKernels
+//
+//  SSE2 kernels, the x86-64 baseline.
+//
+
+#include "ik_internal.h"
+
+#if defined(IK_HAVE_SSE2)
+
+#include <emmintrin.h>
+
+/// Luma of 4 BGRA pixels as 32-bit lanes. Masking splits each pixel into
+/// 16-bit (B, R) and (G, A) pairs, so one multiply-add per pair applies the weights.
+static inline __m128i luma4(__m128i pixels) {
+    const __m128i mask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i weights_br = _mm_set1_epi32(15 | (38 << 16));
+    const __m128i weights_ga = _mm_set1_epi32(75);
+    __m128i br = _mm_and_si128(pixels, mask);
+    __m128i ga = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+    __m128i y = _mm_add_epi32(_mm_madd_epi16(br, weights_br), _mm_madd_epi16(ga, weights_ga));
+    return _mm_srli_epi32(_mm_add_epi32(y, _mm_set1_epi32(64)), 7);
+}
+
+static void bgra_to_luma_row(const uint8_t *bgra, uint8_t *luma, size_t width) {
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i a = luma4(_mm_loadu_si128((const __m128i *)(bgra + x * 4)));
+        __m128i b = luma4(_mm_loadu_si128((const __m128i *)(bgra + x * 4 + 16)));
+        __m128i words = _mm_packs_epi32(a, b);
+        _mm_storel_epi64((__m128i *)(luma + x), _mm_packus_epi16(words, words));
+    }
+    ik_scalar_bgra_to_luma_row(bgra + x * 4, luma + x, width - x);
+}
+
+static void accumulate_row(const uint8_t *row, uint32_t *acc, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        __m128i *out = (__m128i *)(acc + i);
+        _mm_storeu_si128(out + 0, _mm_add_epi32(_mm_loadu_si128(out + 0), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(out + 2, _mm_add_epi32(_mm_loadu_si128(out + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(out + 3, _mm_add_epi32(_mm_loadu_si128(out + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+    ik_scalar_accumulate_row(row + i, acc + i, count - i);
+}
+
+static inline __m128i load8_epi16(const uint8_t *p) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p), _mm_setzero_si128());
+}
+
+static void flush(__m128i *sum, __m128i *squares, int64_t *total, uint64_t *total_squares) {
+    int32_t s[4], q[4];
+    _mm_storeu_si128((__m128i *)s, *sum);
+    _mm_storeu_si128((__m128i *)q, *squares);
+    for (int i = 0; i < 4; i++) {
+        *total += s[i];
+        *total_squares += (uint32_t)q[i];
+    }
+    *sum = _mm_setzero_si128();
+    *squares = _mm_setzero_si128();
+}
+
+static void laplacian_row(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                          size_t width, int64_t *total, uint64_t *total_squares) {
+    if (width < 3) {
+        return;
+    }
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    __m128i squares = _mm_setzero_si128();
+    // Each 32-bit lane gains at most 2 × 1020² per step; flush well before overflow.
+    int steps = 0;
+    size_t x = 1;
+    for (; x + 9 <= width; x += 8) {
+        __m128i center = _mm_slli_epi16(load8_epi16(row + x), 2);
+        __m128i neighbours = _mm_add_epi16(_mm_add_epi16(load8_epi16(row + x - 1), load8_epi16(row + x + 1)),
+                                           _mm_add_epi16(load8_epi16(above + x), load8_epi16(below + x)));
+        __m128i l = _mm_sub_epi16(center, neighbours);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(l, ones));
+        squares = _mm_add_epi32(squares, _mm_madd_epi16(l, l));
+        if (++steps == 512) {
+            flush(&sum, &squares, total, total_squares);
+            steps = 0;
+        }
+    }
+    flush(&sum, &squares, total, total_squares);
+    ik_scalar_laplacian_span(above, row, below, x, width - 1, total, total_squares);
+}
+
+const ik_kernels ik_kernels_sse2 = {
+    bgra_to_luma_row,
+    accumulate_row,
+    laplacian_row,
+};
+
+#else
+
+typedef int ik_sse2_unavailable;
+
+#endif
@@ -0,0 +1,283 @@
+//
+//  test_image_kernels.c
+//  ImageKernels
+//
+//  Every supported instruction set must match the scalar reference bit for
+//  bit, on odd sizes and padded strides that exercise the vector tails.
+//
+
+#include "image_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures;
+
+#define EXPECT(condition, ...)                                  \
+    do {                                                        \
+        if (!(condition)) {                                     \
+            failures++;                                         \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);     \
+            fprintf(stderr, __VA_ARGS__);                       \
+            fputc('\n', stderr);                                \
+        }                                                       \
+    } while (0)
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint8_t random_byte(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (uint8_t)(rng_state >> 24);
+}
+
+static uint8_t *random_plane(size_t stride, size_t height) {
+    uint8_t *plane = malloc(stride * height);
+    for (size_t i = 0; i < stride * height; i++) {
+        plane[i] = random_byte();
+    }
+    return plane;
+}
+
+/// Rows of `a` and `b` match over the first `row_bytes` of each.
+static int planes_equal(const uint8_t *a, const uint8_t *b, size_t stride, size_t row_bytes, size_t height) {
+    for (size_t y = 0; y < height; y++) {
+        if (memcmp(a + y * stride, b + y * stride, row_bytes) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// MARK: - Cross-ISA agreement
+
+typedef struct {
+    size_t width;
+    size_t height;
+} size2;
+
+static const size2 source_sizes[] = {
+    { 1, 1 }, { 3, 3 }, { 9, 8 }, { 17, 5 }, { 33, 31 }, { 67, 45 }, { 130, 97 }, { 641, 359 },
+};
+
+static void check_isa(ik_isa isa) {
+    const size_t count = sizeof(source_sizes) / sizeof(source_sizes[0]);
+    for (size_t s = 0; s < count; s++) {
+        const size_t width = source_sizes[s].width;
+        const size_t height = source_sizes[s].height;
+        const size_t stride = width * 4 + 13;
+        uint8_t *bgra = random_plane(stride, height);
+
+        // Luma
+        const size_t luma_stride = width + 7;
+        uint8_t *expected = calloc(luma_stride * height, 1);
+        uint8_t *actual = calloc(luma_stride * height, 1);
+        ik_set_isa(IK_ISA_SCALAR);
+        ik_bgra_to_luma(bgra, stride, expected, luma_stride, width, height);
+        ik_set_isa(isa);
+        ik_bgra_to_luma(bgra, stride, actual, luma_stride, width, height);
+        EXPECT(planes_equal(expected, actual, luma_stride, width, height),
+               "%s luma differs at %zux%zu", ik_isa_name(isa), width, height);
+
+        // Sharpness and hash of that luma plane
+        ik_set_isa(IK_ISA_SCALAR);
+        double variance = ik_laplacian_variance(expected, luma_stride, width, height);
+        uint64_t hash = ik_dhash(expected, luma_stride, width, height);
+        ik_set_isa(isa);
+        EXPECT(variance == ik_laplacian_variance(expected, luma_stride, width, height),
+               "%s Laplacian variance differs at %zux%zu", ik_isa_name(isa), width, height);
+        EXPECT(hash == ik_dhash(expected, luma_stride, width, height),
+               "%s dHash differs at %zux%zu", ik_isa_name(isa), width, height);
+
+        // Box downscale of every channel layout to a few output sizes
+        static const size_t channel_counts[] = { 1, 2, 4 };
+        static const size_t divisors[] = { 1, 2, 3, 7 };
+        for (size_t c = 0; c < 3; c++) {
+            const size_t channels = channel_counts[c];
+            const size_t src_width = stride / channels > width ? width : stride / channels;
+            for (size_t d = 0; d < 4; d++) {
+                const size_t dst_width = (src_width + divisors[d] - 1) / divisors[d];
+                const size_t dst_height = (height + divisors[d] - 1) / divisors[d];
+                const size_t dst_stride = dst_width * channels + 3;
+                uint8_t *scaled_expected = calloc(dst_stride * dst_height, 1);
+                uint8_t *scaled_actual = calloc(dst_stride * dst_height, 1);
+                ik_set_isa(IK_ISA_SCALAR);
+                int expected_status = ik_downscale_box(bgra, stride, src_width, height, channels,
+                                                       scaled_expected, dst_stride, dst_width, dst_height);
+                ik_set_isa(isa);
+                int actual_status = ik_downscale_box(bgra, stride, src_width, height, channels,
+                                                     scaled_actual, dst_stride, dst_width, dst_height);
+                EXPECT(expected_status == 0 && actual_status == 0, "downscale failed");
+                EXPECT(planes_equal(scaled_expected, scaled_actual, dst_stride, dst_width * channels, dst_height),
+                       "%s %zu-channel downscale differs at %zux%zu -> %zux%zu", ik_isa_name(isa),
+                       channels, src_width, height, dst_width, dst_height);
+                free(scaled_expected);
+                free(scaled_actual);
+            }
+        }
+
+        free(expected);
+        free(actual);
+        free(bgra);
+    }
+}
+
+// MARK: - Known answers
+
+static void test_luma_weights(void) {
+    const uint8_t pixels[] = {
+        0, 0, 0, 255,        // black
+        255, 255, 255, 255,  // white
+        0, 0, 255, 255,      // red
+        0, 255, 0, 255,      // green
+        255, 0, 0, 255,      // blue
+    };
+    uint8_t luma[5];
+    ik_bgra_to_luma(pixels, sizeof(pixels), luma, sizeof(luma), 5, 1);
+    EXPECT(luma[0] == 0, "black -> %u", luma[0]);
+    EXPECT(luma[1] == 255, "white -> %u", luma[1]);
+    EXPECT(luma[2] == 76, "red -> %u", luma[2]);
+    EXPECT(luma[3] == 149, "green -> %u", luma[3]);
+    EXPECT(luma[4] == 30, "blue -> %u", luma[4]);
+}
+
+static void test_downscale(void) {
+    // 4×2 → 2×1 averages each 2×2 block, rounding half up.
+    const uint8_t src[] = {
+        10, 20, 100, 101,
+        30, 40, 100, 102,
+    };
+    uint8_t dst[2];
+    EXPECT(ik_downscale_box(src, 4, 4, 2, 1, dst, 2, 2, 1) == 0, "downscale failed");
+    EXPECT(dst[0] == 25 && dst[1] == 101, "got %u %u", dst[0], dst[1]);
+
+    EXPECT(ik_downscale_box(src, 4, 4, 2, 3, dst, 2, 2, 1) == -1, "3 channels accepted");
+    EXPECT(ik_downscale_box(src, 4, 4, 2, 1, dst, 8, 8, 1) == -1, "upscale accepted");
+}
+
+/// Direct per-pixel means, independent of the column-sum and reciprocal tricks.
+static void test_downscale_against_definition(void) {
+    static const size2 cases[][2] = {
+        { { 37, 23 }, { 5, 4 } },
+        { { 64, 64 }, { 1, 1 } },    // 4096-pixel box: divides rather than multiplies
+        { { 200, 150 }, { 3, 2 } },
+        { { 1920, 1440 }, { 480, 360 } },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const size_t sw = cases[i][0].width, sh = cases[i][0].height;
+        const size_t dw = cases[i][1].width, dh = cases[i][1].height;
+        uint8_t *src = random_plane(sw, sh);
+        uint8_t *dst = malloc(dw * dh);
+        EXPECT(ik_downscale_box(src, sw, sw, sh, 1, dst, dw, dw, dh) == 0, "downscale failed");
+        int matches = 1;
+        for (size_t y = 0; y < dh && matches; y++) {
+            for (size_t x = 0; x < dw && matches; x++) {
+                uint64_t sum = 0, count = 0;
+                for (size_t sy = y * sh / dh; sy < (y + 1) * sh / dh; sy++) {
+                    for (size_t sx = x * sw / dw; sx < (x + 1) * sw / dw; sx++) {
+                        sum += src[sy * sw + sx];
+                        count++;
+                    }
+                }
+                matches = dst[y * dw + x] == (sum + count / 2) / count;
+            }
+        }
+        EXPECT(matches, "%zux%zu -> %zux%zu differs from the box mean", sw, sh, dw, dh);
+        free(src);
+        free(dst);
+    }
+}
+
+static void test_planar_downscale(void) {
+    enum { width = 64, height = 48, dst_width = 16, dst_height = 12 };
+    uint8_t y[width * height], u[width * height / 4], v[width * height / 4], uv[width * height / 2];
+    memset(y, 200, sizeof(y));
+    memset(u, 90, sizeof(u));
+    memset(v, 160, sizeof(v));
+    for (size_t i = 0; i < sizeof(uv); i += 2) {
+        uv[i] = 90;
+        uv[i + 1] = 160;
+    }
+
+    uint8_t dy[dst_width * dst_height], du[dst_width * dst_height / 4], dv[dst_width * dst_height / 4];
+    uint8_t duv[dst_width * dst_height / 2];
+    EXPECT(ik_downscale_i420(y, width, u, width / 2, v, width / 2, width, height,
+                             dy, dst_width, du, dst_width / 2, dv, dst_width / 2, dst_width, dst_height) == 0,
+           "I420 downscale failed");
+    EXPECT(dy[0] == 200 && du[0] == 90 && dv[sizeof(dv) - 1] == 160, "I420 planes not preserved");
+
+    EXPECT(ik_downscale_nv12(y, width, uv, width, width, height,
+                             dy, dst_width, duv, dst_width, dst_width, dst_height) == 0,
+           "NV12 downscale failed");
+    EXPECT(duv[0] == 90 && duv[1] == 160 && duv[sizeof(duv) - 1] == 160, "NV12 chroma not preserved");
+
+    EXPECT(ik_downscale_nv12(y, width, uv, width, width - 1, height,
+                             dy, dst_width, duv, dst_width, dst_width, dst_height) == -1,
+           "odd NV12 width accepted");
+}
+
+static void test_metrics(void) {
+    enum { width = 40, height = 30 };
+    uint8_t plane[width * height];
+
+    memset(plane, 128, sizeof(plane));
+    EXPECT(ik_laplacian_variance(plane, width, width, height) == 0, "flat plane is not flat");
+    EXPECT(ik_laplacian_variance(plane, width, 2, 2) == 0, "tiny plane has a variance");
+
+    // A checkerboard is as sharp as it gets; a gradient has no curvature.
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            plane[y * width + x] = ((x + y) & 1) ? 255 : 0;
+        }
+    }
+    EXPECT(ik_laplacian_variance(plane, width, width, height) > 1e5, "checkerboard is not sharp");
+
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            plane[y * width + x] = (uint8_t)(250 - x * 6);
+        }
+    }
+    EXPECT(ik_laplacian_variance(plane, width, width, height) == 0, "linear gradient has curvature");
+    EXPECT(ik_dhash(plane, width, width, height) == UINT64_MAX, "decreasing gradient hash");
+
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            plane[y * width + x] = (uint8_t)(10 + x * 6);
+        }
+    }
+    EXPECT(ik_dhash(plane, width, width, height) == 0, "increasing gradient hash");
+    EXPECT(ik_dhash(plane, width, 8, 8) == 0, "plane narrower than the thumbnail");
+
+    EXPECT(ik_hamming_distance(0, UINT64_MAX) == 64, "hamming all bits");
+    EXPECT(ik_hamming_distance(0xF0, 0x0F) == 8, "hamming nibbles");
+    EXPECT(ik_hamming_distance(42, 42) == 0, "hamming equal");
+}
+
+int main(void) {
+    EXPECT(ik_isa_supported(IK_ISA_SCALAR), "scalar unsupported");
+    EXPECT(ik_set_isa(IK_ISA_COUNT) == -1, "bogus ISA accepted");
+
+    for (int isa = 0; isa < IK_ISA_COUNT; isa++) {
+        if (!ik_isa_supported((ik_isa)isa)) {
+            printf("skip %s\n", ik_isa_name((ik_isa)isa));
+            continue;
+        }
+        printf("check %s\n", ik_isa_name((ik_isa)isa));
+        check_isa((ik_isa)isa);
+        ik_set_isa((ik_isa)isa);
+        test_luma_weights();
+        test_downscale();
+        test_downscale_against_definition();
+        test_planar_downscale();
+        test_metrics();
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("all image kernel tests passed\n");
+    return 0;
+}
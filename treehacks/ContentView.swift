@@ -109,7 +109,7 @@ struct ContentView: View {
             } else {
                 ProgressView("Setting up...")
                     .onAppear {
-                        recordingManager = RecordingManager(cameraManager: cameraManager)
+                        recordingManager = RecordingManager(recorder: clipManager.recorder)
                     }
             }
         }
@@ -0,0 +1,145 @@
+//
+//  ClipStore.swift
+//  treehacks
+//
+//  The searchable clip history, ordered by end time. Clips live in
+//  fixed-size chunks, so a snapshot is a copy of the chunk list and a later
+//  update copies only the chunk it touches instead of the whole history.
+//  Every clip keeps a stable position for its lifetime. A slot map from ID
+//  to position, shared by all snapshots of one store, makes lookup and
+//  in-place updates O(1). Each clip's generation counts its updates.
+//  Snapshots are for reading; only the owner's copy should be mutated.
+//
+
+import Foundation
+
+struct ClipStore: RandomAccessCollection {
+
+    private static let chunkSize = 256
+
+    /// ID → position, shared by every snapshot of this store. Positions are
+    /// never reused, so a snapshot that finds a position outside its own range,
+    /// or holding another clip, simply does not contain that ID.
+    private final class SlotMap {
+        private let lock = NSLock()
+        private var positions: [UUID: Int] = [:]
+
+        subscript(id: UUID) -> Int? {
+            get {
+                lock.lock()
+                defer { lock.unlock() }
+                return positions[id]
+            }
+            set {
+                lock.lock()
+                positions[id] = newValue
+                lock.unlock()
+            }
+        }
+
+        func remove(_ ids: [UUID]) {
+            lock.lock()
+            for id in ids {
+                positions.removeValue(forKey: id)
+            }
+            lock.unlock()
+        }
+    }
+
+    /// Chunk `i` holds positions `(firstChunk + i) * chunkSize ..< +chunkSize`.
+    /// Pruned clips stay in the first chunk until all of it has expired.
+    private var chunks: [[IndexedClip]] = []
+    private var firstChunk = 0
+    /// Position of the oldest live clip.
+    private var firstPosition = 0
+    /// Position the next appended clip gets.
+    private var endPosition = 0
+    private let slots = SlotMap()
+
+    init() {}
+
+    /// A store holding `clips`, which must be ordered by end time.
+    init<S: Sequence>(_ clips: S) where S.Element == IndexedClip {
+        for clip in clips {
+            append(clip)
+        }
+    }
+
+    // MARK: - Collection
+
+    var startIndex: Int { 0 }
+    var endIndex: Int { endPosition - firstPosition }
+
+    subscript(index: Int) -> IndexedClip {
+        let (chunk, offset) = location(of: firstPosition + index)
+        return chunks[chunk][offset]
+    }
+
+    // MARK: - Lookup
+
+    /// The clip with `id`, if this snapshot holds it. O(1).
+    subscript(id id: UUID) -> IndexedClip? {
+        position(of: id).map { self[$0 - firstPosition] }
+    }
+
+    /// Current generation of the clip with `id`; it changes on every update.
+    func generation(of id: UUID) -> Int? {
+        self[id: id]?.generation
+    }
+
+    private func position(of id: UUID) -> Int? {
+        guard let position = slots[id],
+              position >= firstPosition, position < endPosition else { return nil }
+        let (chunk, offset) = location(of: position)
+        return chunks[chunk][offset].id == id ? position : nil
+    }
+
+    private func location(of position: Int) -> (chunk: Int, offset: Int) {
+        (position / Self.chunkSize - firstChunk, position % Self.chunkSize)
+    }
+
+    // MARK: - Mutation
+
+    /// Add a clip that ends no earlier than the newest one.
+    mutating func append(_ clip: IndexedClip) {
+        if endPosition % Self.chunkSize == 0 {
+            chunks.append([])
+            chunks[chunks.count - 1].reserveCapacity(Self.chunkSize)
+        }
+        chunks[chunks.count - 1].append(clip)
+        slots[clip.id] = endPosition
+        endPosition += 1
+    }
+
+    /// Apply `change` to the clip with `id` in place and bump its generation.
+    /// Returns the updated clip, or nil if the store does not hold it.
+    @discardableResult
+    mutating func update(_ id: UUID, _ change: (inout IndexedClip) -> Void) -> IndexedClip? {
+        guard let position = position(of: id) else { return nil }
+        let (chunk, offset) = location(of: position)
+        change(&chunks[chunk][offset])
+        chunks[chunk][offset].generation += 1
+        return chunks[chunk][offset]
+    }
+
+    /// Drop the oldest clips while they end before `cutoff`, releasing whole chunks
+    /// once all their clips have expired. Returns the IDs removed.
+    @discardableResult
+    mutating func removeClips(endingBefore cutoff: Date) -> [UUID] {
+        var removed: [UUID] = []
+        while firstPosition < endPosition {
+            let clip = self[0]
+            guard clip.endTime < cutoff else { break }
+            removed.append(clip.id)
+            firstPosition += 1
+        }
+        slots.remove(removed)
+
+        let expiredChunks = min(chunks.count, firstPosition / Self.chunkSize - firstChunk)
+        if expiredChunks > 0 {
+            chunks.removeFirst(expiredChunks)
+            firstChunk += expiredChunks
+        }
+        return removed
+    }
+}
@@ -4,19 +4,83 @@
 //
 //  Represents a short video clip that has been analyzed and indexed
 //  for semantic search. Each clip carries its file URL, time range,
-//  descriptive keywords, and an NLEmbedding vector.
+//  descriptive keywords, and whether its NLEmbedding vector is indexed.
+//  The vector itself lives quantized in ClipSearchEngine.
 //
 
 import Foundation
 
 struct IndexedClip: Identifiable {
-    let id = UUID()
-    let fileURL: URL
+    let id: UUID
     let startTime: Date
     let endTime: Date
-    var keywords: Set<String>
-    var description: String
-    var embedding: [Double]?
+    /// Whether the description's embedding is in the search index.
+    var hasEmbedding: Bool
+    /// Number of in-place updates (e.g. vision enhancement), bumped by `ClipStore`.
+    var generation = 0
+
+    /// File, description and keywords. Clips restored from the persistent index
+    /// decode them from its mapped strings on each read, so a large history
+    /// reopens without copying its text onto the heap; the first edit makes
+    /// the clip hold its own copy.
+    private enum Text {
+        case inline(fileURL: URL, description: String, keywords: Set<String>)
+        case persisted(PersistedClipText)
+    }
+    private var text: Text
+
+    init(
+        id: UUID = UUID(), fileURL: URL, startTime: Date, endTime: Date,
+        keywords: Set<String>, description: String, hasEmbedding: Bool
+    ) {
+        self.id = id
+        self.startTime = startTime
+        self.endTime = endTime
+        self.hasEmbedding = hasEmbedding
+        text = .inline(fileURL: fileURL, description: description, keywords: keywords)
+    }
+
+    /// A clip restored from the persistent index, its text left in the mapping.
+    init(id: UUID, startTime: Date, endTime: Date, hasEmbedding: Bool, text: PersistedClipText) {
+        self.id = id
+        self.startTime = startTime
+        self.endTime = endTime
+        self.hasEmbedding = hasEmbedding
+        self.text = .persisted(text)
+    }
+
+    var fileURL: URL {
+        switch text {
+        case .inline(let fileURL, _, _): return fileURL
+        case .persisted(let persisted): return persisted.fileURL
+        }
+    }
+
+    var description: String {
+        get {
+            switch text {
+            case .inline(_, let description, _): return description
+            case .persisted(let persisted): return persisted.description
+            }
+        }
+        set { text = .inline(fileURL: fileURL, description: newValue, keywords: keywords) }
+    }
+
+    var keywords: Set<String> {
+        get {
+            switch text {
+            case .inline(_, _, let keywords): return keywords
+            case .persisted(let persisted): return persisted.keywords
+            }
+        }
+        set { text = .inline(fileURL: fileURL, description: description, keywords: newValue) }
+    }
+
+    /// Whether the clip's video is still on disk. The index outlives the
+    /// recorder's video retention, so older clips stay searchable without it.
+    var hasVideo: Bool {
+        FileManager.default.fileExists(atPath: fileURL.path)
+    }
 
     /// How many seconds ago this clip was recorded (relative to now).
     var secondsAgo: TimeInterval {
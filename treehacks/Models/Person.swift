@@ -12,7 +12,7 @@ struct Person: Identifiable {
     var notes: String
     var phoneNumber: String
     /// Multiple face embeddings (one per reference photo) for better recognition.
-    var faceEmbeddings: [[Float]]
+    var faceEmbeddings: [FaceDescriptor]
     var referencePhotos: [UIImage]
 
     /// Convert to a codable payload for persistence (drops referencePhotos).
@@ -23,7 +23,8 @@ struct Person: Identifiable {
             relationship: relationship,
             notes: notes,
             phoneNumber: phoneNumber,
-            faceEmbeddings: faceEmbeddings,
+            faceEmbeddings: faceEmbeddings.map(\.stored),
+            faceDescriptorVersion: FaceDescriptor.version,
             referenceImageFile: nil,
             referenceImageData: nil,
             referenceImageName: nil
@@ -37,8 +38,10 @@ struct PersonPayload: Codable {
     var relationship: String
     var notes: String
     var phoneNumber: String?
-    /// Multiple face embeddings (one per reference photo).
+    /// Multiple face embeddings (one per reference photo), in `FaceDescriptor`'s stored form.
     var faceEmbeddings: [[Float]]
+    /// Layout of `faceEmbeddings`; nil for files written before descriptors were versioned.
+    var faceDescriptorVersion: Int?
     var referenceImageFile: String?
     var referenceImageData: String?
     var referenceImageName: String?
@@ -53,10 +56,28 @@ extension PersonPayload {
             relationship: relationship,
             notes: notes,
             phoneNumber: phoneNumber ?? "",
-            faceEmbeddings: faceEmbeddings,
+            faceEmbeddings: faceDescriptors,
             referencePhotos: []
         )
     }
+
+    /// Whether `faceEmbeddings` predates the current descriptor layout.
+    var needsDescriptorMigration: Bool {
+        faceDescriptorVersion != FaceDescriptor.version && !faceEmbeddings.isEmpty
+    }
+
+    /// Decoded descriptors, converting older layouts. Embeddings that cannot
+    /// be converted are dropped; the contact needs those photos retaken.
+    var faceDescriptors: [FaceDescriptor] {
+        let current = faceDescriptorVersion == FaceDescriptor.version
+        let descriptors = faceEmbeddings.compactMap { embedding in
+            current ? FaceDescriptor(stored: embedding) : FaceDescriptor(legacy: embedding)
+        }
+        if descriptors.count < faceEmbeddings.count {
+            print("[PersonPayload] Dropped \(faceEmbeddings.count - descriptors.count) unreadable face embedding(s) for \(name)")
+        }
+        return descriptors
+    }
 }
 
 enum PersonLoader {
@@ -91,7 +112,7 @@ enum PersonLoader {
                 relationship: payload.relationship,
                 notes: payload.notes,
                 phoneNumber: payload.phoneNumber ?? "",
-                faceEmbeddings: payload.faceEmbeddings,
+                faceEmbeddings: payload.faceDescriptors,
                 referencePhotos: photos
             )
         }
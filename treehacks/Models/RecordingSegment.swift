@@ -12,6 +12,9 @@ struct RecordingSegment: Identifiable {
     let fileURL: URL
     let startTime: Date
     var endTime: Date?
+    /// Media time of the file's first frame. Fragments keep their place in
+    /// the recording session's timeline, so this is usually not 0.
+    var mediaStartTime: TimeInterval = 0
 
     var duration: TimeInterval {
         guard let end = endTime else {
@@ -0,0 +1,196 @@
+//
+//  BestFrameSelector.swift
+//  treehacks
+//
+//  Picks the frames of a clip worth sending for vision enhancement. Each
+//  candidate is scored as it streams past: sharpness from the variance of
+//  its luma Laplacian (`ik_laplacian_variance`), novelty from its dHash
+//  distance to the other frames kept. Near-duplicates compete for one
+//  slot, so the kept frames show different things, and motion-blurred
+//  frames lose to sharp ones. Winners are copied into a few recycled
+//  buffers (camera buffers go back to ARKit's pool), and only they are
+//  JPEG-encoded when the clip finalizes.
+//
+
+import CoreVideo
+import Foundation
+import ImageKernels
+
+struct BestFrameSelector {
+
+    /// A kept frame.
+    struct Frame {
+        let pixelBuffer: CVPixelBuffer
+        /// Seconds since the clip started.
+        let offset: TimeInterval
+        let sharpness: Double
+        let hash: UInt64
+    }
+
+    /// Frames kept per clip.
+    let capacity: Int
+    /// Hash bits within which two frames count as the same view.
+    var duplicateDistance = 6
+    /// Hash distance at which a frame counts as fully novel.
+    var novelDistance = 24
+    /// How much novelty can raise a frame's score over sharpness alone.
+    var noveltyWeight = 1.0
+
+    private(set) var frames: [Frame] = []
+    /// Evicted copy, reused for the next winner of the same size and format.
+    private var spare: CVPixelBuffer?
+    /// Luma plane of the last BGRA candidate, reused across frames.
+    private var luma: [UInt8] = []
+
+    init(capacity: Int) {
+        self.capacity = max(1, capacity)
+    }
+
+    /// Kept frames in capture order.
+    var winners: [CVPixelBuffer] {
+        frames.sorted { $0.offset < $1.offset }.map(\.pixelBuffer)
+    }
+
+    /// Start a new clip. Copies are kept for reuse.
+    mutating func reset() {
+        if spare == nil {
+            spare = frames.first?.pixelBuffer
+        }
+        frames = []
+    }
+
+    /// Score `pixelBuffer` and keep a copy if it beats a kept frame. `hash` is
+    /// its `SceneChangeDetector` signature hash. Returns whether it was kept.
+    @discardableResult
+    mutating func offer(_ pixelBuffer: CVPixelBuffer, hash: UInt64, offset: TimeInterval) -> Bool {
+        guard let sharpness = sharpness(of: pixelBuffer) else { return false }
+
+        // The same view as a kept frame: keep whichever of the two is sharper.
+        if let twin = frames.firstIndex(where: { distance($0.hash, hash) <= duplicateDistance }) {
+            guard sharpness > frames[twin].sharpness else { return false }
+            return replace(at: twin, with: pixelBuffer, sharpness: sharpness, hash: hash, offset: offset)
+        }
+        if frames.count < capacity {
+            return replace(at: nil, with: pixelBuffer, sharpness: sharpness, hash: hash, offset: offset)
+        }
+
+        // Full: drop the lowest scorer among the kept frames and the candidate.
+        let hashes = frames.map(\.hash) + [hash]
+        let sharpnesses = frames.map(\.sharpness) + [sharpness]
+        var worst = hashes.count - 1
+        var worstScore = Double.infinity
+        for i in hashes.indices {
+            var nearest = 64
+            for j in hashes.indices where j != i {
+                nearest = min(nearest, distance(hashes[i], hashes[j]))
+            }
+            let novelty = min(1, Double(nearest) / Double(novelDistance))
+            let score = sharpnesses[i] * (1 + noveltyWeight * novelty)
+            if score < worstScore {
+                worstScore = score
+                worst = i
+            }
+        }
+        guard worst < frames.count else { return false }
+        return replace(at: worst, with: pixelBuffer, sharpness: sharpness, hash: hash, offset: offset)
+    }
+
+    private func distance(_ a: UInt64, _ b: UInt64) -> Int {
+        (a ^ b).nonzeroBitCount
+    }
+
+    /// Copy `pixelBuffer` into a recycled buffer and store it at `index` (append when nil).
+    private mutating func replace(at index: Int?, with pixelBuffer: CVPixelBuffer,
+                                  sharpness: Double, hash: UInt64, offset: TimeInterval) -> Bool {
+        let evicted = index.map { frames[$0].pixelBuffer }
+        let target = [evicted, spare].compactMap { $0 }.first { Self.isCompatible($0, with: pixelBuffer) }
+        guard let copy = Self.copy(pixelBuffer, into: target) else { return false }
+        if target == nil {
+            spare = evicted ?? spare
+        } else if target === spare {
+            spare = evicted
+        }
+        let frame = Frame(pixelBuffer: copy, offset: offset, sharpness: sharpness, hash: hash)
+        if let index = index {
+            frames[index] = frame
+        } else {
+            frames.append(frame)
+        }
+        return true
+    }
+
+    // MARK: - Sharpness
+
+    /// Variance of the 4-neighbour Laplacian over the full-resolution luma
+    /// plane. Blur spreads edges over several pixels and drives it toward 0.
+    /// Nil for formats other than bi-planar YCbCr and 32BGRA.
+    private mutating func sharpness(of pixelBuffer: CVPixelBuffer) -> Double? {
+        CVPixelBufferLockBaseAddress(pixelBuffer, .readOnly)
+        defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, .readOnly) }
+
+        switch CVPixelBufferGetPixelFormatType(pixelBuffer) {
+        case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange, kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange:
+            guard let base = CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, 0) else { return nil }
+            return ik_laplacian_variance(base.assumingMemoryBound(to: UInt8.self),
+                                         CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, 0),
+                                         CVPixelBufferGetWidthOfPlane(pixelBuffer, 0),
+                                         CVPixelBufferGetHeightOfPlane(pixelBuffer, 0))
+        case kCVPixelFormatType_32BGRA:
+            guard let base = CVPixelBufferGetBaseAddress(pixelBuffer) else { return nil }
+            let width = CVPixelBufferGetWidth(pixelBuffer)
+            let height = CVPixelBufferGetHeight(pixelBuffer)
+            if luma.count != width * height {
+                luma = [UInt8](repeating: 0, count: width * height)
+            }
+            return luma.withUnsafeMutableBufferPointer { luma in
+                ik_bgra_to_luma(base.assumingMemoryBound(to: UInt8.self), CVPixelBufferGetBytesPerRow(pixelBuffer),
+                                luma.baseAddress, width, width, height)
+                return ik_laplacian_variance(luma.baseAddress, width, width, height)
+            }
+        default:
+            return nil
+        }
+    }
+
+    // MARK: - Copies
+
+    private static func isCompatible(_ buffer: CVPixelBuffer, with source: CVPixelBuffer) -> Bool {
+        CVPixelBufferGetPixelFormatType(buffer) == CVPixelBufferGetPixelFormatType(source)
+            && CVPixelBufferGetWidth(buffer) == CVPixelBufferGetWidth(source)
+            && CVPixelBufferGetHeight(buffer) == CVPixelBufferGetHeight(source)
+    }
+
+    /// Copy `source` row by row into `target`, or a new buffer when nil.
+    private static func copy(_ source: CVPixelBuffer, into target: CVPixelBuffer?) -> CVPixelBuffer? {
+        var destination = target
+        if destination == nil {
+            let attributes = [kCVPixelBufferIOSurfacePropertiesKey as String: [String: Any]()] as CFDictionary
+            CVPixelBufferCreate(kCFAllocatorDefault,
+                                CVPixelBufferGetWidth(source), CVPixelBufferGetHeight(source),
+                                CVPixelBufferGetPixelFormatType(source), attributes, &destination)
+        }
+        guard let copy = destination else { return nil }
+
+        CVPixelBufferLockBaseAddress(source, .readOnly)
+        CVPixelBufferLockBaseAddress(copy, [])
+        defer {
+            CVPixelBufferUnlockBaseAddress(copy, [])
+            CVPixelBufferUnlockBaseAddress(source, .readOnly)
+        }
+
+        let planes = CVPixelBufferIsPlanar(source) ? CVPixelBufferGetPlaneCount(source) : 0
+        for plane in 0..<max(planes, 1) {
+            let from = planes > 0 ? CVPixelBufferGetBaseAddressOfPlane(source, plane) : CVPixelBufferGetBaseAddress(source)
+            let to = planes > 0 ? CVPixelBufferGetBaseAddressOfPlane(copy, plane) : CVPixelBufferGetBaseAddress(copy)
+            guard let from = from, let to = to else { return nil }
+            let fromRowBytes = planes > 0 ? CVPixelBufferGetBytesPerRowOfPlane(source, plane) : CVPixelBufferGetBytesPerRow(source)
+            let toRowBytes = planes > 0 ? CVPixelBufferGetBytesPerRowOfPlane(copy, plane) : CVPixelBufferGetBytesPerRow(copy)
+            let rows = planes > 0 ? CVPixelBufferGetHeightOfPlane(source, plane) : CVPixelBufferGetHeight(source)
+            let rowLength = min(fromRowBytes, toRowBytes)
+            for row in 0..<rows {
+                memcpy(to + row * toRowBytes, from + row * fromRowBytes, rowLength)
+            }
+        }
+        return copy
+    }
+}
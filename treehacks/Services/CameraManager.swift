@@ -9,9 +9,9 @@ import AVFoundation
 import UIKit
 import Combine
 
-/// Manages the AVCaptureSession with dual outputs:
-/// - AVCaptureVideoDataOutput for real-time frame processing
-/// - AVCaptureMovieFileOutput for rolling video recording
+/// Manages the AVCaptureSession with an AVCaptureVideoDataOutput for
+/// real-time frame processing. Frames are recorded by passing them to
+/// ClipManager, whose FragmentedRecorder is the only encoder.
 class CameraManager: NSObject, ObservableObject {
 
     // MARK: - Published State
@@ -22,7 +22,6 @@ class CameraManager: NSObject, ObservableObject {
     // MARK: - Capture Session
 
     let session = AVCaptureSession()
-    let movieFileOutput = AVCaptureMovieFileOutput()
 
     private let videoDataOutput = AVCaptureVideoDataOutput()
     private let sessionQueue = DispatchQueue(label: "com.treehacks.sessionQueue")
@@ -33,11 +32,6 @@ class CameraManager: NSObject, ObservableObject {
     /// Called on every captured video frame for processing.
     var onFrameCaptured: ((CVPixelBuffer, CMTime) -> Void)?
 
-    // MARK: - Recording Delegate
-
-    /// Set this to the RecordingManager to receive recording callbacks.
-    weak var recordingDelegate: AVCaptureFileOutputRecordingDelegate?
-
     // MARK: - Setup
 
     /// Whether the session has already been configured (inputs/outputs added).
@@ -97,11 +91,6 @@ class CameraManager: NSObject, ObservableObject {
             session.addOutput(videoDataOutput)
         }
 
-        // --- Movie File Output (for recording) ---
-        if session.canAddOutput(movieFileOutput) {
-            session.addOutput(movieFileOutput)
-        }
-
         session.commitConfiguration()
         isConfigured = true
     }
@@ -131,20 +120,6 @@ class CameraManager: NSObject, ObservableObject {
             }
         }
     }
-
-    // MARK: - Recording Control
-
-    func startRecording(to url: URL) {
-        guard let delegate = recordingDelegate else { return }
-        if movieFileOutput.isRecording { return }
-        movieFileOutput.startRecording(to: url, recordingDelegate: delegate)
-    }
-
-    func stopRecording() {
-        if movieFileOutput.isRecording {
-            movieFileOutput.stopRecording()
-        }
-    }
 }
 
 // MARK: - AVCaptureVideoDataOutputSampleBufferDelegate
@@ -0,0 +1,680 @@
+//
+//  ClipIndexStore.swift
+//  treehacks
+//
+//  On-disk clip index that survives app restarts. Three files live under
+//  Documents/clip_index:
+//
+//    records.bin  32-byte header, then one 64-byte record per clip
+//                 (id, start/end time, flags, reference into strings.bin)
+//    vectors.bin  one row per record: Float32 scale, then `dimension`
+//                 int8 codes (the `VectorCodes` int8 format)
+//    strings.bin  length-prefixed UTF-8 fields: video file name,
+//                 description, then each keyword
+//
+//  Opening maps the files rather than reading them and reads only the
+//  fixed-size records. Clip text decodes from the mapping on access, and
+//  `PersistedClipVectors` reads vector rows from it, so a large history
+//  reopens without copying either onto the heap.
+//  Clips are appended as they finalize, with the record written last so a
+//  torn append is ignored. Updates patch rows in place, removals tombstone
+//  the record, and compaction reclaims tombstones in the background.
+//
+
+import Foundation
+
+final class ClipIndexStore {
+
+    // MARK: - Format
+
+    private static let magic: UInt32 = 0x5849_4C43  // "CLIX"
+    private static let version: UInt32 = 1
+    fileprivate static let headerSize = 32
+    fileprivate static let recordStride = 64
+
+    /// Byte offsets of the fields within a record.
+    fileprivate enum RecordField {
+        static let id = 0              // uuid_t
+        static let startTime = 16      // Double, seconds since reference date
+        static let endTime = 24        // Double
+        static let flags = 32          // UInt32
+        static let textOffset = 40     // UInt64 into strings.bin
+        static let textLength = 48     // UInt32
+    }
+
+    fileprivate struct Flags: OptionSet {
+        let rawValue: UInt32
+        static let live = Flags(rawValue: 1 << 0)
+        static let hasEmbedding = Flags(rawValue: 1 << 1)
+    }
+
+    /// Compact once tombstones reach this many and outnumber live records.
+    private static let minTombstonesForCompaction = 1024
+
+    // MARK: - State
+
+    let directory: URL
+    /// Embedding length of every vector row (0 if embeddings are unavailable).
+    private(set) var dimension: Int
+
+    /// Serial queue for all file access; appends and compaction run here.
+    private let ioQueue = DispatchQueue(label: "com.treehacks.clipIndexStore", qos: .utility)
+
+    private var recordsHandle: FileHandle?
+    private var vectorsHandle: FileHandle?
+    private var stringsHandle: FileHandle?
+    private var rowByID: [UUID: Int] = [:]
+    private var rowCount = 0
+    private var tombstones = 0
+
+    private var vectorStride: Int { MemoryLayout<Float>.size + dimension }
+
+    private var recordsURL: URL { directory.appendingPathComponent("records.bin") }
+    private var vectorsURL: URL { directory.appendingPathComponent("vectors.bin") }
+    private var stringsURL: URL { directory.appendingPathComponent("strings.bin") }
+
+    /// Open the index in `directory`, creating it if needed. An index written with a
+    /// different embedding dimension is discarded; pass 0 to adopt whatever is on disk.
+    init(directory: URL, dimension: Int) {
+        self.directory = directory
+        self.dimension = dimension
+        ioQueue.sync { openFiles() }
+    }
+
+    // MARK: - Loading
+
+    /// Map the index and list its live clips, ordered by end time. Only the
+    /// fixed-size records are read: each clip's file name, description and
+    /// keywords stay in the strings mapping and decode when read (see
+    /// `PersistedClipText`), and vectors are read through the returned
+    /// `PersistedClipVectors`.
+    func load(videoDirectory: URL) -> (clips: [IndexedClip], vectors: PersistedClipVectors?) {
+        ioQueue.sync {
+            guard let records = try? Data(contentsOf: recordsURL, options: .alwaysMapped),
+                  let vectors = try? Data(contentsOf: vectorsURL, options: .alwaysMapped),
+                  let strings = try? Data(contentsOf: stringsURL, options: .alwaysMapped) else {
+                return ([], nil)
+            }
+
+            var clips: [IndexedClip] = []
+            clips.reserveCapacity(rowCount)
+            rowByID = [:]
+            tombstones = 0
+            records.withUnsafeBytes { recordBytes in
+                for row in 0..<rowCount {
+                    let record = Record(recordBytes, row: row)
+                    guard record.flags.contains(.live) else {
+                        tombstones += 1
+                        continue
+                    }
+                    rowByID[record.id] = row
+                    clips.append(IndexedClip(
+                        id: record.id,
+                        startTime: record.startTime,
+                        endTime: record.endTime,
+                        hasEmbedding: record.flags.contains(.hasEmbedding),
+                        text: PersistedClipText(strings: strings, offset: record.textOffset,
+                                                length: record.textLength, videoDirectory: videoDirectory)
+                    ))
+                }
+            }
+            clips.sort { $0.endTime < $1.endTime }
+
+            let persisted = dimension > 0
+                ? PersistedClipVectors(dimension: dimension, rowCount: rowCount, rowByID: rowByID,
+                                       records: records, vectors: vectors)
+                : nil
+            return (clips, persisted)
+        }
+    }
+
+    // MARK: - Mutation
+
+    /// Append a newly finalized clip. `embedding` is quantized to int8 on write.
+    func append(_ clip: IndexedClip, embedding: [Double]?) {
+        ioQueue.async { [weak self] in
+            guard let self = self,
+                  let records = self.recordsHandle,
+                  let vectors = self.vectorsHandle,
+                  let strings = self.stringsHandle else { return }
+            let text = Self.encodeFields(clip)
+            let vector = self.vectorRow(for: embedding)
+            do {
+                let textOffset = try strings.seekToEnd()
+                try strings.write(contentsOf: text)
+                try vectors.seek(toOffset: UInt64(self.rowCount * self.vectorStride))
+                try vectors.write(contentsOf: vector.row)
+                try records.seek(toOffset: UInt64(Self.headerSize + self.rowCount * Self.recordStride))
+                try records.write(contentsOf: Self.encodeRecord(
+                    clip, flags: vector.flags, textOffset: textOffset, textLength: text.count
+                ))
+                self.rowByID[clip.id] = self.rowCount
+                self.rowCount += 1
+            } catch {
+                print("[ClipIndexStore] Append failed: \(error)")
+            }
+        }
+    }
+
+    /// Rewrite a clip's text and vector in place (e.g. after vision enhancement).
+    func update(_ clip: IndexedClip, embedding: [Double]?) {
+        ioQueue.async { [weak self] in
+            guard let self = self,
+                  let row = self.rowByID[clip.id],
+                  let records = self.recordsHandle,
+                  let vectors = self.vectorsHandle,
+                  let strings = self.stringsHandle else { return }
+            let text = Self.encodeFields(clip)
+            let vector = self.vectorRow(for: embedding)
+            do {
+                let textOffset = try strings.seekToEnd()
+                try strings.write(contentsOf: text)
+                try vectors.seek(toOffset: UInt64(row * self.vectorStride))
+                try vectors.write(contentsOf: vector.row)
+                try records.seek(toOffset: UInt64(Self.headerSize + row * Self.recordStride))
+                try records.write(contentsOf: Self.encodeRecord(
+                    clip, flags: vector.flags, textOffset: textOffset, textLength: text.count
+                ))
+            } catch {
+                print("[ClipIndexStore] Update failed: \(error)")
+            }
+        }
+    }
+
+    /// Tombstone pruned clips, compacting in the background once enough accumulate.
+    func remove(_ clipIDs: [UUID]) {
+        guard !clipIDs.isEmpty else { return }
+        ioQueue.async { [weak self] in
+            guard let self = self, let records = self.recordsHandle else { return }
+            var cleared: UInt32 = 0
+            let clearedFlags = Data(bytes: &cleared, count: MemoryLayout<UInt32>.size)
+            for id in clipIDs {
+                guard let row = self.rowByID.removeValue(forKey: id) else { continue }
+                let offset = Self.headerSize + row * Self.recordStride + RecordField.flags
+                do {
+                    try records.seek(toOffset: UInt64(offset))
+                    try records.write(contentsOf: clearedFlags)
+                    self.tombstones += 1
+                } catch {
+                    print("[ClipIndexStore] Tombstone failed: \(error)")
+                }
+            }
+            if self.tombstones >= Self.minTombstonesForCompaction, self.tombstones > self.rowByID.count {
+                self.compact()
+            }
+        }
+    }
+
+    // MARK: - Compaction
+
+    /// Rewrite the live records into fresh files and swap them in. Runs on `ioQueue`.
+    /// Mappings handed out by `load` keep referring to the old (unlinked) files.
+    private func compact() {
+        let start = Date()
+        let fm = FileManager.default
+        let staging = directory.appendingPathExtension("compacting")
+        let retired = directory.appendingPathExtension("old")
+        try? fm.removeItem(at: staging)
+        try? fm.removeItem(at: retired)
+
+        guard let records = try? Data(contentsOf: recordsURL, options: .alwaysMapped),
+              let vectors = try? Data(contentsOf: vectorsURL, options: .alwaysMapped),
+              let strings = try? Data(contentsOf: stringsURL, options: .alwaysMapped) else { return }
+
+        do {
+            try fm.createDirectory(at: staging, withIntermediateDirectories: true)
+            var outRecords = Self.header(dimension: dimension)
+            var outVectors = Data()
+            var outStrings = Data()
+            var newRows: [UUID: Int] = [:]
+
+            let recordsOut = staging.appendingPathComponent("records.bin")
+            let vectorsOut = staging.appendingPathComponent("vectors.bin")
+            let stringsOut = staging.appendingPathComponent("strings.bin")
+            for url in [recordsOut, vectorsOut, stringsOut] {
+                fm.createFile(atPath: url.path, contents: nil)
+            }
+            let recordsWriter = try FileHandle(forWritingTo: recordsOut)
+            let vectorsWriter = try FileHandle(forWritingTo: vectorsOut)
+            let stringsWriter = try FileHandle(forWritingTo: stringsOut)
+            defer {
+                try? recordsWriter.close()
+                try? vectorsWriter.close()
+                try? stringsWriter.close()
+            }
+
+            var stringsWritten = 0
+            let flushThreshold = 1 << 20
+            try records.withUnsafeBytes { recordBytes in
+                try vectors.withUnsafeBytes { vectorBytes in
+                    try strings.withUnsafeBytes { stringBytes in
+                        for row in 0..<rowCount {
+                            var record = Record(recordBytes, row: row)
+                            guard record.flags.contains(.live), rowByID[record.id] == row else { continue }
+
+                            let text = UnsafeRawBufferPointer(rebasing:
+                                stringBytes[Int(record.textOffset)..<Int(record.textOffset) + record.textLength])
+                            record.textOffset = UInt64(stringsWritten + outStrings.count)
+                            outStrings.append(contentsOf: text)
+                            outVectors.append(contentsOf: UnsafeRawBufferPointer(rebasing:
+                                vectorBytes[row * vectorStride..<(row + 1) * vectorStride]))
+                            newRows[record.id] = newRows.count
+                            outRecords.append(record.encoded())
+
+                            if outRecords.count + outVectors.count + outStrings.count >= flushThreshold {
+                                stringsWritten += outStrings.count
+                                try recordsWriter.write(contentsOf: outRecords)
+                                try vectorsWriter.write(contentsOf: outVectors)
+                                try stringsWriter.write(contentsOf: outStrings)
+                                outRecords.removeAll(keepingCapacity: true)
+                                outVectors.removeAll(keepingCapacity: true)
+                                outStrings.removeAll(keepingCapacity: true)
+                            }
+                        }
+                    }
+                }
+            }
+            try recordsWriter.write(contentsOf: outRecords)
+            try vectorsWriter.write(contentsOf: outVectors)
+            try stringsWriter.write(contentsOf: outStrings)
+
+            closeFiles()
+            try fm.moveItem(at: directory, to: retired)
+            try fm.moveItem(at: staging, to: directory)
+            try? fm.removeItem(at: retired)
+            openFiles()
+            print("[ClipIndexStore] Compacted \(tombstones) tombstone(s), \(newRows.count) live in \(Int(Date().timeIntervalSince(start) * 1000)) ms")
+        } catch {
+            print("[ClipIndexStore] Compaction failed: \(error)")
+            try? fm.removeItem(at: staging)
+            if !fm.fileExists(atPath: directory.path), fm.fileExists(atPath: retired.path) {
+                try? fm.moveItem(at: retired, to: directory)
+            }
+            closeFiles()
+            openFiles()
+        }
+    }
+
+    // MARK: - Files
+
+    /// Open (or create) the three files and recover `rowCount`. Runs on `ioQueue`.
+    private func openFiles() {
+        let fm = FileManager.default
+        try? fm.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        if !adoptExistingHeader() {
+            for url in [recordsURL, vectorsURL, stringsURL] {
+                fm.createFile(atPath: url.path, contents: nil)
+            }
+            try? Self.header(dimension: dimension).write(to: recordsURL)
+        }
+
+        do {
+            recordsHandle = try FileHandle(forUpdating: recordsURL)
+            vectorsHandle = try FileHandle(forUpdating: vectorsURL)
+            stringsHandle = try FileHandle(forUpdating: stringsURL)
+        } catch {
+            print("[ClipIndexStore] Failed to open index: \(error)")
+            closeFiles()
+            return
+        }
+
+        // A crash mid-append can leave trailing partial rows; the record is
+        // written last, so drop anything past the last complete record.
+        let recordsSize = fileSize(recordsURL)
+        let vectorsSize = fileSize(vectorsURL)
+        rowCount = min(max(0, recordsSize - Self.headerSize) / Self.recordStride, vectorsSize / vectorStride)
+        try? recordsHandle?.truncate(atOffset: UInt64(Self.headerSize + rowCount * Self.recordStride))
+        try? vectorsHandle?.truncate(atOffset: UInt64(rowCount * vectorStride))
+
+        // Rebuild the ID map (cheap: 16 bytes per record) when reopening after compaction.
+        if !rowByID.isEmpty || tombstones > 0 {
+            rowByID = [:]
+            tombstones = 0
+            if let records = try? Data(contentsOf: recordsURL, options: .alwaysMapped) {
+                records.withUnsafeBytes { bytes in
+                    for row in 0..<rowCount {
+                        let record = Record(bytes, row: row)
+                        if record.flags.contains(.live) {
+                            rowByID[record.id] = row
+                        } else {
+                            tombstones += 1
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /// Validate the header on disk. Adopts its dimension when ours is 0.
+    private func adoptExistingHeader() -> Bool {
+        guard let handle = FileHandle(forReadingAtPath: recordsURL.path) else { return false }
+        defer { try? handle.close() }
+        guard let header = try? handle.read(upToCount: Self.headerSize), header.count == Self.headerSize else {
+            return false
+        }
+        let fields = header.withUnsafeBytes { raw in
+            (magic: raw.loadUnaligned(fromByteOffset: 0, as: UInt32.self),
+             version: raw.loadUnaligned(fromByteOffset: 4, as: UInt32.self),
+             dimension: Int(raw.loadUnaligned(fromByteOffset: 8, as: UInt32.self)),
+             stride: Int(raw.loadUnaligned(fromByteOffset: 12, as: UInt32.self)))
+        }
+        guard fields.magic == Self.magic, fields.version == Self.version,
+              fields.stride == Self.recordStride else { return false }
+        if dimension == 0 {
+            dimension = fields.dimension
+        }
+        guard fields.dimension == dimension else {
+            print("[ClipIndexStore] Embedding dimension changed (\(fields.dimension) → \(dimension)); starting a new index")
+            return false
+        }
+        return true
+    }
+
+    private func closeFiles() {
+        try? recordsHandle?.close()
+        try? vectorsHandle?.close()
+        try? stringsHandle?.close()
+        recordsHandle = nil
+        vectorsHandle = nil
+        stringsHandle = nil
+    }
+
+    private func fileSize(_ url: URL) -> Int {
+        let attributes = try? FileManager.default.attributesOfItem(atPath: url.path)
+        return (attributes?[.size] as? NSNumber)?.intValue ?? 0
+    }
+
+    // MARK: - Encoding
+
+    private static func header(dimension: Int) -> Data {
+        var data = Data(count: headerSize)
+        data.withUnsafeMutableBytes { raw in
+            raw.storeBytes(of: magic, toByteOffset: 0, as: UInt32.self)
+            raw.storeBytes(of: version, toByteOffset: 4, as: UInt32.self)
+            raw.storeBytes(of: UInt32(dimension), toByteOffset: 8, as: UInt32.self)
+            raw.storeBytes(of: UInt32(recordStride), toByteOffset: 12, as: UInt32.self)
+        }
+        return data
+    }
+
+    private static func encodeRecord(_ clip: IndexedClip, flags: Flags, textOffset: UInt64, textLength: Int) -> Data {
+        Record(
+            id: clip.id, startTime: clip.startTime, endTime: clip.endTime,
+            flags: flags, textOffset: textOffset, textLength: textLength
+        ).encoded()
+    }
+
+    /// Quantized vector row and the flags describing it. Rows without a usable
+    /// embedding are zero-filled so every record keeps a row at the same stride.
+    private func vectorRow(for embedding: [Double]?) -> (row: Data, flags: Flags) {
+        var row = Data(count: vectorStride)
+        guard let embedding = embedding,
+              let unit = VectorMath.normalized(embedding),
+              unit.count == dimension else { return (row, .live) }
+        let encoded = VectorCodes.int8Encode(unit)
+        row.withUnsafeMutableBytes { raw in
+            raw.storeBytes(of: encoded.scale, toByteOffset: 0, as: Float.self)
+            encoded.codes.withUnsafeBytes { codes in
+                UnsafeMutableRawBufferPointer(rebasing: raw[MemoryLayout<Float>.size...]).copyMemory(from: codes)
+            }
+        }
+        return (row, [.live, .hasEmbedding])
+    }
+
+    /// File name, description, then keywords, each as a UInt32 length and UTF-8 bytes.
+    private static func encodeFields(_ clip: IndexedClip) -> Data {
+        var data = Data()
+        for field in [clip.fileURL.lastPathComponent, clip.description] + clip.keywords.sorted() {
+            let utf8 = Array(field.utf8)
+            withUnsafeBytes(of: UInt32(utf8.count)) { data.append(contentsOf: $0) }
+            data.append(contentsOf: utf8)
+        }
+        return data
+    }
+
+    /// Field `index` of the text at `offset`, or nil past the last field.
+    fileprivate static func decodeField(_ index: Int, _ bytes: UnsafeRawBufferPointer, offset: UInt64, length: Int) -> String? {
+        var result: String?
+        forEachField(bytes, offset: offset, length: length) { i, field in
+            guard i == index else { return true }
+            result = String(decoding: field, as: UTF8.self)
+            return false
+        }
+        return result
+    }
+
+    /// Calls `body` with each field's index and bytes until it returns false.
+    fileprivate static func forEachField(_ bytes: UnsafeRawBufferPointer, offset: UInt64, length: Int,
+                                         _ body: (Int, UnsafeRawBufferPointer) -> Bool) {
+        var cursor = Int(offset)
+        let end = min(bytes.count, cursor + length)
+        var index = 0
+        while cursor + 4 <= end {
+            let count = Int(bytes.loadUnaligned(fromByteOffset: cursor, as: UInt32.self))
+            cursor += 4
+            guard cursor + count <= end,
+                  body(index, UnsafeRawBufferPointer(rebasing: bytes[cursor..<cursor + count])) else { break }
+            cursor += count
+            index += 1
+        }
+    }
+}
+
+// MARK: - Record
+
+/// One fixed-stride entry of records.bin.
+private struct Record {
+    var id: UUID
+    var startTime: Date
+    var endTime: Date
+    var flags: ClipIndexStore.Flags
+    var textOffset: UInt64
+    var textLength: Int
+
+    init(id: UUID, startTime: Date, endTime: Date, flags: ClipIndexStore.Flags, textOffset: UInt64, textLength: Int) {
+        self.id = id
+        self.startTime = startTime
+        self.endTime = endTime
+        self.flags = flags
+        self.textOffset = textOffset
+        self.textLength = textLength
+    }
+
+    /// Decode record `row` from the mapped records file.
+    init(_ bytes: UnsafeRawBufferPointer, row: Int) {
+        typealias Field = ClipIndexStore.RecordField
+        let base = ClipIndexStore.headerSize + row * ClipIndexStore.recordStride
+        id = UUID(uuid: bytes.loadUnaligned(fromByteOffset: base + Field.id, as: uuid_t.self))
+        startTime = Date(timeIntervalSinceReferenceDate: bytes.loadUnaligned(fromByteOffset: base + Field.startTime, as: Double.self))
+        endTime = Date(timeIntervalSinceReferenceDate: bytes.loadUnaligned(fromByteOffset: base + Field.endTime, as: Double.self))
+        flags = ClipIndexStore.Flags(rawValue: bytes.loadUnaligned(fromByteOffset: base + Field.flags, as: UInt32.self))
+        textOffset = bytes.loadUnaligned(fromByteOffset: base + Field.textOffset, as: UInt64.self)
+        textLength = Int(bytes.loadUnaligned(fromByteOffset: base + Field.textLength, as: UInt32.self))
+    }
+
+    func encoded() -> Data {
+        typealias Field = ClipIndexStore.RecordField
+        var data = Data(count: ClipIndexStore.recordStride)
+        data.withUnsafeMutableBytes { raw in
+            raw.storeBytes(of: id.uuid, toByteOffset: Field.id, as: uuid_t.self)
+            raw.storeBytes(of: startTime.timeIntervalSinceReferenceDate, toByteOffset: Field.startTime, as: Double.self)
+            raw.storeBytes(of: endTime.timeIntervalSinceReferenceDate, toByteOffset: Field.endTime, as: Double.self)
+            raw.storeBytes(of: flags.rawValue, toByteOffset: Field.flags, as: UInt32.self)
+            raw.storeBytes(of: textOffset, toByteOffset: Field.textOffset, as: UInt64.self)
+            raw.storeBytes(of: UInt32(textLength), toByteOffset: Field.textLength, as: UInt32.self)
+        }
+        return data
+    }
+}
+
+// MARK: - Persisted Text
+
+/// A restored clip's fields, left in the mapped strings.bin. Each read decodes
+/// from the mapping, so clips nobody looks at never put their text on the heap.
+/// The mapping stays valid after compaction swaps the files.
+struct PersistedClipText {
+    private let strings: Data
+    private let offset: UInt64
+    private let length: Int
+    private let videoDirectory: URL
+
+    fileprivate init(strings: Data, offset: UInt64, length: Int, videoDirectory: URL) {
+        self.strings = strings
+        self.offset = offset
+        self.length = length
+        self.videoDirectory = videoDirectory
+    }
+
+    var fileURL: URL {
+        videoDirectory.appendingPathComponent(field(0) ?? "")
+    }
+
+    var description: String {
+        field(1) ?? ""
+    }
+
+    var keywords: Set<String> {
+        var keywords = Set<String>()
+        strings.withUnsafeBytes { bytes in
+            ClipIndexStore.forEachField(bytes, offset: offset, length: length) { index, field in
+                if index >= 2 {
+                    keywords.insert(String(decoding: field, as: UTF8.self))
+                }
+                return true
+            }
+        }
+        return keywords
+    }
+
+    private func field(_ index: Int) -> String? {
+        strings.withUnsafeBytes { ClipIndexStore.decodeField(index, $0, offset: offset, length: length) }
+    }
+}
+
+// MARK: - Persisted Vectors
+
+/// Read-only view of the vectors in a mapped index. Rows are decoded by ID
+/// into the in-memory index after a restore; until then they can be searched
+/// by a scan over the int8 codes with a full-precision re-rank of the best
+/// candidates. Nothing is copied: each read touches the mapped pages directly.
+struct PersistedClipVectors {
+
+    let dimension: Int
+    /// Rows in the mapping, including tombstones and rows without embeddings.
+    let rowCount: Int
+    /// Live row of each clip when the mapping was taken.
+    private let rowByID: [UUID: Int]
+    private let records: Data
+    private let vectors: Data
+
+    /// Candidates re-ranked against the unquantized query.
+    private static let rerankCount = 32
+
+    fileprivate init(dimension: Int, rowCount: Int, rowByID: [UUID: Int], records: Data, vectors: Data) {
+        self.dimension = dimension
+        self.rowCount = rowCount
+        self.rowByID = rowByID
+        self.records = records
+        self.vectors = vectors
+    }
+
+    /// The clip's stored vector decoded from its int8 codes, or nil when it has
+    /// no row or was saved without an embedding.
+    func unitVector(for id: UUID) -> [Float]? {
+        let stride = MemoryLayout<Float>.size + dimension
+        return records.withUnsafeBytes { recordBytes in
+            guard let row = embeddedRow(of: id, recordBytes) else { return nil }
+            return vectors.withUnsafeBytes { vectorBytes in
+                let scale = vectorBytes.loadUnaligned(fromByteOffset: row * stride, as: Float.self)
+                let codes = UnsafeRawBufferPointer(rebasing:
+                    vectorBytes[row * stride + MemoryLayout<Float>.size..<(row + 1) * stride])
+                return codes.bindMemory(to: Int8.self).map { Float($0) * scale }
+            }
+        }
+    }
+
+    /// Similarity of each listed clip's stored vector to the query, nil where
+    /// it has no row or was saved without an embedding. Reads only those rows.
+    func similarities(of ids: [UUID], to unitQuery: [Float]) -> [Float?] {
+        guard unitQuery.count == dimension else { return ids.map { _ in nil } }
+        let stride = MemoryLayout<Float>.size + dimension
+        let dim = dimension
+        return records.withUnsafeBytes { recordBytes in
+            vectors.withUnsafeBytes { vectorBytes in
+                unitQuery.withUnsafeBufferPointer { query in
+                    ids.map { id -> Float? in
+                        guard let row = embeddedRow(of: id, recordBytes) else { return nil }
+                        let scale = vectorBytes.loadUnaligned(fromByteOffset: row * stride, as: Float.self)
+                        let codes = (vectorBytes.baseAddress! + row * stride + MemoryLayout<Float>.size)
+                            .assumingMemoryBound(to: Int8.self)
+                        return VectorMath.dot(query.baseAddress!, codes, count: dim) * scale
+                    }
+                }
+            }
+        }
+    }
+
+    /// The clip's row, if it is live and has an embedding.
+    private func embeddedRow(of id: UUID, _ recordBytes: UnsafeRawBufferPointer) -> Int? {
+        guard let row = rowByID[id] else { return nil }
+        let base = ClipIndexStore.headerSize + row * ClipIndexStore.recordStride
+        let flags = ClipIndexStore.Flags(rawValue: recordBytes.loadUnaligned(
+            fromByteOffset: base + ClipIndexStore.RecordField.flags, as: UInt32.self))
+        return flags.contains([.live, .hasEmbedding]) ? row : nil
+    }
+
+    /// Up to `k` most similar live rows ending within `range` (anywhere when nil),
+    /// best first, skipping `excluded` clip IDs (clips removed or re-embedded since
+    /// the mapping was taken). Rows outside `range` are skipped before their codes are read.
+    func search(_ unitQuery: [Float], k: Int, in range: DateInterval? = nil, excluding excluded: Set<UUID>) -> [(hit: VectorHit, endTime: Date)] {
+        guard k > 0, rowCount > 0, unitQuery.count == dimension else { return [] }
+        let query = VectorCodes.int8Encode(unitQuery)
+        let stride = MemoryLayout<Float>.size + dimension
+        let dim = dimension
+
+        return records.withUnsafeBytes { recordBytes in
+            vectors.withUnsafeBytes { vectorBytes in
+                query.codes.withUnsafeBufferPointer { queryCodes in
+                    var candidates = TopKSelector<(row: Int, id: UUID, endTime: Date)>(k: max(k, Self.rerankCount))
+                    for row in 0..<rowCount {
+                        let base = ClipIndexStore.headerSize + row * ClipIndexStore.recordStride
+                        let flags = ClipIndexStore.Flags(rawValue: recordBytes.loadUnaligned(
+                            fromByteOffset: base + ClipIndexStore.RecordField.flags, as: UInt32.self))
+                        guard flags.contains([.live, .hasEmbedding]) else { continue }
+                        let endTime = Date(timeIntervalSinceReferenceDate: recordBytes.loadUnaligned(
+                            fromByteOffset: base + ClipIndexStore.RecordField.endTime, as: Double.self))
+                        if let range = range, !range.contains(endTime) { continue }
+
+                        let scale = vectorBytes.loadUnaligned(fromByteOffset: row * stride, as: Float.self)
+                        let codes = (vectorBytes.baseAddress! + row * stride + MemoryLayout<Float>.size)
+                            .assumingMemoryBound(to: Int8.self)
+                        let score = Double(Float(VectorMath.dot(codes, queryCodes.baseAddress!, count: dim)) * scale * query.scale)
+                        if let worst = candidates.threshold, score <= worst { continue }
+
+                        // Hash the ID only for rows that would make the cut.
+                        let id = UUID(uuid: recordBytes.loadUnaligned(
+                            fromByteOffset: base + ClipIndexStore.RecordField.id, as: uuid_t.self))
+                        guard !excluded.contains(id) else { continue }
+                        candidates.insert((row, id, endTime), score: score)
+                    }
+
+                    var reranked = TopKSelector<(id: UUID, endTime: Date)>(k: k)
+                    unitQuery.withUnsafeBufferPointer { full in
+                        for candidate in candidates.sortedDescending() {
+                            let row = candidate.element.row
+                            let scale = vectorBytes.loadUnaligned(fromByteOffset: row * stride, as: Float.self)
+                            let codes = (vectorBytes.baseAddress! + row * stride + MemoryLayout<Float>.size)
+                                .assumingMemoryBound(to: Int8.self)
+                            let score = VectorMath.dot(full.baseAddress!, codes, count: dim) * scale
+                            reranked.insert((candidate.element.id, candidate.element.endTime), score: Double(score))
+                        }
+                    }
+                    return reranked.sortedDescending().map {
+                        (VectorHit(id: $0.element.id, score: Float($0.score)), $0.element.endTime)
+                    }
+                }
+            }
+        }
+    }
+}
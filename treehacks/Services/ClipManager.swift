@@ -2,9 +2,13 @@
 //  ClipManager.swift
 //  treehacks
 //
-//  Records 5-second video clips using AVAssetWriter, analyzes frames
-//  with FrameAnalyzer for keywords, and indexes clips with NLEmbedding
-//  vectors for semantic search. Keeps the last 60 seconds of clips.
+//  Feeds camera frames to the shared FragmentedRecorder, analyzes frames
+//  with FrameAnalyzer for keywords when a SceneChangeDetector sees the
+//  scene change, and indexes each 6-second fragment the recorder saves as
+//  a clip with NLEmbedding vectors for semantic search. Clip video lasts as
+//  long as the recorder keeps fragments (the rolling recall buffer), while
+//  several days of searchable clip descriptions and vectors persist in a
+//  memory-mapped `ClipIndexStore` so history survives app restarts.
 //
 
 import AVFoundation
@@ -19,47 +23,76 @@ final class ClipManager: ObservableObject {
 
     // MARK: - Configuration
 
-    /// Duration of each clip in seconds.
+    /// Duration of each clip (one recorder fragment) in seconds.
     let clipDuration: TimeInterval = 6
 
-    /// Maximum total history to keep in seconds.
-    let maxHistory: TimeInterval = 60
+    /// Video kept on disk in seconds, for clip playback and the rolling recall buffer.
+    let maxHistory: TimeInterval = 300
 
-    /// Analyze a frame every N frames for keywords.
+    /// How long a clip stays searchable (keywords, description, embedding)
+    /// after its video file has been pruned.
+    let maxIndexHistory: TimeInterval = 3 * 24 * 60 * 60
+
+    /// Check every Nth frame for a scene change, analyzing it for keywords when there is one.
     let analyzeEveryNFrames = 10
 
+    /// Score every Nth frame as a candidate to send for vision enhancement.
+    let scoreEveryNFrames = 5
+
     // MARK: - Published State
 
-    @Published var indexedClips: [IndexedClip] = []
+    @Published var indexedClips = ClipStore()
     @Published var isActive = false
     @Published var clipCount: Int = 0
+    /// Vision and OpenAI work skipped because the scene had not changed.
+    @Published private(set) var sceneGateStats = SceneChangeDetector.Stats()
+    /// Vision enhancement requests, packing, and dropped work.
+    @Published private(set) var enhancementStats = VisionEnhancementQueue.Stats()
+    /// Frame intake depth, drops, and per-stage latency.
+    @Published private(set) var intakeMetrics = FrameIntakeQueue.Metrics()
 
     // MARK: - Dependencies
 
-    let searchEngine = ClipSearchEngine()
+    let searchEngine: ClipSearchEngine
     private let frameAnalyzer = FrameAnalyzer()
+    private let indexStore: ClipIndexStore
+    /// Rate-limits and batches GPT-4o-mini vision requests.
+    private let enhancementQueue = VisionEnhancementQueue()
+
+    /// The single encoder for the camera feed; its fragments are the clips.
+    /// RecordingManager reads the same fragments for the recall buffer.
+    let recorder: FragmentedRecorder
+    private var fragmentSubscription: AnyCancellable?
+    private var orientationSubscription: AnyCancellable?
 
-    // MARK: - AVAssetWriter State
+    // MARK: - Current Clip State (writerQueue only)
 
-    private var assetWriter: AVAssetWriter?
-    private var videoInput: AVAssetWriterInput?
-    private var adaptor: AVAssetWriterInputPixelBufferAdaptor?
+    /// When analysis for the clip in progress began.
     private var currentClipStartTime: Date?
-    private var sessionStartTimestamp: CMTime?
-    private var isWritingClip = false
     private var frameCount = 0
 
+    /// Transform for the device's current orientation, and the one the
+    /// recording session was started with.
+    private var deviceTransform: CGAffineTransform = .identity
+    private var sessionTransform: CGAffineTransform?
+
     // Accumulated keywords for the current clip being recorded
     private var currentKeywords = Set<String>()
 
-    /// Number of frames to capture per clip for GPT-4o-mini vision analysis.
-    private let visionFrameCount = 3
+    /// Gates Vision analysis on scene changes (writerQueue only).
+    private var sceneDetector = SceneChangeDetector()
+    private var sceneStats = SceneChangeDetector.Stats()
+    /// Keywords from the last analyzed frame, reused while the scene is static.
+    private var lastAnalyzedKeywords = Set<String>()
+    /// Whether any analyzed frame of the current clip showed a new scene.
+    private var currentClipChangedScene = false
+
+    /// The 3 sharpest, most distinct frames of the current clip, JPEG-encoded
+    /// for GPT-4o-mini vision analysis when the clip is finalized (writerQueue only).
+    private var frameSelector = BestFrameSelector(capacity: 3)
 
-    /// JPEG snapshots of representative frames for GPT-4o-mini vision analysis.
-    /// Captured at 25%, 50%, and 75% of the clip duration.
-    private var representativeFrameJPEGs: [Data] = []
-    /// Tracks which capture points (1/4, 2/4, 3/4) have already been taken.
-    private var nextCaptureIndex = 0
+    /// Frames from the camera waiting for writerQueue.
+    private let intake = FrameIntakeQueue()
 
     // Serial queue for all writing operations (thread safety)
     private let writerQueue = DispatchQueue(label: "com.treehacks.clipWriter", qos: .userInitiated)
@@ -72,7 +105,35 @@ final class ClipManager: ObservableObject {
         let docs = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first!
         clipsDirectory = docs.appendingPathComponent("searchable_clips", isDirectory: true)
         try? FileManager.default.createDirectory(at: clipsDirectory, withIntermediateDirectories: true)
-        cleanupAllClips()
+        recorder = FragmentedRecorder(directory: clipsDirectory, fragmentDuration: clipDuration, retention: maxHistory)
+        let engine = ClipSearchEngine()
+        searchEngine = engine
+        indexStore = ClipIndexStore(
+            directory: docs.appendingPathComponent("clip_index", isDirectory: true),
+            dimension: engine.embeddingDimension
+        )
+        restoreIndex()
+        deviceTransform = videoTransformForCurrentOrientation()
+        UIDevice.current.beginGeneratingDeviceOrientationNotifications()
+        orientationSubscription = NotificationCenter.default
+            .publisher(for: UIDevice.orientationDidChangeNotification)
+            .sink { [weak self] _ in
+                // Face up/down and unknown keep the last upright orientation.
+                guard let self = self, UIDevice.current.orientation.isValidInterfaceOrientation else { return }
+                let transform = self.videoTransformForCurrentOrientation()
+                self.writerQueue.async {
+                    self.deviceTransform = transform
+                }
+            }
+        enhancementQueue.onKeywords = { [weak self] job, keywords in
+            self?.applyVisionKeywords(keywords, to: job)
+        }
+        // Each saved fragment closes the clip being analyzed.
+        fragmentSubscription = recorder.fragments.sink { [weak self] fragment in
+            self?.writerQueue.async {
+                self?.finalizeClip(fragment)
+            }
+        }
     }
 
     // MARK: - Lifecycle
@@ -84,134 +145,128 @@ final class ClipManager: ObservableObject {
     func stop() {
         isActive = false
         writerQueue.async { [weak self] in
-            self?.finalizeCurrentClip()
+            self?.recorder.finish()
         }
     }
 
     // MARK: - Frame Processing (called from camera callback)
 
     /// Process a video frame: write to clip, analyze for keywords.
-    /// Call this from the camera frame callback (runs on writerQueue internally).
+    /// Call this from the camera frame callback. Frames wait in a bounded ring
+    /// and are handled in order on writerQueue.
     func processFrame(_ pixelBuffer: CVPixelBuffer, timestamp: CMTime) {
         guard isActive else { return }
 
-        writerQueue.async { [weak self] in
-            guard let self = self else { return }
-
-            // Start a new clip if none is active
-            if !self.isWritingClip {
-                self.startNewClip(firstFrame: pixelBuffer, timestamp: timestamp)
+        if intake.push(pixelBuffer, timestamp: timestamp) {
+            writerQueue.async { [weak self] in
+                self?.drainIntake()
             }
+        }
+    }
 
-            // Rotate clip if duration exceeded
-            if let start = self.currentClipStartTime,
-               Date().timeIntervalSince(start) >= self.clipDuration {
-                self.finalizeCurrentClip()
-                self.startNewClip(firstFrame: pixelBuffer, timestamp: timestamp)
-            }
+    /// Handle queued frames until the ring is empty (writerQueue only).
+    private func drainIntake() {
+        while let frame = intake.pop() {
+            handleFrame(frame)
+        }
+    }
 
-            // Write frame to current clip
-            self.writeFrame(pixelBuffer, timestamp: timestamp)
+    private func handleFrame(_ frame: FrameIntakeQueue.Frame) {
+        let pixelBuffer = frame.pixelBuffer
+        let timestamp = frame.timestamp
+        let writeStart = DispatchTime.now().uptimeNanoseconds
+
+        // Start recording if stopped; the recorder cuts clips from then on.
+        // A rotation ends the session so later fragments are written with the
+        // new orientation; the clip being analyzed carries on into the next one.
+        if recorder.isRecording, sessionTransform != deviceTransform {
+            recorder.finish()
+            startRecording(pixelBuffer, timestamp: timestamp)
+        } else if !recorder.isRecording {
+            startRecording(pixelBuffer, timestamp: timestamp)
+            resetClipState()
+        }
 
-            // Analyze every Nth frame for keywords
-            self.frameCount += 1
-            if self.frameCount % self.analyzeEveryNFrames == 0 {
-                let labels = self.frameAnalyzer.classifyFrame(pixelBuffer)
-                self.currentKeywords.formUnion(labels)
+        // Encode the frame
+        recorder.append(pixelBuffer, timestamp: timestamp)
+        intake.record(.write, since: writeStart)
+
+        // Under backlog the frame is only written; analysis resumes once caught up.
+        frameCount += 1
+        guard frame.analyze else { return }
+        let checksScene = frameCount % analyzeEveryNFrames == 0
+        let scoresFrame = ENABLE_OPENAI_CLIP_ENHANCEMENT && frameCount % scoreEveryNFrames == 0
+        guard checksScene || scoresFrame else { return }
+        let analysisStart = DispatchTime.now().uptimeNanoseconds
+        defer { intake.record(.analysis, since: analysisStart) }
+        let signature = SceneChangeDetector.signature(of: pixelBuffer)
+
+        // Analyze every Nth frame for keywords, unless the scene is unchanged
+        // since the last analyzed frame: then its keywords still describe it.
+        if checksScene {
+            sceneStats.framesChecked += 1
+            let changed = signature.map { sceneDetector.isChange($0) } ?? true
+            if changed {
+                var keywords = Set(frameAnalyzer.classifyFrame(pixelBuffer))
 
                 // Also try to recognize visible text
-                let textLabels = self.frameAnalyzer.recognizeText(in: pixelBuffer)
+                let textLabels = frameAnalyzer.recognizeText(in: pixelBuffer)
                 for text in textLabels {
-                    self.currentKeywords.insert("text: \(text)")
+                    keywords.insert("text: \(text)")
                 }
+                currentKeywords.formUnion(keywords)
+                lastAnalyzedKeywords = keywords
+                currentClipChangedScene = true
+            } else {
+                currentKeywords.formUnion(lastAnalyzedKeywords)
+                sceneStats.staticFrames += 1
+                sceneStats.visionCallsSaved += 2
             }
+        }
 
-            // Capture representative frames at 25%, 50%, and 75% of the clip
-            // (for GPT-4o-mini vision analysis after the clip is finalized)
-            if self.nextCaptureIndex < self.visionFrameCount,
-               let start = self.currentClipStartTime {
-                // Capture points: 1/4, 2/4, 3/4 of clipDuration
-                let captureTime = self.clipDuration * Double(self.nextCaptureIndex + 1) / Double(self.visionFrameCount + 1)
-                if Date().timeIntervalSince(start) >= captureTime {
-                    if let jpeg = self.frameAnalyzer.pixelBufferToJPEG(pixelBuffer) {
-                        self.representativeFrameJPEGs.append(jpeg)
-                    }
-                    self.nextCaptureIndex += 1
-                }
-            }
+        // Offer the frame as a candidate for GPT-4o-mini vision analysis
+        if scoresFrame, let signature = signature, let start = currentClipStartTime {
+            frameSelector.offer(pixelBuffer, hash: signature.hash,
+                                offset: Date().timeIntervalSince(start))
         }
     }
 
     // MARK: - Search
 
-    /// Find the best clip matching a user query (with embedding → keyword → recent fallbacks).
+    /// Find the best clip matching a user query (hybrid embedding + keyword ranking, recent fallback).
     func findBestClip(for query: String) -> ClipSearchResult? {
         searchEngine.findBestClip(for: query, in: indexedClips)
     }
 
-    /// Score all clips against a query (for debug display).
-    func scoreAllClips(for query: String) -> [(clip: IndexedClip, score: Double)] {
-        searchEngine.scoreAllClips(for: query, in: indexedClips)
+    /// Find up to `k` candidate clips for a query, best first.
+    func findTopClips(for query: String, k: Int) -> [ClipSearchResult] {
+        searchEngine.findTopClips(for: query, k: k, in: indexedClips)
     }
 
-    // MARK: - AVAssetWriter Management
-
-    private func startNewClip(firstFrame pixelBuffer: CVPixelBuffer, timestamp: CMTime) {
-        let fileName = "clip_\(Int(Date().timeIntervalSince1970 * 1000)).mov"
-        let clipURL = clipsDirectory.appendingPathComponent(fileName)
-
-        do {
-            let writer = try AVAssetWriter(url: clipURL, fileType: .mov)
-
-            let width = CVPixelBufferGetWidth(pixelBuffer)
-            let height = CVPixelBufferGetHeight(pixelBuffer)
-
-            let outputSettings: [String: Any] = [
-                AVVideoCodecKey: AVVideoCodecType.h264,
-                AVVideoWidthKey: width,
-                AVVideoHeightKey: height,
-                AVVideoCompressionPropertiesKey: [
-                    AVVideoAverageBitRateKey: 800_000,
-                    AVVideoMaxKeyFrameIntervalKey: 30,
-                ]
-            ]
-
-            let input = AVAssetWriterInput(mediaType: .video, outputSettings: outputSettings)
-            input.expectsMediaDataInRealTime = true
-            input.transform = videoTransformForCurrentOrientation()
-
-            let pixelAdaptor = AVAssetWriterInputPixelBufferAdaptor(
-                assetWriterInput: input,
-                sourcePixelBufferAttributes: [
-                    kCVPixelBufferPixelFormatTypeKey as String: kCVPixelFormatType_32BGRA
-                ]
-            )
-
-            guard writer.canAdd(input) else {
-                print("ClipManager: Cannot add video input to writer")
-                return
-            }
+    /// Score clips against a query (for debug display), keeping the top `limit`.
+    func scoreAllClips(for query: String, limit: Int = .max) -> [(clip: IndexedClip, score: Double)] {
+        searchEngine.scoreAllClips(for: query, in: indexedClips, limit: limit)
+    }
+
+    // MARK: - Clip Management
 
-            writer.add(input)
-            writer.startWriting()
-            writer.startSession(atSourceTime: timestamp)
-
-            self.assetWriter = writer
-            self.videoInput = input
-            self.adaptor = pixelAdaptor
-            self.currentClipStartTime = Date()
-            self.sessionStartTimestamp = timestamp
-            self.isWritingClip = true
-            self.currentKeywords = []
-            self.frameCount = 0
-            self.representativeFrameJPEGs = []
-            self.nextCaptureIndex = 0
-
-        } catch {
-            print("ClipManager: Failed to create AVAssetWriter: \(error)")
+    /// Start a recorder session in the current orientation (writerQueue only).
+    private func startRecording(_ pixelBuffer: CVPixelBuffer, timestamp: CMTime) {
+        let transform = deviceTransform
+        if recorder.start(firstFrame: pixelBuffer, timestamp: timestamp, transform: transform) {
+            sessionTransform = transform
         }
     }
 
+    /// Begin analysis for the next clip (writerQueue only).
+    private func resetClipState() {
+        currentClipStartTime = Date()
+        currentKeywords = []
+        currentClipChangedScene = false
+        frameCount = 0
+        frameSelector.reset()
+    }
+
     /// ARKit delivers frames in landscape-right. Return the transform so the written video is upright for the user.
     /// Includes an extra 180° so playback is not upside down.
     private func videoTransformForCurrentOrientation() -> CGAffineTransform {
@@ -241,150 +296,168 @@ final class ClipManager: ObservableObject {
         return base.concatenating(CGAffineTransform(rotationAngle: .pi))
     }
 
-    private func writeFrame(_ pixelBuffer: CVPixelBuffer, timestamp: CMTime) {
-        guard isWritingClip,
-              let input = videoInput,
-              let adaptor = adaptor,
-              input.isReadyForMoreMediaData else { return }
-
-        adaptor.append(pixelBuffer, withPresentationTime: timestamp)
-    }
-
-    private func finalizeCurrentClip() {
-        guard isWritingClip, let writer = assetWriter else { return }
-
-        isWritingClip = false
-
+    /// Index a fragment the recorder saved as the clip analyzed since the
+    /// previous one, then begin the next clip (writerQueue only).
+    private func finalizeClip(_ fragment: RecordingSegment) {
         let keywords = currentKeywords
-        let startTime = currentClipStartTime ?? Date()
-        let endTime = Date()
-        let clipURL = writer.outputURL
-        let frameJPEGs = representativeFrameJPEGs  // Capture for async use
-
-        videoInput?.markAsFinished()
-
-        writer.finishWriting { [weak self] in
-            guard let self = self else { return }
-
-            guard writer.status == .completed else {
-                print("[ClipManager] Writer finished with status \(writer.status.rawValue)")
-                if let error = writer.error {
-                    print("[ClipManager] Writer error: \(error)")
-                }
-                return
-            }
-
-            // Build initial description from on-device Vision keywords
-            let descriptionParts = keywords.sorted()
-            let description: String
-            if descriptionParts.isEmpty {
-                description = "video clip"
-            } else {
-                description = "I see " + descriptionParts.joined(separator: ", ")
-            }
-
-            // Compute NLEmbedding vector for the initial description
-            let embedding = self.searchEngine.computeEmbedding(for: description)
-
-            let clip = IndexedClip(
-                fileURL: clipURL,
-                startTime: startTime,
-                endTime: endTime,
-                keywords: keywords,
-                description: description,
-                embedding: embedding
-            )
-
-            DispatchQueue.main.async {
-                self.indexedClips.append(clip)
-                self.clipCount = self.indexedClips.count
-                self.pruneOldClips()
+        let startTime = fragment.startTime
+        let endTime = fragment.endTime ?? Date()
+        let clipURL = fragment.fileURL
+
+        // A clip whose scene never changed looks like the one already sent for
+        // enhancement, so only clips that showed something new are sent.
+        let wantsEnhancement = ENABLE_OPENAI_CLIP_ENHANCEMENT && !frameSelector.frames.isEmpty && OpenAIClient.hasAPIKey
+        let enhance = wantsEnhancement && currentClipChangedScene
+        if wantsEnhancement && !enhance {
+            sceneStats.openAIRequestsSaved += 1
+        }
+        // Encode only the selected frames, and only when they will be sent. This runs
+        // before the next clip starts, as the selector then reuses their buffers.
+        let frameJPEGs = enhance ? frameSelector.winners.compactMap { frameAnalyzer.pixelBufferToJPEG($0) } : []
+        let stats = sceneStats
+        let intakeMetrics = intake.metrics
+        resetClipState()
+
+        // Build initial description from on-device Vision keywords
+        let descriptionParts = keywords.sorted()
+        let description: String
+        if descriptionParts.isEmpty {
+            description = "video clip"
+        } else {
+            description = "I see " + descriptionParts.joined(separator: ", ")
+        }
 
-                // Asynchronously enhance keywords with GPT-4o-mini vision (3 frames in one call)
-                if ENABLE_OPENAI_CLIP_ENHANCEMENT, !frameJPEGs.isEmpty, OpenAIClient.hasAPIKey {
-                    self.enhanceClipWithVision(clipID: clip.id, jpegImages: frameJPEGs, existingKeywords: keywords)
-                }
+        // Compute NLEmbedding vector for the initial description
+        let embedding = searchEngine.computeEmbedding(for: description)
+
+        let clip = IndexedClip(
+            fileURL: clipURL,
+            startTime: startTime,
+            endTime: endTime,
+            keywords: keywords,
+            description: description,
+            hasEmbedding: embedding != nil
+        )
+
+        DispatchQueue.main.async {
+            self.indexedClips.append(clip)
+            self.searchEngine.index(clip, embedding: embedding)
+            self.indexStore.append(clip, embedding: embedding)
+            self.clipCount = self.indexedClips.count
+            self.sceneGateStats = stats
+            self.intakeMetrics = intakeMetrics
+            self.pruneOldClips()
+
+            // Asynchronously enhance keywords with GPT-4o-mini vision; the queue
+            // may pack this clip's frames with other waiting clips into one call
+            if !frameJPEGs.isEmpty {
+                self.enhanceClipWithVision(clip, jpegImages: frameJPEGs, existingKeywords: keywords)
             }
+            self.enhancementStats = self.enhancementQueue.stats
         }
-
-        // Clear writer references
-        self.assetWriter = nil
-        self.videoInput = nil
-        self.adaptor = nil
     }
 
     // MARK: - GPT-4o-mini Vision Enhancement
 
-    /// Sends representative frames to GPT-4o-mini (all in one API call) and upgrades
-    /// the clip's keywords, description, and embedding when the response comes back.
-    private func enhanceClipWithVision(clipID: UUID, jpegImages: [Data], existingKeywords: Set<String>) {
-        print("[ClipManager] Requesting GPT-4o-mini vision for clip \(clipID.uuidString.prefix(8)) with \(jpegImages.count) frame(s)...")
+    /// Queue a clip's selected frames for GPT-4o-mini vision. The clip's keywords,
+    /// description, and embedding are upgraded when its result comes back.
+    private func enhanceClipWithVision(_ clip: IndexedClip, jpegImages: [Data], existingKeywords: Set<String>) {
+        print("[ClipManager] Queueing GPT-4o-mini vision for clip \(clip.id.uuidString.prefix(8)) with \(jpegImages.count) frame(s)...")
+        enhancementQueue.enqueue(VisionEnhancementQueue.Job(
+            clipID: clip.id,
+            jpegImages: jpegImages,
+            existingKeywords: existingKeywords,
+            expires: clip.endTime.addingTimeInterval(maxIndexHistory)
+        ))
+    }
 
-        Task {
-            do {
-                guard let aiKeywords = try await OpenAIClient.describeImages(jpegImages) else {
-                    print("[ClipManager] Vision returned nil for clip \(clipID.uuidString.prefix(8))")
-                    return
-                }
+    /// Merge a vision result into its clip. Called off the main thread.
+    private func applyVisionKeywords(_ aiKeywords: [String], to job: VisionEnhancementQueue.Job) {
+        let clipID = job.clipID
+        let existingKeywords = job.existingKeywords
 
-                // Merge AI keywords with existing on-device keywords
-                var mergedKeywords = existingKeywords
-                for kw in aiKeywords {
-                    mergedKeywords.insert(kw)
-                }
+        // Merge AI keywords with existing on-device keywords
+        var mergedKeywords = existingKeywords
+        for kw in aiKeywords {
+            mergedKeywords.insert(kw)
+        }
 
-                // Build an improved description prioritizing the AI keywords
-                let aiDescription = "I see " + aiKeywords.joined(separator: ", ")
-                let fullDescription: String
-                if existingKeywords.isEmpty {
-                    fullDescription = aiDescription
-                } else {
-                    // AI keywords first (more accurate), then Vision keywords
-                    let visionPart = existingKeywords.sorted().joined(separator: ", ")
-                    fullDescription = aiDescription + "; also: " + visionPart
-                }
+        // Build an improved description prioritizing the AI keywords
+        let aiDescription = "I see " + aiKeywords.joined(separator: ", ")
+        let fullDescription: String
+        if existingKeywords.isEmpty {
+            fullDescription = aiDescription
+        } else {
+            // AI keywords first (more accurate), then Vision keywords
+            let visionPart = existingKeywords.sorted().joined(separator: ", ")
+            fullDescription = aiDescription + "; also: " + visionPart
+        }
 
-                // Recompute embedding with the richer description
-                let newEmbedding = self.searchEngine.computeEmbedding(for: fullDescription)
-
-                // Capture as let for concurrency safety
-                let finalKeywords = mergedKeywords
-
-                // Update the clip on the main thread
-                await MainActor.run {
-                    if let index = self.indexedClips.firstIndex(where: { $0.id == clipID }) {
-                        self.indexedClips[index].keywords = finalKeywords
-                        self.indexedClips[index].description = fullDescription
-                        self.indexedClips[index].embedding = newEmbedding
-                        print("[ClipManager] Enhanced clip \(clipID.uuidString.prefix(8)) with \(aiKeywords.count) AI keywords")
-                    } else {
-                        print("[ClipManager] Clip \(clipID.uuidString.prefix(8)) was pruned before enhancement arrived")
-                    }
-                }
-            } catch {
-                print("[ClipManager] Vision enhancement failed: \(error.localizedDescription)")
+        // Recompute embedding with the richer description
+        let newEmbedding = searchEngine.computeEmbedding(for: fullDescription)
+
+        // Capture as let for concurrency safety
+        let finalKeywords = mergedKeywords
+
+        // Update the clip on the main thread
+        DispatchQueue.main.async {
+            let updated = self.indexedClips.update(clipID) { clip in
+                clip.keywords = finalKeywords
+                clip.description = fullDescription
+                clip.hasEmbedding = newEmbedding != nil
+            }
+            if let clip = updated {
+                self.searchEngine.index(clip, embedding: newEmbedding)
+                self.indexStore.update(clip, embedding: newEmbedding)
+                print("[ClipManager] Enhanced clip \(clipID.uuidString.prefix(8)) with \(aiKeywords.count) AI keywords")
+            } else {
+                print("[ClipManager] Clip \(clipID.uuidString.prefix(8)) was pruned before enhancement arrived")
             }
+            self.enhancementStats = self.enhancementQueue.stats
         }
     }
 
     // MARK: - Cleanup
 
     private func pruneOldClips() {
-        let cutoff = Date().addingTimeInterval(-maxHistory)
-        let expired = indexedClips.filter { $0.endTime < cutoff }
-        for clip in expired {
-            try? FileManager.default.removeItem(at: clip.fileURL)
+        // The recorder deletes video files after `maxHistory`, while the
+        // searchable index keeps clips for `maxIndexHistory`.
+        let cutoff = Date().addingTimeInterval(-maxIndexHistory)
+        let expired = indexedClips.removeClips(endingBefore: cutoff)
+        if !expired.isEmpty {
+            indexStore.remove(expired)
+            searchEngine.pruneIndex(before: cutoff)
         }
-        indexedClips.removeAll { $0.endTime < cutoff }
         clipCount = indexedClips.count
     }
 
-    private func cleanupAllClips() {
-        guard let files = try? FileManager.default.contentsOfDirectory(
-            at: clipsDirectory, includingPropertiesForKeys: nil
-        ) else { return }
-        for file in files {
-            try? FileManager.default.removeItem(at: file)
+    // MARK: - Persistence
+
+    /// Reload the searchable history from disk. Opening reads only the fixed-size
+    /// records, so the restored (older) clips are placed ahead of any recorded
+    /// since launch right away; their keywords and vectors are then indexed
+    /// off the main thread, newest first, and move from the mapped scan into
+    /// the in-memory index as that completes.
+    private func restoreIndex() {
+        DispatchQueue.global(qos: .userInitiated).async { [weak self] in
+            guard let self = self else { return }
+            let start = Date()
+            let restored = self.indexStore.load(videoDirectory: self.clipsDirectory)
+            let opened = Int(Date().timeIntervalSince(start) * 1000)
+
+            DispatchQueue.main.async {
+                self.indexedClips = ClipStore(restored.clips + self.indexedClips)
+                self.clipCount = self.indexedClips.count
+                print("[ClipManager] Reopened \(restored.clips.count) clip(s) from disk in \(opened) ms")
+            }
+
+            self.searchEngine.restore(restored.clips, vectors: restored.vectors)
+            let indexed = Int(Date().timeIntervalSince(start) * 1000)
+
+            DispatchQueue.main.async {
+                self.pruneOldClips()
+                print("[ClipManager] Indexed restored clips in \(indexed) ms")
+            }
         }
     }
 }
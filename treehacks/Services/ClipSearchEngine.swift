@@ -4,19 +4,37 @@
 //
 //  Uses Apple's Natural Language sentence embedding model to perform
 //  semantic search over indexed video clip descriptions.
-//  All NLEmbedding access is confined to a single serial queue to avoid
-//  EXC_BAD_ACCESS (NLEmbedding is not thread-safe).
-//  Falls back to keyword matching when embeddings are unavailable.
+//  Embeddings come from an `EmbeddingService` pool whose workers each own
+//  an NLEmbedding (it is not thread-safe); search queries take its
+//  interactive lane so they never wait behind clip indexing.
+//  Clip vectors are kept pre-normalized in a pluggable `VectorIndex`:
+//  an int8-quantized HNSW graph by default, a flat quantized scan, or the
+//  exact Float32 `EmbeddingMatrix`, one per hour of history in a
+//  `TimePartitionedIndex`. Clips restored from the on-disk
+//  `ClipIndexStore` are decoded into it in the background, newest first,
+//  and searched straight from its memory mapping until they are.
+//  `findTopClips` ranks embedding similarity and BM25 keyword relevance
+//  together in one pass and fuses them, so an exact keyword or OCR hit
+//  can beat a slightly closer embedding. Time phrases in the query
+//  ("10 minutes ago", "this morning") restrict the search to that range.
 //
 
 import Foundation
-import NaturalLanguage
 
 /// Result of a clip search, including debug info.
 struct ClipSearchResult {
     let clip: IndexedClip
     let score: Double
-    let method: String  // "embedding", "keyword", or "recent"
+    let method: String  // "hybrid", "embedding", "keyword", or "recent"
+}
+
+/// How `findTopClips` combines its lexical and semantic rankings.
+enum RankFusion {
+    /// Sum of `1 / (k + rank)` over both rankings. Scale-free, so neither
+    /// signal needs calibrating against the other.
+    case reciprocalRank(k: Double)
+    /// `semantic × cosine + lexical × BM25 / best BM25`.
+    case weighted(semantic: Double, lexical: Double)
 }
 
 /// Max character count for embedding input to avoid edge-case crashes.
@@ -24,164 +42,420 @@ private let maxEmbeddingInputLength = 10_000
 
 final class ClipSearchEngine {
 
-    private let embedding: NLEmbedding?
-    /// Serial queue for all NLEmbedding usage (not thread-safe).
-    private let nlQueue = DispatchQueue(label: "com.treehacks.clipSearchEngine.nl", qos: .userInitiated)
-
-    init() {
-        // Create embedding on the queue that will use it so we never touch it from another thread.
-        embedding = nlQueue.sync { NLEmbedding.sentenceEmbedding(for: .english) }
+    private let embeddings: EmbeddingService
+
+    /// Hour-partitioned vector and keyword indexes over every indexed clip.
+    private var partitions: TimePartitionedIndex
+    /// Vectors of clips restored from disk while they are being moved into
+    /// `partitions`; nil once a restore has finished.
+    private var persistedVectors: PersistedClipVectors?
+    /// Restored clips ending at or before this are not in `partitions` yet.
+    private var persistedPendingEnd: Date?
+    /// Clips indexed since the restore began, whose persisted vector is stale.
+    private var supersededPersisted: Set<UUID> = []
+    /// Persisted vectors of clips ending before this have been pruned.
+    private var persistedCutoff: Date?
+    /// Guards the indexes above (mutated on main, read from search threads).
+    private let indexLock = NSLock()
+
+    /// Recent query vectors keyed by normalized query text. The same question often
+    /// arrives from several views and tool-call retries within seconds.
+    private var queryCache = LRUCache<String, [Float]>(capacity: 64)
+    private let queryCacheLock = NSLock()
+
+    /// Fusion rule for hybrid ranking.
+    let fusion: RankFusion
+    /// Candidates taken from each ranking before fusion.
+    private static let fusionDepth = 50
+    /// Restored clips indexed per hold of `indexLock`.
+    private static let restoreBatchSize = 512
+
+    /// - Parameters:
+    ///   - makeVectorIndex: Embedding backend, created for each hour of history. HNSW over
+    ///     int8 codes keeps queries fast and compact; return an `EmbeddingMatrix` for exact results.
+    ///   - fusion: How keyword and embedding rankings are combined.
+    ///   - embeddingWorkers: NLEmbedding instances to keep loaded; one is reserved for queries.
+    init(makeVectorIndex: @escaping () -> any VectorIndex = { HNSWIndex() },
+         fusion: RankFusion = .reciprocalRank(k: 60),
+         embeddingWorkers: Int = 2) {
+        partitions = TimePartitionedIndex(makeVectorIndex: makeVectorIndex)
+        self.fusion = fusion
+        embeddings = EmbeddingService(workerCount: embeddingWorkers)
     }
 
-    var isAvailable: Bool { embedding != nil }
+    var isAvailable: Bool { embeddings.isAvailable }
+
+    /// Length of the vectors returned by `computeEmbedding` (0 when unavailable).
+    var embeddingDimension: Int { embeddings.dimension }
+
+    /// Embedding queue depth and wait times, for debug display.
+    var embeddingMetrics: EmbeddingService.Metrics { embeddings.metrics }
 
     // MARK: - Embedding
 
-    /// Compute embedding vector for a text description. Safe to call from any thread.
-    func computeEmbedding(for text: String) -> [Double]? {
+    /// Compute embedding vector for a text description. Safe to call from any thread;
+    /// blocks until a worker has embedded it. Indexing uses the default background lane.
+    func computeEmbedding(for text: String, priority: EmbeddingService.Priority = .background) -> [Double]? {
         let trimmed = text.trimmingCharacters(in: .whitespacesAndNewlines)
         guard !trimmed.isEmpty, trimmed.count <= maxEmbeddingInputLength else { return nil }
-        return nlQueue.sync {
-            guard let embedding = embedding else { return nil }
-            return embedding.vector(for: trimmed)
+        return embeddings.vector(for: trimmed, priority: priority)
+    }
+
+    /// Unit-length embedding of a search query, computed on the interactive lane.
+    /// Repeated queries are served from an LRU cache without touching the embedding
+    /// workers. The query is embedded as typed and cached under its normalized
+    /// form, so variants of it reuse the first one's vector. Returns nil if the
+    /// query cannot be embedded.
+    func queryVector(for query: String) -> [Float]? {
+        let key = Self.normalizedQuery(query)
+        guard !key.isEmpty else { return nil }
+
+        queryCacheLock.lock()
+        let cached = queryCache.value(for: key)
+        queryCacheLock.unlock()
+        if let cached = cached {
+            return cached
         }
+
+        guard let raw = computeEmbedding(for: query, priority: .interactive),
+              let unit = VectorMath.normalized(raw) else { return nil }
+        queryCacheLock.lock()
+        queryCache.insert(unit, for: key)
+        queryCacheLock.unlock()
+        return unit
     }
 
-    // MARK: - Primary Search (Embedding)
+    /// Query-embedding cache counters, for debug display.
+    var queryCacheStats: (hits: Int, misses: Int) {
+        queryCacheLock.lock()
+        defer { queryCacheLock.unlock() }
+        return (queryCache.hits, queryCache.misses)
+    }
 
-    /// Find the best matching indexed clip using embedding similarity.
-    func findBestClipByEmbedding(for query: String, in clips: [IndexedClip]) -> ClipSearchResult? {
-        guard !clips.isEmpty else { return nil }
-        let queryVector: [Double]? = nlQueue.sync {
-            guard let embedding = embedding else { return nil }
-            let t = query.trimmingCharacters(in: .whitespacesAndNewlines)
-            guard !t.isEmpty, t.count <= maxEmbeddingInputLength else { return nil }
-            return embedding.vector(for: t)
-        }
-        guard let queryVector = queryVector else { return nil }
-
-        var bestClip: IndexedClip?
-        var bestScore: Double = -1.0
-
-        for clip in clips {
-            guard let clipVector = clip.embedding else { continue }
-            let score = Self.cosineSimilarity(queryVector, clipVector)
-            if score > bestScore {
-                bestScore = score
-                bestClip = clip
-            }
-        }
+    /// Lowercased, with whitespace collapsed and punctuation trimmed from both
+    /// ends, so "Where are my keys?" and "where are my keys" share a cache entry.
+    private static func normalizedQuery(_ query: String) -> String {
+        query.lowercased()
+            .components(separatedBy: .whitespacesAndNewlines)
+            .filter { !$0.isEmpty }
+            .joined(separator: " ")
+            .trimmingCharacters(in: .punctuationCharacters)
+    }
 
-        guard let clip = bestClip else { return nil }
-        return ClipSearchResult(clip: clip, score: bestScore, method: "embedding")
+    // MARK: - Index Maintenance
+
+    /// Add or refresh a clip in the vector and keyword indexes.
+    /// Call whenever a clip is created or its keywords, description or embedding change.
+    /// The index keeps its own quantized copy of `embedding`; a nil embedding removes the vector.
+    func index(_ clip: IndexedClip, embedding: [Double]?) {
+        let unit = embedding.flatMap { VectorMath.normalized($0) }
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        if persistedVectors != nil {
+            supersededPersisted.insert(clip.id)
+        }
+        partitions.upsert(id: clip.id, endTime: clip.endTime, keywords: clip.keywords,
+                     description: clip.description, unitVector: unit)
     }
 
-    // MARK: - Fallback Search (Keyword)
+    /// Drop expired history. Whole hour partitions ending before `cutoff` are
+    /// released at once, and the expired clips of the one straddling it are
+    /// removed individually, so the index holds the same clips as the store.
+    func pruneIndex(before cutoff: Date) {
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        partitions.removeClips(endingBefore: cutoff)
+        if persistedVectors != nil {
+            persistedCutoff = max(persistedCutoff ?? cutoff, cutoff)
+        }
+    }
 
-    /// Find the best matching clip by counting keyword overlaps with the query.
-    func findBestClipByKeyword(for query: String, in clips: [IndexedClip]) -> ClipSearchResult? {
-        guard !clips.isEmpty else { return nil }
-
-        let queryWords = Set(
-            query.lowercased()
-                .components(separatedBy: .whitespacesAndNewlines)
-                .flatMap { $0.components(separatedBy: .punctuationCharacters) }
-                .filter { $0.count > 2 }  // Skip tiny words
-        )
-
-        guard !queryWords.isEmpty else { return nil }
-
-        var bestClip: IndexedClip?
-        var bestScore: Double = 0
-
-        for clip in clips {
-            let clipWords = Set(
-                clip.keywords
-                    .flatMap { $0.lowercased().components(separatedBy: .whitespacesAndNewlines) }
-                    .flatMap { $0.components(separatedBy: .punctuationCharacters) }
-                    .filter { $0.count > 2 }
-            )
-
-            // Also include description words
-            let descWords = Set(
-                clip.description.lowercased()
-                    .components(separatedBy: .whitespacesAndNewlines)
-                    .flatMap { $0.components(separatedBy: .punctuationCharacters) }
-                    .filter { $0.count > 2 }
-            )
-
-            let allClipWords = clipWords.union(descWords)
-            let overlap = queryWords.intersection(allClipWords)
-            let score = Double(overlap.count) / Double(queryWords.count)
-
-            if score > bestScore {
-                bestScore = score
-                bestClip = clip
+    /// Register clips restored from the persistent index. Their keywords and
+    /// persisted vectors are decoded from the mapping and indexed in memory in
+    /// batches, newest first, releasing the lock in between so searches are not
+    /// held up by a large history. Until a clip's batch is in, its vector is
+    /// scanned from `vectors`.
+    func restore(_ clips: [IndexedClip], vectors: PersistedClipVectors?) {
+        indexLock.lock()
+        persistedVectors = vectors
+        persistedPendingEnd = clips.last?.endTime
+        supersededPersisted = []
+        persistedCutoff = nil
+        indexLock.unlock()
+
+        var end = clips.endIndex
+        while end > clips.startIndex {
+            let start = max(clips.startIndex, end - Self.restoreBatchSize)
+            let batch = clips[start..<end].map { clip in
+                (clip, clip.hasEmbedding ? vectors?.unitVector(for: clip.id) : nil)
+            }
+            indexLock.lock()
+            for (clip, unit) in batch {
+                // Re-indexed since launch, or already pruned.
+                if supersededPersisted.contains(clip.id) { continue }
+                if let cutoff = persistedCutoff, clip.endTime < cutoff { continue }
+                partitions.upsert(id: clip.id, endTime: clip.endTime, keywords: clip.keywords,
+                                  description: clip.description, unitVector: unit)
             }
+            persistedPendingEnd = start > clips.startIndex ? clips[start - 1].endTime : nil
+            indexLock.unlock()
+            end = start
         }
 
-        guard let clip = bestClip, bestScore > 0 else { return nil }
-        return ClipSearchResult(clip: clip, score: bestScore, method: "keyword")
+        indexLock.lock()
+        persistedVectors = nil
+        persistedPendingEnd = nil
+        supersededPersisted = []
+        persistedCutoff = nil
+        indexLock.unlock()
     }
 
-    // MARK: - Combined Search (with fallbacks)
+    /// Nearest vectors ending within `range` across the in-memory index and the
+    /// restored clips not yet moved into it, best first. Caller must hold `indexLock`.
+    private func vectorHits(_ unitQuery: [Float], k: Int, in range: DateInterval?) -> [TimePartitionedIndex.Hit] {
+        var hits = partitions.search(unitQuery, k: k, in: range)
+        guard let persisted = persistedVectors, let pendingEnd = persistedPendingEnd else { return hits }
+        let unrestored = DateInterval(start: .distantPast, end: pendingEnd)
+        guard let pending = range.map({ $0.intersection(with: unrestored) }) ?? unrestored else { return hits }
+
+        let found = Set(hits.map(\.id))
+        for (hit, endTime) in persisted.search(unitQuery, k: k, in: pending, excluding: supersededPersisted) {
+            if let cutoff = persistedCutoff, endTime < cutoff { continue }
+            guard !found.contains(hit.id) else { continue }
+            hits.append(TimePartitionedIndex.Hit(id: hit.id, endTime: endTime, score: Double(hit.score)))
+        }
+        hits.sort { $0.score > $1.score }
+        return hits
+    }
 
-    /// Search using embedding first, then keyword fallback, then most recent clip.
-    /// Always returns a result if there are any clips available.
-    func findBestClip(for query: String, in clips: [IndexedClip]) -> ClipSearchResult? {
-        guard !clips.isEmpty else { return nil }
+    /// `range` narrowed to the end times `clips` spans, so the index is not asked
+    /// for clips indexed since the snapshot was taken. Nil when they do not overlap.
+    private static func snapshotRange(_ range: DateInterval?, of clips: ClipStore) -> DateInterval? {
+        guard let oldest = clips.first?.endTime, let newest = clips.last?.endTime else { return nil }
+        let span = DateInterval(start: oldest, end: max(oldest, newest))
+        guard let range = range else { return span }
+        return range.intersection(with: span)
+    }
 
-        // Try embedding search first
-        if let result = findBestClipByEmbedding(for: query, in: clips) {
-            return result
+    /// Nearest indexed clips to `query` that ended within `range` and are present
+    /// in `clips`, best first. The search is limited to the snapshot's time span,
+    /// so nearly every hit is in it. Returns nil if the query could not be embedded.
+    private func embeddingHits(for query: String, k: Int, in clips: ClipStore,
+                               during range: DateInterval?) -> [(clip: IndexedClip, score: Double)]? {
+        guard let unitQuery = queryVector(for: query) else { return nil }
+        guard let range = Self.snapshotRange(range, of: clips) else { return [] }
+
+        let k = min(k, clips.count)
+        indexLock.lock()
+        let hits = vectorHits(unitQuery, k: k, in: range)
+        indexLock.unlock()
+
+        var results: [(clip: IndexedClip, score: Double)] = []
+        for hit in hits {
+            guard let clip = clips[id: hit.id] else { continue }
+            results.append((clip, hit.score))
+            if results.count == k { break }
         }
+        return results
+    }
+
+    // MARK: - Primary Search (Embedding)
+
+    /// Find the `k` best matching clips using embedding similarity, best first,
+    /// optionally only clips that ended within `range`.
+    /// Clips must have been registered with `index(_:)`.
+    func findTopClipsByEmbedding(for query: String, k: Int, in clips: ClipStore,
+                                 during range: DateInterval? = nil) -> [ClipSearchResult] {
+        guard !clips.isEmpty, k > 0 else { return [] }
+
+        let hits = embeddingHits(for: query, k: k, in: clips, during: range) ?? []
+        return hits.map { ClipSearchResult(clip: $0.clip, score: $0.score, method: "embedding") }
+    }
+
+    /// Find the best matching indexed clip using embedding similarity.
+    func findBestClipByEmbedding(for query: String, in clips: ClipStore) -> ClipSearchResult? {
+        findTopClipsByEmbedding(for: query, k: 1, in: clips).first
+    }
+
+    // MARK: - Fallback Search (Keyword)
 
-        // Fallback to keyword matching
-        if let result = findBestClipByKeyword(for: query, in: clips) {
-            return result
+    /// Find the `k` clips with the most keyword overlap with the query, best first,
+    /// optionally only clips that ended within `range`. Clips with no overlap are
+    /// never returned. Only the posting lists of the query's terms in the hours
+    /// overlapping `range` are visited; clips must have been registered with `index(_:)`.
+    func findTopClipsByKeyword(for query: String, k: Int, in clips: ClipStore,
+                               during range: DateInterval? = nil) -> [ClipSearchResult] {
+        guard !clips.isEmpty, k > 0 else { return [] }
+
+        let queryWords = KeywordIndex.terms(in: query)
+        guard !queryWords.isEmpty else { return [] }
+
+        indexLock.lock()
+        let matches = partitions.matchCounts(for: queryWords, in: range)
+        indexLock.unlock()
+
+        var selector = TopKSelector<IndexedClip>(k: k)
+        for match in matches {
+            guard let clip = clips[id: match.id] else { continue }
+            selector.insert(clip, score: match.score / Double(queryWords.count))
         }
 
-        // Last resort: return the most recent clip
-        if let mostRecent = clips.max(by: { $0.endTime < $1.endTime }) {
-            return ClipSearchResult(clip: mostRecent, score: 0, method: "recent")
+        return selector.sortedDescending().map {
+            ClipSearchResult(clip: $0.element, score: $0.score, method: "keyword")
         }
+    }
 
-        return nil
+    /// Find the best matching clip by counting keyword overlaps with the query.
+    func findBestClipByKeyword(for query: String, in clips: ClipStore) -> ClipSearchResult? {
+        findTopClipsByKeyword(for: query, k: 1, in: clips).first
     }
 
-    // MARK: - Debug: Score all clips
+    // MARK: - Combined Search (hybrid, with fallback)
+
+    /// Fuse the embedding and BM25 rankings of the clips in `clips` that ended
+    /// within `range`, best first. Both signals come from index lookups under one
+    /// lock: the vector search plus the query terms' posting lists. Lexical matches
+    /// the vector search missed are scored against their stored vectors, in the
+    /// partitions or, for restored clips not moved there yet, in the mapping, so
+    /// every candidate is ranked on both signals.
+    private func hybridResults(for query: String, k: Int, in clips: ClipStore,
+                               during range: DateInterval?) -> [ClipSearchResult] {
+        let queryTerms = KeywordIndex.terms(in: query)
+        let unitQuery = queryVector(for: query)
+        guard unitQuery != nil || !queryTerms.isEmpty,
+              let range = Self.snapshotRange(range, of: clips) else { return [] }
+
+        let depth = max(k, Self.fusionDepth)
+        var semantic: [UUID: Double] = [:]
+        var lexical: [UUID: Double] = [:]
+        var endTimes: [UUID: Date] = [:]
+
+        indexLock.lock()
+        if !queryTerms.isEmpty {
+            var best = TopKSelector<TimePartitionedIndex.Hit>(k: depth)
+            for hit in partitions.bm25Scores(for: queryTerms, in: range) {
+                best.insert(hit, score: hit.score)
+            }
+            for match in best.sortedDescending() {
+                lexical[match.element.id] = match.score
+                endTimes[match.element.id] = match.element.endTime
+            }
+        }
+        if let unitQuery = unitQuery {
+            for hit in vectorHits(unitQuery, k: depth, in: range) where semantic[hit.id] == nil {
+                semantic[hit.id] = hit.score
+                endTimes[hit.id] = hit.endTime
+            }
+            let unscored = lexical.keys.filter { semantic[$0] == nil }.compactMap { id in
+                endTimes[id].map { (id: id, endTime: $0) }
+            }
+            for (id, score) in partitions.similarities(of: unscored, to: unitQuery) {
+                semantic[id] = Double(score)
+            }
+            // Restored clips whose vector is still only in the mapping.
+            if let persisted = persistedVectors {
+                let pending = unscored.map(\.id).filter { semantic[$0] == nil && !supersededPersisted.contains($0) }
+                for (id, score) in zip(pending, persisted.similarities(of: pending, to: unitQuery)) {
+                    if let score = score {
+                        semantic[id] = Double(score)
+                    }
+                }
+            }
+        }
+        indexLock.unlock()
+
+        let semanticRank = Self.ranks(semantic)
+        let lexicalRank = Self.ranks(lexical)
+        let bestLexical = lexical.values.max() ?? 0
+        let method = semantic.isEmpty ? "keyword" : (lexical.isEmpty ? "embedding" : "hybrid")
+
+        var selector = TopKSelector<IndexedClip>(k: k)
+        for id in endTimes.keys {
+            guard let clip = clips[id: id] else { continue }
+            let score: Double
+            switch fusion {
+            case .reciprocalRank(let c):
+                score = (semanticRank[id].map { 1 / (c + Double($0)) } ?? 0)
+                      + (lexicalRank[id].map { 1 / (c + Double($0)) } ?? 0)
+            case .weighted(let semanticWeight, let lexicalWeight):
+                let normalizedLexical = bestLexical > 0 ? (lexical[id] ?? 0) / bestLexical : 0
+                score = semanticWeight * (semantic[id] ?? 0) + lexicalWeight * normalizedLexical
+            }
+            selector.insert(clip, score: score)
+        }
+        return selector.sortedDescending().map {
+            ClipSearchResult(clip: $0.element, score: $0.score, method: method)
+        }
+    }
 
-    /// Score every clip against a query for debug display.
-    func scoreAllClips(for query: String, in clips: [IndexedClip]) -> [(clip: IndexedClip, score: Double)] {
-        let queryVector: [Double]? = nlQueue.sync {
-            guard let embedding = embedding else { return nil }
-            let t = query.trimmingCharacters(in: .whitespacesAndNewlines)
-            guard !t.isEmpty, t.count <= maxEmbeddingInputLength else { return nil }
-            return embedding.vector(for: t)
+    /// 1-based rank of each ID by descending score.
+    private static func ranks(_ scores: [UUID: Double]) -> [UUID: Int] {
+        var result: [UUID: Int] = [:]
+        result.reserveCapacity(scores.count)
+        for (rank, entry) in scores.sorted(by: { $0.value > $1.value }).enumerated() {
+            result[entry.key] = rank + 1
         }
-        guard let queryVector = queryVector else {
-            return clips.map { ($0, 0.0) }
+        return result
+    }
+
+    /// Return up to `k` candidates, best first: the fused embedding and keyword
+    /// ranking, else the most recent clips. A time phrase in the query limits both
+    /// to clips that ended in that range when it has any. Non-empty whenever `clips` is.
+    func findTopClips(for query: String, k: Int, in clips: ClipStore) -> [ClipSearchResult] {
+        guard !clips.isEmpty, k > 0 else { return [] }
+
+        let temporal = TemporalQuery(query)
+        let results = hybridResults(for: temporal.text, k: k, in: clips, during: temporal.range)
+        if !results.isEmpty {
+            return results
         }
 
-        return clips.map { clip in
-            guard let clipVector = clip.embedding else { return (clip, 0.0) }
-            let score = Self.cosineSimilarity(queryVector, clipVector)
-            return (clip, score)
+        // Last resort: the most recent clips, within the asked-for range if any ended in it.
+        // The store is ordered by end time, so walk back from the newest.
+        var recent: [IndexedClip] = []
+        if let range = temporal.range {
+            for clip in clips.reversed() {
+                if clip.endTime < range.start || recent.count == k { break }
+                if clip.endTime <= range.end { recent.append(clip) }
+            }
         }
-        .sorted { $0.score > $1.score }
+        if recent.isEmpty {
+            recent = Array(clips.suffix(k).reversed())
+        }
+        return recent.map { ClipSearchResult(clip: $0, score: 0, method: "recent") }
+    }
+
+    /// Search with hybrid embedding + keyword ranking, falling back to the most recent clip.
+    /// Always returns a result if there are any clips available.
+    func findBestClip(for query: String, in clips: ClipStore) -> ClipSearchResult? {
+        findTopClips(for: query, k: 1, in: clips).first
+    }
+
+    /// Candidates `findBestPlayableClip` looks through for one with video.
+    static let playbackCandidates = 10
+
+    /// Like `findBestClip`, but for playing back: the best of the top candidates
+    /// whose video is still on disk, else the best match, whose video is gone.
+    func findBestPlayableClip(for query: String, in clips: ClipStore) -> ClipSearchResult? {
+        Self.bestForPlayback(findTopClips(for: query, k: Self.playbackCandidates, in: clips))
+    }
+
+    /// The first of `results` (best first) whose video still exists, else the first.
+    static func bestForPlayback(_ results: [ClipSearchResult]) -> ClipSearchResult? {
+        results.first { $0.clip.hasVideo } ?? results.first
     }
 
-    // MARK: - Math
+    // MARK: - Debug: Score clips
 
-    private static func cosineSimilarity(_ a: [Double], _ b: [Double]) -> Double {
-        guard a.count == b.count else { return 0 }
-        var dot: Double = 0, normA: Double = 0, normB: Double = 0
-        for i in 0..<a.count {
-            dot += a[i] * b[i]
-            normA += a[i] * a[i]
-            normB += b[i] * b[i]
+    /// Score clips against a query for debug display, highest first, honouring
+    /// any time phrase in it. Only the top `limit` clips are selected and sorted.
+    func scoreAllClips(for query: String, in clips: ClipStore, limit: Int = .max) -> [(clip: IndexedClip, score: Double)] {
+        let k = min(limit, clips.count)
+        guard k > 0 else { return [] }
+        let temporal = TemporalQuery(query)
+        guard let hits = embeddingHits(for: temporal.text, k: k, in: clips, during: temporal.range) else {
+            return clips.prefix(k).map { ($0, 0.0) }
         }
-        let denom = sqrt(normA) * sqrt(normB)
-        return denom > 0 ? dot / denom : 0
+        return hits
     }
 }
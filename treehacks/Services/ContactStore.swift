@@ -29,6 +29,11 @@ class ContactStore: ObservableObject {
                 let data = try Data(contentsOf: fileURL)
                 let payloads = try JSONDecoder().decode([PersonPayload].self, from: data)
                 contacts = payloads.map { $0.toPerson() }
+                // Rewrite face embeddings stored in an older descriptor layout.
+                if payloads.contains(where: \.needsDescriptorMigration) {
+                    print("[ContactStore] Migrating face embeddings to descriptor v\(FaceDescriptor.version)")
+                    saveContacts()
+                }
             } catch {
                 print("[ContactStore] Failed to load from disk: \(error). Falling back to bundle.")
                 contacts = PersonLoader.loadFromBundle(filename: nil)
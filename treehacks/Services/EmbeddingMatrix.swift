@@ -0,0 +1,113 @@
+//
+//  EmbeddingMatrix.swift
+//  treehacks
+//
+//  Contiguous, row-major Float32 store of L2-normalized clip vectors.
+//  Scoring a query against every clip is a single matrix-vector product
+//  instead of a per-clip loop over separate [Double] arrays. This is the
+//  exact `VectorIndex`, and the ground truth for approximate ones.
+//
+
+import Foundation
+
+struct EmbeddingMatrix: VectorIndex {
+
+    /// Vector length shared by every row (0 while empty).
+    private(set) var dimension = 0
+
+    /// `count × dimension` floats, one pre-normalized vector per row.
+    private(set) var storage: [Float] = []
+
+    /// Clip ID owning each row.
+    private(set) var rowIDs: [UUID] = []
+
+    private var rowByID: [UUID: Int] = [:]
+
+    var count: Int { rowIDs.count }
+
+    func row(for id: UUID) -> Int? {
+        rowByID[id]
+    }
+
+    // MARK: - Mutation
+
+    /// Insert or replace the unit-length vector for `id`.
+    /// Returns false if the vector is empty or the wrong dimension.
+    @discardableResult
+    mutating func upsert(_ unit: [Float], for id: UUID) -> Bool {
+        guard !unit.isEmpty else { return false }
+        if count == 0 { dimension = unit.count }
+        guard unit.count == dimension else { return false }
+
+        if let row = rowByID[id] {
+            storage.replaceSubrange(row * dimension..<(row + 1) * dimension, with: unit)
+        } else {
+            rowByID[id] = rowIDs.count
+            rowIDs.append(id)
+            storage.append(contentsOf: unit)
+        }
+        return true
+    }
+
+    /// Remove the row for `id`, moving the last row into its place to keep storage dense.
+    mutating func remove(_ id: UUID) {
+        guard let row = rowByID.removeValue(forKey: id) else { return }
+        let last = rowIDs.count - 1
+        if row != last {
+            let movedID = rowIDs[last]
+            rowIDs[row] = movedID
+            rowByID[movedID] = row
+            let dim = dimension
+            storage.withUnsafeMutableBufferPointer { buffer in
+                let base = buffer.baseAddress!
+                (base + row * dim).update(from: base + last * dim, count: dim)
+            }
+        }
+        rowIDs.removeLast()
+        storage.removeLast(dimension)
+    }
+
+    // MARK: - Scoring
+
+    /// Cosine similarity of a unit-length `query` against every row, in row order.
+    /// Returns an empty array if the query dimension does not match.
+    func scores(for query: [Float]) -> [Float] {
+        guard count > 0, query.count == dimension else { return [] }
+        let rows = count
+        let columns = dimension
+        var out = [Float](repeating: 0, count: rows)
+        storage.withUnsafeBufferPointer { matrix in
+            query.withUnsafeBufferPointer { vector in
+                out.withUnsafeMutableBufferPointer { result in
+                    VectorMath.gemv(
+                        matrix.baseAddress!, rows: rows, columns: columns,
+                        vector.baseAddress!, into: result.baseAddress!
+                    )
+                }
+            }
+        }
+        return out
+    }
+
+    /// Exact top-`k` by full scan.
+    func search(_ unitQuery: [Float], k: Int) -> [VectorHit] {
+        let rowScores = scores(for: unitQuery)
+        var selector = TopKSelector<UUID>(k: k)
+        for (row, score) in rowScores.enumerated() {
+            selector.insert(rowIDs[row], score: Double(score))
+        }
+        return selector.sortedDescending().map { VectorHit(id: $0.element, score: Float($0.score)) }
+    }
+
+    func similarities(of ids: [UUID], to unitQuery: [Float]) -> [Float?] {
+        guard unitQuery.count == dimension else { return ids.map { _ in nil } }
+        let dim = dimension
+        return storage.withUnsafeBufferPointer { matrix in
+            unitQuery.withUnsafeBufferPointer { q in
+                ids.map { id in
+                    rowByID[id].map { VectorMath.dot(matrix.baseAddress! + $0 * dim, q.baseAddress!, count: dim) }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,207 @@
+//
+//  EmbeddingService.swift
+//  treehacks
+//
+//  Small pool of sentence-embedding workers. NLEmbedding is not
+//  thread-safe, so each worker thread loads and owns its own instance and
+//  no instance is ever touched from another thread. Requests wait in two
+//  lanes: interactive (a user is waiting on a search) is always served
+//  first, and one worker only ever takes interactive work, so a query
+//  never queues behind a burst of clip indexing.
+//
+
+import Foundation
+import NaturalLanguage
+
+final class EmbeddingService {
+
+    enum Priority {
+        /// A user is waiting on the result (search queries).
+        case interactive
+        /// Clip indexing and re-embedding after vision enhancement.
+        case background
+    }
+
+    /// Counters for one lane.
+    struct LaneMetrics {
+        /// Requests waiting for a worker right now.
+        var queued = 0
+        /// Requests a worker has taken.
+        var served = 0
+        /// Time served requests spent queued before a worker took them.
+        var totalWait: TimeInterval = 0
+        var maxWait: TimeInterval = 0
+
+        var averageWait: TimeInterval {
+            served > 0 ? totalWait / Double(served) : 0
+        }
+    }
+
+    struct Metrics {
+        var interactive = LaneMetrics()
+        var background = LaneMetrics()
+        /// Workers currently computing an embedding.
+        var busyWorkers = 0
+    }
+
+    /// Vector length (0 when the model is unavailable).
+    let dimension: Int
+    var isAvailable: Bool { dimension > 0 }
+
+    private let scheduler = Scheduler()
+
+    /// - Parameter workerCount: Embedding instances to load. With more than one,
+    ///   the first is reserved for interactive requests.
+    init(workerCount: Int = 2, language: NLLanguage = .english) {
+        let count = max(1, workerCount)
+        let loaded = DispatchSemaphore(value: 0)
+        var firstDimension = 0
+
+        for i in 0..<count {
+            let scheduler = self.scheduler
+            let acceptsBackground = count == 1 || i > 0
+            let thread = Thread {
+                let embedding = NLEmbedding.sentenceEmbedding(for: language)
+                if i == 0 {
+                    firstDimension = embedding?.dimension ?? 0
+                    loaded.signal()
+                }
+                while let request = scheduler.next(acceptsBackground: acceptsBackground) {
+                    request.result = embedding?.vector(for: request.text)
+                    scheduler.finish()
+                    request.done.signal()
+                }
+            }
+            thread.name = "com.treehacks.embedding.\(i)"
+            thread.qualityOfService = .userInitiated
+            thread.start()
+        }
+
+        // Only the first model load blocks; the others finish in the background.
+        loaded.wait()
+        dimension = firstDimension
+        if dimension == 0 {
+            scheduler.close()
+        }
+    }
+
+    deinit {
+        scheduler.close()
+    }
+
+    /// Embed `text` on the next free worker, blocking until done. Safe to call
+    /// from any thread. Returns nil if the model is unavailable or has no vector.
+    func vector(for text: String, priority: Priority) -> [Double]? {
+        guard isAvailable else { return nil }
+        let request = Request(text: text)
+        guard scheduler.enqueue(request, priority: priority) else { return nil }
+        request.done.wait()
+        return request.result
+    }
+
+    var metrics: Metrics {
+        scheduler.metrics
+    }
+}
+
+// MARK: - Scheduling
+
+private final class Request {
+    let text: String
+    let enqueued = DispatchTime.now().uptimeNanoseconds
+    /// Written by the worker before `done` is signalled.
+    var result: [Double]?
+    let done = DispatchSemaphore(value: 0)
+
+    init(text: String) {
+        self.text = text
+    }
+}
+
+/// The two request lanes, shared by the workers.
+private final class Scheduler {
+
+    private let condition = NSCondition()
+    private var interactive: [Request] = []
+    private var background: [Request] = []
+    private var state = EmbeddingService.Metrics()
+    private var isClosed = false
+
+    var metrics: EmbeddingService.Metrics {
+        condition.lock()
+        defer { condition.unlock() }
+        return state
+    }
+
+    /// Returns false once closed.
+    func enqueue(_ request: Request, priority: EmbeddingService.Priority) -> Bool {
+        condition.lock()
+        defer { condition.unlock() }
+        guard !isClosed else { return false }
+        switch priority {
+        case .interactive:
+            interactive.append(request)
+            state.interactive.queued += 1
+        case .background:
+            background.append(request)
+            state.background.queued += 1
+        }
+        condition.broadcast()
+        return true
+    }
+
+    /// Block until there is work for this worker; nil once closed.
+    func next(acceptsBackground: Bool) -> Request? {
+        condition.lock()
+        defer { condition.unlock() }
+        while true {
+            if !interactive.isEmpty {
+                let request = interactive.removeFirst()
+                Self.record(request, in: &state.interactive)
+                state.busyWorkers += 1
+                return request
+            }
+            if acceptsBackground, !background.isEmpty {
+                let request = background.removeFirst()
+                Self.record(request, in: &state.background)
+                state.busyWorkers += 1
+                return request
+            }
+            if isClosed {
+                return nil
+            }
+            condition.wait()
+        }
+    }
+
+    /// Called by a worker when its current request is done.
+    func finish() {
+        condition.lock()
+        state.busyWorkers -= 1
+        condition.unlock()
+    }
+
+    func close() {
+        condition.lock()
+        isClosed = true
+        // Fail anything still queued rather than leave callers blocked.
+        for request in interactive + background {
+            request.done.signal()
+        }
+        interactive = []
+        background = []
+        state.interactive.queued = 0
+        state.background.queued = 0
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    /// Count `request` as taken from `lane`. Caller holds `condition`.
+    private static func record(_ request: Request, in lane: inout EmbeddingService.LaneMetrics) {
+        let wait = Double(DispatchTime.now().uptimeNanoseconds - request.enqueued) / 1e9
+        lane.queued -= 1
+        lane.served += 1
+        lane.totalWait += wait
+        lane.maxWait = max(lane.maxWait, wait)
+    }
+}
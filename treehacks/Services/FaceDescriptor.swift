@@ -0,0 +1,230 @@
+//
+//  FaceDescriptor.swift
+//  treehacks
+//
+//  Versioned, fixed-layout face feature vector. Every landmark region and
+//  geometric measure has its own slots at a fixed offset, with a presence
+//  bit in `mask`; a region Vision omits leaves zeros instead of shifting
+//  everything after it. Any two descriptors therefore have the same
+//  length and compare through one fixed-stride kernel, with similarity
+//  restricted to the regions both have. `FaceFeatureBuilder` fills it,
+//  resampling regions to a fixed point count so the layout does not
+//  depend on Vision's constellation. Descriptors persist as plain
+//  `[Float]` (values, then the mask), and `init?(legacy:)` converts the
+//  variable-length vectors stored before. Foundation-only, so it builds
+//  and benchmarks off device.
+//
+
+import Foundation
+
+struct FaceDescriptor {
+
+    /// Layout version stored with contacts. 1 was the variable-length concatenation.
+    static let version = 2
+
+    /// Landmark regions in slot order, with the points each is resampled to
+    /// (the counts of Vision's default constellation).
+    enum Region: Int, CaseIterable {
+        case faceContour, leftEye, rightEye, leftEyebrow, rightEyebrow, nose
+        case noseCrest, medianLine, outerLips, innerLips, leftPupil, rightPupil
+
+        var pointCount: Int {
+            switch self {
+            case .faceContour: return 17
+            case .leftEye, .rightEye, .nose: return 8
+            case .leftEyebrow, .rightEyebrow, .noseCrest, .innerLips: return 6
+            case .medianLine: return 10
+            case .outerLips: return 14
+            case .leftPupil, .rightPupil: return 1
+            }
+        }
+    }
+
+    /// Geometric measures in slot order, after the regions.
+    enum Measure: Int, CaseIterable {
+        case eyeWidthRatio, pupilDistance, noseToMouth, faceAspect, mouthWidth
+    }
+
+    /// Regions then measures; one presence bit and one run of slots each.
+    static let segmentCount = Region.allCases.count + Measure.allCases.count
+    /// First slot and slot count of each segment.
+    static let segmentOffsets: [Int] = {
+        var offsets: [Int] = []
+        var offset = 0
+        for length in segmentLengths {
+            offsets.append(offset)
+            offset += length
+        }
+        return offsets
+    }()
+    static let segmentLengths: [Int] = Region.allCases.map { $0.pointCount * 2 } + Measure.allCases.map { _ in 1 }
+    /// Slots in use, and the stride padded to whole 8-float SIMD lanes.
+    static let usedLength = segmentLengths.reduce(0, +)
+    static let dimension = (usedLength + 7) / 8 * 8
+    /// Floats in the persisted form: the values, then the mask.
+    static let storedLength = dimension + 1
+    /// Every segment present.
+    static let fullMask: UInt32 = (1 << UInt32(segmentCount)) - 1
+
+    /// Fewest slots two descriptors must share, as a fraction of the used
+    /// length, for their similarity to mean anything.
+    static let minimumSharedFraction: Float = 0.5
+
+    /// `dimension` values; absent segments are zero.
+    private(set) var values: [Float]
+    /// Bit `i` set when segment `i` is present.
+    private(set) var mask: UInt32
+
+    static func bit(_ region: Region) -> UInt32 { 1 << UInt32(region.rawValue) }
+    static func bit(_ measure: Measure) -> UInt32 { 1 << UInt32(Region.allCases.count + measure.rawValue) }
+
+    // MARK: - Building
+
+    /// Build into a new descriptor's storage: `build` adds the regions that
+    /// are present to the builder, and absent ones stay zero.
+    init(_ build: (inout FaceFeatureBuilder) -> Void) {
+        var mask: UInt32 = 0
+        values = [Float](unsafeUninitializedCapacity: Self.dimension) { buffer, initializedCount in
+            var builder = FaceFeatureBuilder(writingInto: buffer.baseAddress!)
+            build(&builder)
+            mask = builder.finish()
+            initializedCount = Self.dimension
+        }
+        self.mask = mask
+    }
+
+    private mutating func set(_ measure: Measure, _ value: Float) {
+        values[Self.segmentOffsets[Region.allCases.count + measure.rawValue]] = value
+        mask |= Self.bit(measure)
+    }
+
+    // MARK: - Persistence
+
+    /// Decode the persisted form; nil if it is not a current-version descriptor.
+    init?(stored: [Float]) {
+        guard stored.count == Self.storedLength, let last = stored.last,
+              let mask = UInt32(exactly: last), mask & ~Self.fullMask == 0 else { return nil }
+        values = Array(stored.prefix(Self.dimension))
+        self.mask = mask
+    }
+
+    /// Persisted form: the values, then the mask (exact in a Float below 2^24).
+    var stored: [Float] {
+        values + [Float(mask)]
+    }
+
+    // MARK: - Migration
+
+    /// Convert a version-1 vector: the present regions' points concatenated in
+    /// slot order, then whichever measures their regions allowed. The length
+    /// identifies which regions were present; a length that several
+    /// combinations share, or none, cannot be converted.
+    init?(legacy: [Float]) {
+        guard let regionMask = Self.legacyLayouts[legacy.count] else { return nil }
+        values = [Float](repeating: 0, count: Self.dimension)
+        mask = 0
+        var cursor = 0
+        for region in Region.allCases where regionMask & Self.bit(region) != 0 {
+            let length = region.pointCount * 2
+            let offset = Self.segmentOffsets[region.rawValue]
+            values.replaceSubrange(offset..<offset + length, with: legacy[cursor..<cursor + length])
+            mask |= Self.bit(region)
+            cursor += length
+        }
+        for measure in Self.legacyMeasures(for: regionMask) {
+            set(measure, legacy[cursor])
+            cursor += 1
+        }
+    }
+
+    /// Measures a version-1 vector has for a set of regions, in order.
+    private static func legacyMeasures(for regionMask: UInt32) -> [Measure] {
+        func has(_ region: Region) -> Bool { regionMask & bit(region) != 0 }
+        var measures: [Measure] = []
+        if has(.leftEye) && has(.rightEye) { measures.append(.eyeWidthRatio) }
+        if has(.leftPupil) && has(.rightPupil) { measures.append(.pupilDistance) }
+        if has(.nose) && has(.outerLips) { measures.append(.noseToMouth) }
+        if has(.faceContour) { measures.append(.faceAspect) }
+        if has(.outerLips) { measures.append(.mouthWidth) }
+        return measures
+    }
+
+    /// Version-1 length → the only region set producing it.
+    private static let legacyLayouts: [Int: UInt32] = {
+        var layouts: [Int: UInt32] = [:]
+        var ambiguous = Set<Int>()
+        for regionMask in UInt32(1)..<(1 << UInt32(Region.allCases.count)) {
+            let points = Region.allCases.reduce(0) { $0 + (regionMask & bit($1) != 0 ? $1.pointCount : 0) }
+            let length = points * 2 + legacyMeasures(for: regionMask).count
+            if layouts[length] != nil {
+                ambiguous.insert(length)
+            }
+            layouts[length] = regionMask
+        }
+        for length in ambiguous {
+            layouts.removeValue(forKey: length)
+        }
+        return layouts
+    }()
+
+    // MARK: - Similarity
+
+    /// Slots covered by the segments in `mask`.
+    static func slotCount(of mask: UInt32) -> Int {
+        var bits = mask
+        var slots = 0
+        while bits != 0 {
+            slots += segmentLengths[bits.trailingZeroBitCount]
+            bits &= bits - 1
+        }
+        return slots
+    }
+
+    /// Sum of `segmentNorms` (squared norm per segment) over the segments in `mask`.
+    static func squaredNorm(_ segmentNorms: UnsafePointer<Float>, over mask: UInt32) -> Float {
+        var bits = mask
+        var sum: Float = 0
+        while bits != 0 {
+            sum += segmentNorms[bits.trailingZeroBitCount]
+            bits &= bits - 1
+        }
+        return sum
+    }
+
+    /// Write the unit-length values and their squared norm per segment.
+    /// Returns false for an all-zero descriptor.
+    func normalize(into unit: UnsafeMutablePointer<Float>, segmentNorms: UnsafeMutablePointer<Float>) -> Bool {
+        values.withUnsafeBufferPointer { Self.normalize($0.baseAddress!, into: unit, segmentNorms: segmentNorms) }
+    }
+
+    /// `normalize(into:segmentNorms:)` for `dimension` values built elsewhere;
+    /// `values` and `unit` may be the same buffer.
+    static func normalize(_ values: UnsafePointer<Float>, into unit: UnsafeMutablePointer<Float>,
+                          segmentNorms: UnsafeMutablePointer<Float>) -> Bool {
+        let magnitude = VectorMath.dot(values, values, count: dimension).squareRoot()
+        guard magnitude > 0 else { return false }
+        let scale = 1 / magnitude
+        for i in 0..<dimension {
+            unit[i] = values[i] * scale
+        }
+        for segment in 0..<segmentCount {
+            let start = unit + segmentOffsets[segment]
+            segmentNorms[segment] = VectorMath.dot(start, start, count: segmentLengths[segment])
+        }
+        return true
+    }
+
+    /// Cosine similarity of two unit descriptors' values over the segments both
+    /// have, from their full dot product (absent slots are zero, so it already
+    /// covers only shared segments) and per-segment squared norms. Nil when
+    /// they share too little to compare.
+    static func maskedSimilarity(dot: Float,
+                                 _ maskA: UInt32, _ normsA: UnsafePointer<Float>,
+                                 _ maskB: UInt32, _ normsB: UnsafePointer<Float>) -> Float? {
+        if maskA == maskB { return dot }
+        let shared = maskA & maskB
+        guard Float(slotCount(of: shared)) >= minimumSharedFraction * Float(usedLength) else { return nil }
+        let norm = (squaredNorm(normsA, over: shared) * squaredNorm(normsB, over: shared)).squareRoot()
+        return norm > 0 ? dot / norm : nil
+    }
+}
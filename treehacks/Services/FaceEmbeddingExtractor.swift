@@ -2,9 +2,9 @@
 //  FaceEmbeddingExtractor.swift
 //  treehacks
 //
-//  Extracts a face embedding from a static UIImage using the same landmark
-//  pipeline as FaceRecognitionModel so that enrolled embeddings are directly
-//  comparable to live-detected ones.
+//  Extracts a face embedding from a static UIImage. `descriptor(from:)` is
+//  also what FaceRecognitionModel uses for live faces, so enrolled
+//  embeddings are directly comparable to live-detected ones.
 //
 
 import Vision
@@ -18,7 +18,7 @@ enum FaceEmbeddingExtractor {
     /// The image's `imageOrientation` is forwarded to Vision so that
     /// landmarks are extracted in the correct coordinate space — matching
     /// the live-camera pipeline.
-    nonisolated static func extractEmbedding(from image: UIImage) -> [Float]? {
+    nonisolated static func extractEmbedding(from image: UIImage) -> FaceDescriptor? {
         guard let cgImage = image.cgImage else { return nil }
 
         // Map UIImage orientation → CGImagePropertyOrientation so Vision
@@ -46,51 +46,45 @@ enum FaceEmbeddingExtractor {
             return nil
         }
 
-        // --- Build the feature vector (must mirror FaceRecognitionModel) ---
-
-        var features: [Float] = []
+        guard let descriptor = descriptor(from: landmarks) else { return nil }
+        print("[FaceEmbeddingExtractor] Extracted descriptor with \(descriptor.mask.nonzeroBitCount)/\(FaceDescriptor.segmentCount) features")
+        return descriptor
+    }
 
-        if let faceContour = landmarks.faceContour {
-            features.append(contentsOf: normalizePoints(faceContour.normalizedPoints))
-        }
-        if let leftEye = landmarks.leftEye {
-            features.append(contentsOf: normalizePoints(leftEye.normalizedPoints))
-        }
-        if let rightEye = landmarks.rightEye {
-            features.append(contentsOf: normalizePoints(rightEye.normalizedPoints))
-        }
-        if let leftEyebrow = landmarks.leftEyebrow {
-            features.append(contentsOf: normalizePoints(leftEyebrow.normalizedPoints))
-        }
-        if let rightEyebrow = landmarks.rightEyebrow {
-            features.append(contentsOf: normalizePoints(rightEyebrow.normalizedPoints))
-        }
-        if let nose = landmarks.nose {
-            features.append(contentsOf: normalizePoints(nose.normalizedPoints))
-        }
-        if let noseCrest = landmarks.noseCrest {
-            features.append(contentsOf: normalizePoints(noseCrest.normalizedPoints))
-        }
-        if let medianLine = landmarks.medianLine {
-            features.append(contentsOf: normalizePoints(medianLine.normalizedPoints))
-        }
-        if let outerLips = landmarks.outerLips {
-            features.append(contentsOf: normalizePoints(outerLips.normalizedPoints))
-        }
-        if let innerLips = landmarks.innerLips {
-            features.append(contentsOf: normalizePoints(innerLips.normalizedPoints))
-        }
-        if let leftPupil = landmarks.leftPupil {
-            features.append(contentsOf: normalizePoints(leftPupil.normalizedPoints))
-        }
-        if let rightPupil = landmarks.rightPupil {
-            features.append(contentsOf: normalizePoints(rightPupil.normalizedPoints))
-        }
+    /// The fixed-layout descriptor for one face's landmarks, or nil when
+    /// Vision reported no regions at all.
+    nonisolated static func descriptor(from landmarks: VNFaceLandmarks2D) -> FaceDescriptor? {
+        let descriptor = FaceDescriptor { build(landmarks, into: &$0) }
+        return descriptor.mask == 0 ? nil : descriptor
+    }
 
-        features.append(contentsOf: calculateGeometricFeatures(landmarks))
+    /// Add every region Vision found to `builder`. Live recognition builds
+    /// into the gallery workspace this way, without a descriptor per face.
+    nonisolated static func build(_ landmarks: VNFaceLandmarks2D, into builder: inout FaceFeatureBuilder) {
+        add(.faceContour, landmarks.faceContour, to: &builder)
+        add(.leftEye, landmarks.leftEye, to: &builder)
+        add(.rightEye, landmarks.rightEye, to: &builder)
+        add(.leftEyebrow, landmarks.leftEyebrow, to: &builder)
+        add(.rightEyebrow, landmarks.rightEyebrow, to: &builder)
+        add(.nose, landmarks.nose, to: &builder)
+        add(.noseCrest, landmarks.noseCrest, to: &builder)
+        add(.medianLine, landmarks.medianLine, to: &builder)
+        add(.outerLips, landmarks.outerLips, to: &builder)
+        add(.innerLips, landmarks.innerLips, to: &builder)
+        add(.leftPupil, landmarks.leftPupil, to: &builder)
+        add(.rightPupil, landmarks.rightPupil, to: &builder)
+    }
 
-        print("[FaceEmbeddingExtractor] Extracted \(features.count)-dim embedding")
-        return features.isEmpty ? nil : features
+    private nonisolated static func add(_ region: FaceDescriptor.Region, _ landmark: VNFaceLandmarkRegion2D?,
+                                        to builder: inout FaceFeatureBuilder) {
+        guard let landmark = landmark else { return }
+        // CGPoint is two CGFloats (Doubles), so the points are already x/y interleaved.
+        landmark.normalizedPoints.withUnsafeBufferPointer { points in
+            guard let base = points.baseAddress else { return }
+            base.withMemoryRebound(to: Double.self, capacity: 2 * points.count) {
+                builder.add(region, points: UnsafeBufferPointer(start: $0, count: 2 * points.count))
+            }
+        }
     }
 
     // MARK: - Orientation mapping
@@ -112,58 +106,4 @@ enum FaceEmbeddingExtractor {
         @unknown default:    return .up
         }
     }
-
-    // MARK: - Helpers (identical to FaceRecognitionModel)
-
-    private static func normalizePoints(_ points: [CGPoint]) -> [Float] {
-        points.flatMap { [Float($0.x), Float($0.y)] }
-    }
-
-    private static func calculateGeometricFeatures(_ landmarks: VNFaceLandmarks2D) -> [Float] {
-        var geo: [Float] = []
-
-        if let leftEye = landmarks.leftEye,
-           let rightEye = landmarks.rightEye {
-            let lw = calculateWidth(leftEye.normalizedPoints)
-            let rw = calculateWidth(rightEye.normalizedPoints)
-            if rw > 0 { geo.append(Float(lw / rw)) }
-        }
-
-        if let lp = landmarks.leftPupil?.normalizedPoints.first,
-           let rp = landmarks.rightPupil?.normalizedPoints.first {
-            let d = sqrt(pow(rp.x - lp.x, 2) + pow(rp.y - lp.y, 2))
-            geo.append(Float(d))
-        }
-
-        if let nose = landmarks.nose,
-           let outerLips = landmarks.outerLips {
-            let noseCY = nose.normalizedPoints.map(\.y).reduce(0, +) / CGFloat(nose.normalizedPoints.count)
-            let mouthCY = outerLips.normalizedPoints.map(\.y).reduce(0, +) / CGFloat(outerLips.normalizedPoints.count)
-            geo.append(Float(abs(mouthCY - noseCY)))
-        }
-
-        if let fc = landmarks.faceContour {
-            let w = calculateWidth(fc.normalizedPoints)
-            let h = calculateHeight(fc.normalizedPoints)
-            if h > 0 { geo.append(Float(w / h)) }
-        }
-
-        if let ol = landmarks.outerLips {
-            geo.append(Float(calculateWidth(ol.normalizedPoints)))
-        }
-
-        return geo
-    }
-
-    private static func calculateWidth(_ points: [CGPoint]) -> CGFloat {
-        let xs = points.map(\.x)
-        guard let lo = xs.min(), let hi = xs.max() else { return 0 }
-        return hi - lo
-    }
-
-    private static func calculateHeight(_ points: [CGPoint]) -> CGFloat {
-        let ys = points.map(\.y)
-        guard let lo = ys.min(), let hi = ys.max() else { return 0 }
-        return hi - lo
-    }
 }
@@ -0,0 +1,127 @@
+//
+//  FaceFeatureBuilder.swift
+//  treehacks
+//
+//  Fills a `FaceDescriptor` layout from raw landmark points, straight into
+//  a caller-provided buffer: each region's points are resampled into its
+//  slots as they arrive, and the geometric measures are accumulated from
+//  running extents rather than temporary arrays, so building allocates
+//  nothing. Enrollment and live recognition both go through it, which
+//  keeps their vectors identical. Takes plain interleaved x/y Doubles (the
+//  memory layout of `[CGPoint]`), so it has no Vision dependency and is
+//  tested and benchmarked off device.
+//
+
+import Foundation
+
+struct FaceFeatureBuilder {
+
+    /// Bounds and sums of one region's points, for the geometric measures.
+    private struct Extent {
+        var minX = Double.infinity, maxX = -Double.infinity
+        var minY = Double.infinity, maxY = -Double.infinity
+        var sumY = 0.0
+        var firstX = 0.0, firstY = 0.0
+        var count = 0
+
+        var width: Double { maxX - minX }
+        var height: Double { maxY - minY }
+        var meanY: Double { sumY / Double(count) }
+    }
+
+    private let values: UnsafeMutablePointer<Float>
+    /// Presence bits of everything written so far.
+    private(set) var mask: UInt32 = 0
+
+    private var faceContour = Extent()
+    private var leftEye = Extent(), rightEye = Extent()
+    private var nose = Extent(), outerLips = Extent()
+    private var leftPupil = Extent(), rightPupil = Extent()
+
+    /// Start a descriptor in `values`, which must hold `FaceDescriptor.dimension`
+    /// floats; they are zeroed, so absent regions read as zero.
+    init(writingInto values: UnsafeMutablePointer<Float>) {
+        self.values = values
+        values.initialize(repeating: 0, count: FaceDescriptor.dimension)
+    }
+
+    /// Write one region from its normalized landmark points, `x0, y0, x1, y1, …`
+    /// in landmark order. A count other than the region's slot count is
+    /// resampled along the outline. Empty input leaves the region absent.
+    mutating func add(_ region: FaceDescriptor.Region, points: UnsafeBufferPointer<Double>) {
+        let available = points.count / 2
+        guard available > 0 else { return }
+        let slots = values + FaceDescriptor.segmentOffsets[region.rawValue]
+        let count = region.pointCount
+        if available == count {
+            for i in 0..<2 * count {
+                slots[i] = Float(points[i])
+            }
+        } else {
+            for i in 0..<count {
+                let t = count > 1 ? Double(i * (available - 1)) / Double(count - 1) : 0
+                let lower = Int(t)
+                let upper = min(lower + 1, available - 1)
+                let f = t - Double(lower)
+                slots[2 * i] = Float(points[2 * lower] + (points[2 * upper] - points[2 * lower]) * f)
+                slots[2 * i + 1] = Float(points[2 * lower + 1] + (points[2 * upper + 1] - points[2 * lower + 1]) * f)
+            }
+        }
+        mask |= FaceDescriptor.bit(region)
+
+        switch region {
+        case .faceContour: Self.accumulate(points, into: &faceContour)
+        case .leftEye: Self.accumulate(points, into: &leftEye)
+        case .rightEye: Self.accumulate(points, into: &rightEye)
+        case .nose: Self.accumulate(points, into: &nose)
+        case .outerLips: Self.accumulate(points, into: &outerLips)
+        case .leftPupil: Self.accumulate(points, into: &leftPupil)
+        case .rightPupil: Self.accumulate(points, into: &rightPupil)
+        default: break
+        }
+    }
+
+    /// Write the geometric measures the added regions allow and return the
+    /// descriptor's mask.
+    mutating func finish() -> UInt32 {
+        if leftEye.count > 0 && rightEye.count > 0 && rightEye.width > 0 {
+            set(.eyeWidthRatio, leftEye.width / rightEye.width)
+        }
+        if leftPupil.count > 0 && rightPupil.count > 0 {
+            let dx = rightPupil.firstX - leftPupil.firstX
+            let dy = rightPupil.firstY - leftPupil.firstY
+            set(.pupilDistance, (dx * dx + dy * dy).squareRoot())
+        }
+        if nose.count > 0 && outerLips.count > 0 {
+            set(.noseToMouth, abs(outerLips.meanY - nose.meanY))
+        }
+        if faceContour.count > 0 && faceContour.height > 0 {
+            set(.faceAspect, faceContour.width / faceContour.height)
+        }
+        if outerLips.count > 0 {
+            set(.mouthWidth, outerLips.width)
+        }
+        return mask
+    }
+
+    private mutating func set(_ measure: FaceDescriptor.Measure, _ value: Double) {
+        values[FaceDescriptor.segmentOffsets[FaceDescriptor.Region.allCases.count + measure.rawValue]] = Float(value)
+        mask |= FaceDescriptor.bit(measure)
+    }
+
+    private static func accumulate(_ points: UnsafeBufferPointer<Double>, into extent: inout Extent) {
+        extent.firstX = points[0]
+        extent.firstY = points[1]
+        var i = 0
+        while i + 1 < points.count {
+            let x = points[i], y = points[i + 1]
+            extent.minX = min(extent.minX, x)
+            extent.maxX = max(extent.maxX, x)
+            extent.minY = min(extent.minY, y)
+            extent.maxY = max(extent.maxY, y)
+            extent.sumY += y
+            extent.count += 1
+            i += 2
+        }
+    }
+}
@@ -0,0 +1,259 @@
+//
+//  FaceMatcher.swift
+//  treehacks
+//
+//  Best-of-N cosine matching of live face descriptors against every
+//  contact's reference descriptors. `FaceGallery` compiles the references
+//  once into a contiguous matrix of unit vectors, stored transposed (one
+//  column per reference) with the owning contact and region mask of each,
+//  so matching all faces in a frame is one matrix product into reused
+//  buffers. Foundation-only, so
+//  the matching math can be benchmarked off device.
+//
+
+import Foundation
+
+enum FaceMatcher {
+
+    /// Minimum similarity for a face to be recognized as a contact.
+    static let threshold: Float = 0.75
+
+    /// Best similarity of `face` to each gallery (one per person) across its
+    /// descriptors, or nil when none shares enough regions with it.
+    /// The uncompiled reference for `FaceGallery`, kept for benchmarks.
+    static func bestSimilarities(for face: FaceDescriptor, in galleries: [[FaceDescriptor]]) -> [Float?] {
+        galleries.map { descriptors in
+            var best: Float?
+            for descriptor in descriptors {
+                guard let similarity = maskedSimilarity(face, descriptor) else { continue }
+                best = max(best ?? 0, similarity)
+            }
+            return best
+        }
+    }
+
+    /// Index of the highest similarity above `threshold`, if any.
+    static func bestMatch(in similarities: [Float?], threshold: Float = threshold) -> Int? {
+        var bestIndex: Int?
+        var bestSimilarity: Float = 0
+        for (i, similarity) in similarities.enumerated() {
+            guard let similarity = similarity else { continue }
+            if similarity > bestSimilarity && similarity > threshold {
+                bestSimilarity = similarity
+                bestIndex = i
+            }
+        }
+        return bestIndex
+    }
+
+    /// Cosine similarity over the regions both descriptors have, or nil when
+    /// they share too little to compare.
+    static func maskedSimilarity(_ a: FaceDescriptor, _ b: FaceDescriptor) -> Float? {
+        let dimension = FaceDescriptor.dimension
+        let segments = FaceDescriptor.segmentCount
+        var units = [Float](repeating: 0, count: 2 * dimension)
+        var norms = [Float](repeating: 0, count: 2 * segments)
+        return units.withUnsafeMutableBufferPointer { units in
+            norms.withUnsafeMutableBufferPointer { norms in
+                let ua = units.baseAddress!, ub = ua + dimension
+                let na = norms.baseAddress!, nb = na + segments
+                guard a.normalize(into: ua, segmentNorms: na),
+                      b.normalize(into: ub, segmentNorms: nb) else { return nil }
+                let dot = VectorMath.dot(ua, ub, count: dimension)
+                return FaceDescriptor.maskedSimilarity(dot: dot, a.mask, na, b.mask, nb)
+            }
+        }
+    }
+}
+
+/// Reference descriptors compiled for matching. Rebuild when contacts change;
+/// matching never modifies it, so one gallery can serve any thread.
+struct FaceGallery {
+
+    /// The best reference for a live face.
+    struct Match {
+        /// Index of the contact owning the reference.
+        let owner: Int
+        let similarity: Float
+    }
+
+    /// Buffers reused across `match` calls so matching does not allocate.
+    /// Grows on first use with more faces or a larger gallery than before.
+    /// One per caller; not thread-safe.
+    final class Workspace {
+        /// Unit live descriptors, one per row.
+        fileprivate private(set) var queries = UnsafeMutablePointer<Float>.allocate(capacity: 0)
+        /// Squared norm of each query segment, `segmentCount` per row.
+        fileprivate private(set) var queryNorms = UnsafeMutablePointer<Float>.allocate(capacity: 0)
+        /// `queries × gallery rows` dot products.
+        fileprivate private(set) var scores = UnsafeMutablePointer<Float>.allocate(capacity: 0)
+        private var queryCapacity = 0
+        private var scoreCapacity = 0
+        /// Which input face each query row is, and its presence mask.
+        fileprivate var faceIndices: [Int] = []
+        fileprivate var queryMasks: [UInt32] = []
+        /// Best reference per input face, nil below the threshold or when no
+        /// reference shares enough regions with it.
+        fileprivate(set) var matches: [Match?] = []
+
+        init() {}
+
+        deinit {
+            queries.deallocate()
+            queryNorms.deallocate()
+            scores.deallocate()
+        }
+
+        fileprivate func reserve(faces: Int, rows: Int) {
+            if queryCapacity < faces {
+                queries.deallocate()
+                queryNorms.deallocate()
+                queryCapacity = faces
+                queries = .allocate(capacity: faces * FaceDescriptor.dimension)
+                queryNorms = .allocate(capacity: faces * FaceDescriptor.segmentCount)
+            }
+            if scoreCapacity < faces * rows {
+                scores.deallocate()
+                scoreCapacity = faces * rows
+                scores = .allocate(capacity: scoreCapacity)
+            }
+            faceIndices.reserveCapacity(faces)
+            queryMasks.reserveCapacity(faces)
+        }
+
+        fileprivate func reset(faces: Int) {
+            matches.removeAll(keepingCapacity: true)
+            matches.reserveCapacity(faces)
+            for _ in 0..<faces {
+                matches.append(nil)
+            }
+        }
+    }
+
+    /// `FaceDescriptor.dimension × count` unit descriptors, one per column,
+    /// so live rows multiply against it directly.
+    private var transposed: [Float] = []
+    /// `count × FaceDescriptor.segmentCount` squared segment norms of each row.
+    private var segmentNorms: [Float] = []
+    /// Presence mask of each row.
+    private var masks: [UInt32] = []
+    /// Contact index owning each row.
+    private var owners: [Int] = []
+    /// Contacts the gallery was built from, including ones without descriptors.
+    let ownerCount: Int
+
+    /// Total reference rows.
+    var count: Int { owners.count }
+
+    /// - Parameter galleries: Each contact's reference descriptors, in contact order.
+    init(galleries: [[FaceDescriptor]]) {
+        ownerCount = galleries.count
+        let dimension = FaceDescriptor.dimension
+        let segments = FaceDescriptor.segmentCount
+        var unit = [Float](repeating: 0, count: dimension)
+        var norms = [Float](repeating: 0, count: segments)
+        var storage: [Float] = []
+        for (owner, descriptors) in galleries.enumerated() {
+            for descriptor in descriptors {
+                let normalized = unit.withUnsafeMutableBufferPointer { unit in
+                    norms.withUnsafeMutableBufferPointer { norms in
+                        descriptor.normalize(into: unit.baseAddress!, segmentNorms: norms.baseAddress!)
+                    }
+                }
+                guard normalized else { continue }
+                storage.append(contentsOf: unit)
+                segmentNorms.append(contentsOf: norms)
+                masks.append(descriptor.mask)
+                owners.append(owner)
+            }
+        }
+
+        let rows = owners.count
+        transposed = [Float](repeating: 0, count: dimension * rows)
+        for r in 0..<rows {
+            for d in 0..<dimension {
+                transposed[d * rows + r] = storage[r * dimension + d]
+            }
+        }
+    }
+
+    /// Match every live face: all faces are normalized into the workspace and
+    /// scored against every row in one fixed-stride matrix product, then each
+    /// dot product is renormalized over the regions the pair shares (a no-op
+    /// when both have the same regions). Nil faces (no landmarks) stay
+    /// unmatched. Results land in `workspace.matches`.
+    func match(_ faces: [FaceDescriptor?], threshold: Float = FaceMatcher.threshold, in workspace: Workspace) {
+        match(faceCount: faces.count, threshold: threshold, in: workspace) { i, row in
+            guard let face = faces[i] else { return 0 }
+            face.values.withUnsafeBufferPointer { row.update(from: $0.baseAddress!, count: FaceDescriptor.dimension) }
+            return face.mask
+        }
+    }
+
+    /// Match `faceCount` live faces whose features `build` adds for face `i`
+    /// straight into the workspace, so no descriptor is allocated per face.
+    /// A face `build` adds nothing for stays unmatched.
+    func match(faceCount: Int, threshold: Float = FaceMatcher.threshold, in workspace: Workspace,
+               build: (Int, inout FaceFeatureBuilder) -> Void) {
+        match(faceCount: faceCount, threshold: threshold, in: workspace) { i, row in
+            var builder = FaceFeatureBuilder(writingInto: row)
+            build(i, &builder)
+            return builder.finish()
+        }
+    }
+
+    /// `write` fills a query row with face `i`'s values and returns its mask.
+    private func match(faceCount: Int, threshold: Float, in workspace: Workspace,
+                       write: (Int, UnsafeMutablePointer<Float>) -> UInt32) {
+        workspace.reset(faces: faceCount)
+        let rows = count
+        guard rows > 0 else { return }
+        let dimension = FaceDescriptor.dimension
+        let segments = FaceDescriptor.segmentCount
+        workspace.reserve(faces: faceCount, rows: rows)
+
+        workspace.faceIndices.removeAll(keepingCapacity: true)
+        workspace.queryMasks.removeAll(keepingCapacity: true)
+        for i in 0..<faceCount {
+            let q = workspace.faceIndices.count
+            let row = workspace.queries + q * dimension
+            let mask = write(i, row)
+            guard mask != 0,
+                  FaceDescriptor.normalize(row, into: row, segmentNorms: workspace.queryNorms + q * segments) else { continue }
+            workspace.faceIndices.append(i)
+            workspace.queryMasks.append(mask)
+        }
+        let queryCount = workspace.faceIndices.count
+        guard queryCount > 0 else { return }
+
+        transposed.withUnsafeBufferPointer { matrix in
+            VectorMath.gemm(
+                workspace.queries, rows: queryCount, inner: dimension,
+                matrix.baseAddress!, columns: rows,
+                into: workspace.scores
+            )
+        }
+
+        // Best-of-N per contact, then the best contact, is just the best row.
+        segmentNorms.withUnsafeBufferPointer { rowNorms in
+            for q in 0..<queryCount {
+                let queryMask = workspace.queryMasks[q]
+                let queryNorms = UnsafePointer(workspace.queryNorms + q * segments)
+                let scores = workspace.scores + q * rows
+                var bestRow = -1
+                var bestScore = threshold
+                for r in 0..<rows {
+                    guard let score = FaceDescriptor.maskedSimilarity(
+                        dot: scores[r], queryMask, queryNorms,
+                        masks[r], rowNorms.baseAddress! + r * segments
+                    ), score > bestScore else { continue }
+                    bestScore = score
+                    bestRow = r
+                }
+                if bestRow >= 0 {
+                    workspace.matches[workspace.faceIndices[q]] = Match(owner: owners[bestRow], similarity: bestScore)
+                }
+            }
+        }
+    }
+}
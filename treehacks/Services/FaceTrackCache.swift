@@ -0,0 +1,141 @@
+//
+//  FaceTrackCache.swift
+//  treehacks
+//
+//  Follows faces from frame to frame by overlap of their detected
+//  bounding boxes, giving each a stable track ID, and caches who each
+//  track was recognized as. Landmark extraction and gallery matching only
+//  run for a track when it is new, when its last result was missing or
+//  weak, or when it is due for periodic re-verification; otherwise the
+//  cached identity is reused. A track outlives a few missed detections,
+//  so a nametag does not drop out when one frame misses its face, and an
+//  identity is cleared only after several recognitions in a row fail, so
+//  one blurred frame does not drop it but a misidentified face or a new
+//  person in the same box does not keep it forever. Failed tracks back off
+//  their retries up to the re-verification interval.
+//
+
+import CoreGraphics
+import Foundation
+
+struct FaceTrackCache<Identity> {
+
+    struct Track {
+        let id: UUID
+        /// Latest detected box, in Vision's normalized coordinates.
+        fileprivate(set) var boundingBox: CGRect
+        fileprivate(set) var identity: Identity?
+        fileprivate(set) var similarity: Float = 0
+        fileprivate var lastRecognized: TimeInterval = -.infinity
+        /// Consecutive recognitions that matched nobody.
+        fileprivate(set) var failures = 0
+        /// Consecutive updates without a matching detection.
+        fileprivate(set) var misses = 0
+    }
+
+    /// Intersection over union for a detection to continue a track.
+    var minimumOverlap: CGFloat = 0.3
+    /// Similarity at or above which a cached identity is trusted until re-verification.
+    var confidentSimilarity: Float = 0.85
+    /// How often a confidently recognized track is recognized again.
+    var reverifyInterval: TimeInterval = 5
+    /// How often an unrecognized or weakly recognized track is first retried;
+    /// doubles with each failure, up to `reverifyInterval`.
+    var retryInterval: TimeInterval = 0.5
+    /// Consecutive failed recognitions after which a track forgets its identity.
+    var maxFailures = 3
+    /// Updates a track survives without a detection before it is dropped.
+    var maxMisses = 5
+
+    private(set) var tracks: [Track] = []
+
+    /// Associate this frame's detections with tracks, greedily by best
+    /// overlap, starting new tracks for the rest and ageing out unseen ones.
+    /// Returns the index in `tracks` of each detection's track.
+    mutating func update(with boxes: [CGRect]) -> [Int] {
+        var trackForBox = [Int](repeating: -1, count: boxes.count)
+        var claimed = [Bool](repeating: false, count: tracks.count)
+
+        var candidates: [(overlap: CGFloat, box: Int, track: Int)] = []
+        for (b, box) in boxes.enumerated() {
+            for (t, track) in tracks.enumerated() {
+                let overlap = Self.intersectionOverUnion(box, track.boundingBox)
+                if overlap >= minimumOverlap {
+                    candidates.append((overlap, b, t))
+                }
+            }
+        }
+        for candidate in candidates.sorted(by: { $0.overlap > $1.overlap })
+        where trackForBox[candidate.box] < 0 && !claimed[candidate.track] {
+            trackForBox[candidate.box] = candidate.track
+            claimed[candidate.track] = true
+        }
+
+        for t in tracks.indices {
+            tracks[t].misses = claimed[t] ? 0 : tracks[t].misses + 1
+        }
+        for (b, box) in boxes.enumerated() {
+            if trackForBox[b] >= 0 {
+                tracks[trackForBox[b]].boundingBox = box
+            } else {
+                trackForBox[b] = tracks.count
+                tracks.append(Track(id: UUID(), boundingBox: box))
+            }
+        }
+
+        // Drop lost tracks, keeping the returned indices valid.
+        let kept = tracks.indices.filter { tracks[$0].misses <= maxMisses }
+        if kept.count < tracks.count {
+            var newIndex = [Int](repeating: -1, count: tracks.count)
+            for (i, old) in kept.enumerated() {
+                newIndex[old] = i
+            }
+            tracks = kept.map { tracks[$0] }
+            trackForBox = trackForBox.map { newIndex[$0] }
+        }
+        return trackForBox
+    }
+
+    /// Follow a track to `box` between detections (from an object tracker),
+    /// without ageing the others. Returns the track, or nil if it was dropped.
+    @discardableResult
+    mutating func move(_ id: UUID, to box: CGRect) -> Track? {
+        guard let index = tracks.firstIndex(where: { $0.id == id }) else { return nil }
+        tracks[index].boundingBox = box
+        return tracks[index]
+    }
+
+    /// Whether the track at `index` should go through full recognition at `time`.
+    func needsRecognition(_ index: Int, at time: TimeInterval) -> Bool {
+        let track = tracks[index]
+        let confident = track.identity != nil && track.similarity >= confidentSimilarity
+        let backoff = retryInterval * Double(1 << min(track.failures, 16))
+        return time - track.lastRecognized >= (confident ? reverifyInterval : min(backoff, reverifyInterval))
+    }
+
+    /// Cache a recognition result for the track at `index`. A miss lowers the
+    /// confidence of an identity recognized earlier, and clears it once
+    /// `maxFailures` misses come in a row.
+    mutating func record(_ identity: Identity?, similarity: Float, forTrack index: Int, at time: TimeInterval) {
+        tracks[index].lastRecognized = time
+        if let identity = identity {
+            tracks[index].identity = identity
+            tracks[index].similarity = similarity
+            tracks[index].failures = 0
+        } else {
+            tracks[index].similarity = 0
+            tracks[index].failures += 1
+            if tracks[index].failures >= maxFailures {
+                tracks[index].identity = nil
+            }
+        }
+    }
+
+    private static func intersectionOverUnion(_ a: CGRect, _ b: CGRect) -> CGFloat {
+        let intersection = a.intersection(b)
+        guard !intersection.isNull else { return 0 }
+        let overlap = intersection.width * intersection.height
+        let union = a.width * a.height + b.width * b.height - overlap
+        return union > 0 ? overlap / union : 0
+    }
+}
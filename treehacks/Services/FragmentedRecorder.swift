@@ -0,0 +1,297 @@
+//
+//  FragmentedRecorder.swift
+//  treehacks
+//
+//  The one H.264 encoder for the camera feed. Each recording session is a
+//  single AVAssetWriter producing fragmented MP4, cut at keyframes into
+//  fragments of about `fragmentDuration`. Every fragment is saved as its
+//  own playable file (the session's initialization segment followed by the
+//  fragment's media segment) and announced on `fragments`. Fragments of a
+//  session tile its timeline exactly: each starts where the previous one
+//  ended, so rotating files never drops time. ClipManager
+//  indexes each fragment as a searchable clip and RecordingManager keeps
+//  the rolling recall buffer, both over the same files. The recorder
+//  deletes fragments once they are older than `retention`. A fragment's
+//  file name records its times, so fragments from a previous launch that
+//  are still within `retention` are listed again on the next one.
+//
+
+import AVFoundation
+import Combine
+import UniformTypeIdentifiers
+
+final class FragmentedRecorder: NSObject {
+
+    let directory: URL
+    let fragmentDuration: TimeInterval
+    /// How long fragment files stay on disk.
+    let retention: TimeInterval
+
+    /// Each saved fragment, delivered on the writer's delegate thread.
+    let fragments = PassthroughSubject<RecordingSegment, Never>()
+
+    /// One writer and what its fragments need.
+    private final class Session {
+        let writer: AVAssetWriter
+        let input: AVAssetWriterInput
+        let adaptor: AVAssetWriterInputPixelBufferAdaptor
+        /// Presentation time of the first frame and when it was recorded.
+        let startTime: CMTime
+        let startDate: Date
+        var initializationSegment: Data?
+        /// Where the last saved fragment ended; the next one starts there.
+        var fragmentBoundary: CMTime?
+
+        init(writer: AVAssetWriter, input: AVAssetWriterInput,
+             adaptor: AVAssetWriterInputPixelBufferAdaptor, startTime: CMTime) {
+            self.writer = writer
+            self.input = input
+            self.adaptor = adaptor
+            self.startTime = startTime
+            // Camera timestamps (ARKit and AVCapture alike) are on the host clock.
+            let age = CMTimeGetSeconds(CMTimeSubtract(CMClockGetTime(CMClockGetHostTimeClock()), startTime))
+            self.startDate = Date().addingTimeInterval(-max(0, age))
+        }
+
+        func date(at time: CMTime) -> Date {
+            startDate.addingTimeInterval(CMTimeGetSeconds(CMTimeSubtract(time, startTime)))
+        }
+    }
+
+    /// Session receiving frames; only touched on the caller's serial queue.
+    private var current: Session?
+
+    /// Sessions by writer, including finishing ones whose last fragment is still
+    /// to come, and saved fragments oldest first. Guarded by `lock`.
+    private let lock = NSLock()
+    private var sessions: [ObjectIdentifier: Session] = [:]
+    private var saved: [RecordingSegment] = []
+
+    init(directory: URL, fragmentDuration: TimeInterval, retention: TimeInterval) {
+        self.directory = directory
+        self.fragmentDuration = fragmentDuration
+        self.retention = retention
+        super.init()
+        adoptSavedFragments()
+    }
+
+    // MARK: - Recording
+
+    // `start`, `append` and `finish` must be called on one serial queue.
+
+    var isRecording: Bool { current != nil }
+
+    /// Fragments still on disk, oldest first.
+    var savedFragments: [RecordingSegment] {
+        lock.lock()
+        defer { lock.unlock() }
+        return saved
+    }
+
+    /// Begin a session sized for `pixelBuffer`. Returns false if the writer could not start.
+    @discardableResult
+    func start(firstFrame pixelBuffer: CVPixelBuffer, timestamp: CMTime, transform: CGAffineTransform) -> Bool {
+        let writer = AVAssetWriter(contentType: UTType.mpeg4Movie)
+        writer.outputFileTypeProfile = .mpeg4AppleHLS
+        writer.preferredOutputSegmentInterval = CMTime(seconds: fragmentDuration, preferredTimescale: 600)
+        writer.initialSegmentStartTime = timestamp
+        writer.delegate = self
+
+        let outputSettings: [String: Any] = [
+            AVVideoCodecKey: AVVideoCodecType.h264,
+            AVVideoWidthKey: CVPixelBufferGetWidth(pixelBuffer),
+            AVVideoHeightKey: CVPixelBufferGetHeight(pixelBuffer),
+            AVVideoCompressionPropertiesKey: [
+                AVVideoAverageBitRateKey: 800_000,
+                AVVideoMaxKeyFrameIntervalKey: 30,
+                // Fragments can only be cut at keyframes.
+                AVVideoMaxKeyFrameIntervalDurationKey: 1,
+            ]
+        ]
+        let input = AVAssetWriterInput(mediaType: .video, outputSettings: outputSettings)
+        input.expectsMediaDataInRealTime = true
+        input.transform = transform
+
+        let adaptor = AVAssetWriterInputPixelBufferAdaptor(
+            assetWriterInput: input,
+            sourcePixelBufferAttributes: [
+                kCVPixelBufferPixelFormatTypeKey as String: CVPixelBufferGetPixelFormatType(pixelBuffer)
+            ]
+        )
+
+        guard writer.canAdd(input) else {
+            print("[FragmentedRecorder] Cannot add video input to writer")
+            return false
+        }
+        writer.add(input)
+        guard writer.startWriting() else {
+            print("[FragmentedRecorder] Failed to start writing: \(String(describing: writer.error))")
+            return false
+        }
+        writer.startSession(atSourceTime: timestamp)
+
+        let session = Session(writer: writer, input: input, adaptor: adaptor, startTime: timestamp)
+        lock.lock()
+        sessions[ObjectIdentifier(writer)] = session
+        lock.unlock()
+        current = session
+        return true
+    }
+
+    /// Encode a frame; dropped if the encoder is not ready for it. If the
+    /// writer has failed, the session ends so the next frame starts a new one.
+    func append(_ pixelBuffer: CVPixelBuffer, timestamp: CMTime) {
+        guard let session = current else { return }
+        guard session.writer.status == .writing else {
+            print("[FragmentedRecorder] Writer stopped with status \(session.writer.status.rawValue); restarting")
+            finish()
+            return
+        }
+        guard session.input.isReadyForMoreMediaData else { return }
+        session.adaptor.append(pixelBuffer, withPresentationTime: timestamp)
+    }
+
+    /// End the session. Its last fragment is announced before `completion` runs.
+    func finish(completion: (() -> Void)? = nil) {
+        guard let session = current else {
+            completion?()
+            return
+        }
+        current = nil
+        guard session.writer.status == .writing else {
+            forget(session)
+            completion?()
+            return
+        }
+        session.input.markAsFinished()
+        session.writer.finishWriting { [weak self] in
+            if session.writer.status != .completed {
+                print("[FragmentedRecorder] Writer finished with status \(session.writer.status.rawValue): \(String(describing: session.writer.error))")
+            }
+            self?.forget(session)
+            completion?()
+        }
+    }
+
+    private func forget(_ session: Session) {
+        lock.lock()
+        sessions.removeValue(forKey: ObjectIdentifier(session.writer))
+        lock.unlock()
+    }
+
+    // MARK: - Fragments
+
+    /// Save a media segment as a playable file and drop fragments past `retention`.
+    private func save(_ segmentData: Data, report: AVAssetSegmentReport?, session: Session, initialization: Data) {
+        guard let track = report?.trackReports.first(where: { $0.mediaType == .video }) else { return }
+        // Continue from the previous fragment so rounding in the reports leaves no gap.
+        let startTime = session.fragmentBoundary ?? track.earliestPresentationTimeStamp
+        let endTime = CMTimeAdd(track.earliestPresentationTimeStamp, track.duration)
+        session.fragmentBoundary = endTime
+        let start = session.date(at: startTime)
+        let end = session.date(at: endTime)
+        let mediaStartTime = CMTimeGetSeconds(CMTimeSubtract(startTime, session.startTime))
+        let url = directory.appendingPathComponent(Self.fileName(start: start, end: end, mediaStartTime: mediaStartTime))
+
+        var file = initialization
+        file.append(segmentData)
+        do {
+            try file.write(to: url)
+        } catch {
+            print("[FragmentedRecorder] Failed to save fragment: \(error)")
+            return
+        }
+
+        var fragment = RecordingSegment(fileURL: url, startTime: start, endTime: end)
+        fragment.mediaStartTime = mediaStartTime
+        let cutoff = Date().addingTimeInterval(-retention)
+        lock.lock()
+        saved.append(fragment)
+        let expired = saved.prefix { ($0.endTime ?? $0.startTime) < cutoff }
+        saved.removeFirst(expired.count)
+        lock.unlock()
+        for old in expired {
+            try? FileManager.default.removeItem(at: old.fileURL)
+        }
+
+        fragments.send(fragment)
+    }
+}
+
+// MARK: - File Names
+
+extension FragmentedRecorder {
+
+    /// `fragment_<start>_<end>_<media start>.mp4`, in milliseconds (the
+    /// first two since 1970).
+    fileprivate static func fileName(start: Date, end: Date, mediaStartTime: TimeInterval) -> String {
+        "fragment_\(milliseconds(start.timeIntervalSince1970))_\(milliseconds(end.timeIntervalSince1970))"
+            + "_\(milliseconds(mediaStartTime)).mp4"
+    }
+
+    /// The fragment a file saved by `save` holds, or nil for any other file.
+    fileprivate static func fragment(at url: URL) -> RecordingSegment? {
+        guard url.pathExtension == "mp4" else { return nil }
+        let parts = url.deletingPathExtension().lastPathComponent.split(separator: "_")
+        guard parts.count == 4, parts[0] == "fragment",
+              let start = Int64(parts[1]), let end = Int64(parts[2]), let media = Int64(parts[3]) else { return nil }
+        var fragment = RecordingSegment(fileURL: url,
+                                        startTime: Date(timeIntervalSince1970: Double(start) / 1000),
+                                        endTime: Date(timeIntervalSince1970: Double(end) / 1000))
+        fragment.mediaStartTime = Double(media) / 1000
+        return fragment
+    }
+
+    private static func milliseconds(_ seconds: TimeInterval) -> Int64 {
+        Int64((seconds * 1000).rounded())
+    }
+
+    /// List the fragments a previous launch left within `retention` and delete
+    /// every other file in `directory` (expired fragments and older formats).
+    fileprivate func adoptSavedFragments() {
+        let fm = FileManager.default
+        guard let files = try? fm.contentsOfDirectory(at: directory, includingPropertiesForKeys: nil) else { return }
+        let cutoff = Date().addingTimeInterval(-retention)
+        var adopted: [RecordingSegment] = []
+        for file in files {
+            if let fragment = Self.fragment(at: file), let end = fragment.endTime, end >= cutoff {
+                adopted.append(fragment)
+            } else {
+                try? fm.removeItem(at: file)
+            }
+        }
+        adopted.sort { $0.startTime < $1.startTime }
+        lock.lock()
+        saved = adopted
+        lock.unlock()
+        if !adopted.isEmpty {
+            print("[FragmentedRecorder] Kept \(adopted.count) fragment(s) from the last launch")
+        }
+    }
+}
+
+// MARK: - AVAssetWriterDelegate
+
+extension FragmentedRecorder: AVAssetWriterDelegate {
+    func assetWriter(
+        _ writer: AVAssetWriter,
+        didOutputSegmentData segmentData: Data,
+        segmentType: AVAssetSegmentType,
+        segmentReport: AVAssetSegmentReport?
+    ) {
+        lock.lock()
+        let session = sessions[ObjectIdentifier(writer)]
+        lock.unlock()
+        guard let session = session else { return }
+
+        switch segmentType {
+        case .initialization:
+            session.initializationSegment = segmentData
+        case .separable:
+            guard let initialization = session.initializationSegment else { return }
+            save(segmentData, report: segmentReport, session: session, initialization: initialization)
+        @unknown default:
+            break
+        }
+    }
+}
@@ -0,0 +1,155 @@
+//
+//  FrameIntakeQueue.swift
+//  treehacks
+//
+//  Fixed-capacity ring between the camera callback (the single producer)
+//  and ClipManager's writer queue (the single consumer). However long
+//  classification or OCR stalls the consumer, at most `capacity` camera
+//  buffers are retained and at most one drain is scheduled:
+//  - when the ring is full, the oldest waiting frame is dropped
+//  - when a frame leaves the ring with `analysisSheddingDepth` or more still
+//    waiting, it is written but not analyzed, so the backlog clears
+//
+
+import CoreMedia
+import CoreVideo
+import Foundation
+
+final class FrameIntakeQueue {
+
+    struct Frame {
+        let pixelBuffer: CVPixelBuffer
+        let timestamp: CMTime
+        /// Uptime when the frame was pushed, in nanoseconds.
+        let enqueued: UInt64
+        /// False when the frame should only be written.
+        var analyze = true
+    }
+
+    /// Consumer stages timed with `record(_:since:)`; time waiting in the ring
+    /// is recorded by `pop`.
+    enum Stage {
+        /// Appending to the clip writer.
+        case write
+        /// Scene check, Vision analysis and frame scoring.
+        case analysis
+    }
+
+    /// Timing of one stage.
+    struct Latency {
+        var count = 0
+        var total: TimeInterval = 0
+        var max: TimeInterval = 0
+
+        var average: TimeInterval {
+            count > 0 ? total / Double(count) : 0
+        }
+    }
+
+    struct Metrics {
+        /// Frames waiting right now, and the most seen at once.
+        var depth = 0
+        var maxDepth = 0
+        var enqueued = 0
+        /// Frames evicted unwritten from a full ring.
+        var dropped = 0
+        /// Frames written without analysis to catch up.
+        var analysisSkipped = 0
+        var wait = Latency()
+        var write = Latency()
+        var analysis = Latency()
+    }
+
+    let capacity: Int
+    let analysisSheddingDepth: Int
+
+    private let lock = NSLock()
+    private var slots: [Frame?]
+    /// Slot of the oldest waiting frame.
+    private var head = 0
+    private var count = 0
+    /// Whether the consumer has been scheduled and not yet found the ring empty.
+    private var isDraining = false
+    private var state = Metrics()
+
+    init(capacity: Int = 6, analysisSheddingDepth: Int = 3) {
+        self.capacity = max(1, capacity)
+        self.analysisSheddingDepth = max(1, analysisSheddingDepth)
+        slots = Array(repeating: nil, count: self.capacity)
+    }
+
+    var metrics: Metrics {
+        lock.lock()
+        defer { lock.unlock() }
+        return state
+    }
+
+    /// Producer side. Returns true when the consumer is idle and must be
+    /// scheduled to drain; it then stays scheduled until `pop` returns nil.
+    func push(_ pixelBuffer: CVPixelBuffer, timestamp: CMTime) -> Bool {
+        let frame = Frame(pixelBuffer: pixelBuffer, timestamp: timestamp,
+                          enqueued: DispatchTime.now().uptimeNanoseconds)
+        var evicted: Frame?
+        lock.lock()
+        if count == capacity {
+            evicted = slots[head]
+            slots[head] = nil
+            head = (head + 1) % capacity
+            count -= 1
+            state.dropped += 1
+        }
+        slots[(head + count) % capacity] = frame
+        count += 1
+        state.enqueued += 1
+        state.depth = count
+        state.maxDepth = max(state.maxDepth, count)
+        let wake = !isDraining
+        isDraining = true
+        lock.unlock()
+        // The evicted camera buffer goes back to its pool outside the lock.
+        withExtendedLifetime(evicted) {}
+        return wake
+    }
+
+    /// Consumer side. The oldest waiting frame, or nil once the ring is empty,
+    /// after which the next `push` asks for a new drain.
+    func pop() -> Frame? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard count > 0, var frame = slots[head] else {
+            isDraining = false
+            return nil
+        }
+        slots[head] = nil
+        head = (head + 1) % capacity
+        count -= 1
+        state.depth = count
+        if count >= analysisSheddingDepth {
+            frame.analyze = false
+            state.analysisSkipped += 1
+        }
+        Self.record(Self.seconds(since: frame.enqueued), in: &state.wait)
+        return frame
+    }
+
+    /// Record time spent in `stage` since `start` (an uptime in nanoseconds).
+    func record(_ stage: Stage, since start: UInt64) {
+        let elapsed = Self.seconds(since: start)
+        lock.lock()
+        switch stage {
+        case .write: Self.record(elapsed, in: &state.write)
+        case .analysis: Self.record(elapsed, in: &state.analysis)
+        }
+        lock.unlock()
+    }
+
+    private static func seconds(since start: UInt64) -> TimeInterval {
+        Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9
+    }
+
+    private static func record(_ elapsed: TimeInterval, in latency: inout Latency) {
+        latency.count += 1
+        latency.total += elapsed
+        latency.max = max(latency.max, elapsed)
+    }
+}
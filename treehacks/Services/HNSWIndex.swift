@@ -0,0 +1,407 @@
+//
+//  HNSWIndex.swift
+//  treehacks
+//
+//  Hierarchical Navigable Small World graph (Malkov & Yashunin) over unit
+//  vectors. Query cost grows roughly logarithmically with the number of
+//  clips, so a multi-day history stays interactive where a full scan
+//  would not. Each node also lists the nodes with an edge to it, so a
+//  delete re-links exactly the nodes that pointed at the removed one and
+//  no edge survives into a reused slot; updates re-link the node in
+//  place, so pruning and vision re-embedding never require a rebuild.
+//  Vectors are stored as `VectorCodes` (int8 by default): traversal
+//  scores codes, and the final candidates are re-ranked against the
+//  unquantized query.
+//
+
+import Foundation
+
+struct HNSWIndex: VectorIndex {
+
+    private typealias Candidate = (slot: Int32, score: Float)
+
+    // MARK: - Parameters
+
+    /// Neighbours kept per node on upper layers (layer 0 keeps twice as many).
+    let maxConnections: Int
+    /// Candidate list size while inserting.
+    let efConstruction: Int
+    /// Candidate list size while searching (raised to `k` when smaller).
+    var efSearch: Int
+
+    /// Storage format of the node vectors.
+    var encoding: VectorCodes.Encoding { vectors.encoding }
+
+    private let levelMultiplier: Double
+    private var rng: SplitMix64
+
+    // MARK: - Storage
+
+    /// Vector length shared by every node (0 while empty).
+    var dimension: Int { vectors.dimension }
+    /// One row of codes per slot.
+    private var vectors: VectorCodes
+    /// Clip ID per slot; nil marks a free (deleted) slot.
+    private var ids: [UUID?] = []
+    private var slotByID: [UUID: Int32] = [:]
+    /// `neighbors[slot][layer]` is the adjacency list of `slot` on `layer`.
+    private var neighbors: [[[Int32]]] = []
+    /// `inEdges[slot][layer]` lists the nodes whose `layer` list contains `slot`.
+    /// Kept in step with `neighbors` by `setEdges`.
+    private var inEdges: [[[Int32]]] = []
+    private var freeSlots: [Int32] = []
+    private var entryPoint: Int32 = -1
+    private var topLayer = -1
+
+    init(
+        encoding: VectorCodes.Encoding = .int8,
+        maxConnections: Int = 16, efConstruction: Int = 100, efSearch: Int = 64, seed: UInt64 = 0x5EED
+    ) {
+        self.vectors = VectorCodes(encoding: encoding)
+        self.maxConnections = max(2, maxConnections)
+        self.efConstruction = max(1, efConstruction)
+        self.efSearch = max(1, efSearch)
+        self.levelMultiplier = 1 / log(Double(self.maxConnections))
+        self.rng = SplitMix64(seed: seed)
+    }
+
+    var count: Int { slotByID.count }
+
+    /// Bytes held by vector codes and scales (graph edges not included).
+    var vectorBytes: Int { vectors.rowCount * vectors.bytesPerRow }
+
+    // MARK: - VectorIndex
+
+    @discardableResult
+    mutating func upsert(_ unit: [Float], for id: UUID) -> Bool {
+        guard !unit.isEmpty else { return false }
+        // An update re-links the node from scratch; its slot is reused below.
+        if slotByID[id] != nil {
+            guard unit.count == dimension else { return false }
+            remove(id)
+        }
+        if count == 0 {
+            reset(dimension: unit.count)
+        }
+        guard unit.count == dimension else { return false }
+        insert(unit, for: id)
+        return true
+    }
+
+    mutating func remove(_ id: UUID) {
+        guard let slot = slotByID.removeValue(forKey: id) else { return }
+        let s = Int(slot)
+        let layers = neighbors[s]
+        let incoming = inEdges[s]
+        for layer in layers.indices {
+            setEdges(of: slot, on: layer, to: [])
+        }
+        ids[s] = nil
+        neighbors[s] = []
+        inEdges[s] = []
+        freeSlots.append(slot)
+
+        guard count > 0 else {
+            reset(dimension: dimension)
+            return
+        }
+
+        // Reconnect every node that pointed at the removed one, including
+        // one-way edges, choosing from its remaining edges plus the removed
+        // node's own neighbours. Nothing points at the freed slot afterwards.
+        for (layer, referrers) in incoming.enumerated() {
+            for n in referrers where isLive(n, on: layer) {
+                var pool = Set(neighbors[Int(n)][layer])
+                pool.remove(slot)
+                for candidate in layers[layer] where candidate != n {
+                    pool.insert(candidate)
+                }
+                setEdges(of: n, on: layer, to: selectNeighbors(of: n, from: pool, on: layer))
+            }
+        }
+
+        if entryPoint == slot {
+            electEntryPoint()
+        }
+    }
+
+    func search(_ unitQuery: [Float], k: Int) -> [VectorHit] {
+        guard count > 0, k > 0, unitQuery.count == dimension else { return [] }
+        let query = vectors.prepare(unitQuery)
+
+        var entry: Candidate = (entryPoint, similarity(entryPoint, to: query))
+        var layer = topLayer
+        while layer > 0 {
+            entry = searchLayer(query, from: entry, ef: 1, layer: layer)[0]
+            layer -= 1
+        }
+
+        let found = searchLayer(query, from: entry, ef: max(efSearch, k), layer: 0)
+        guard vectors.encoding != .float32 else {
+            return found.prefix(k).compactMap { hit(for: $0) }
+        }
+
+        // Re-rank the candidate list with the full-precision query.
+        var reranked = TopKSelector<Int32>(k: k)
+        for candidate in found {
+            reranked.insert(candidate.slot, score: Double(vectors.rescore(row: Int(candidate.slot), query)))
+        }
+        return reranked.sortedDescending().compactMap { hit(for: (slot: $0.element, score: Float($0.score))) }
+    }
+
+    func similarities(of ids: [UUID], to unitQuery: [Float]) -> [Float?] {
+        guard count > 0, unitQuery.count == dimension else { return ids.map { _ in nil } }
+        let query = vectors.prepare(unitQuery)
+        return ids.map { id in slotByID[id].map { vectors.rescore(row: Int($0), query) } }
+    }
+
+    private func hit(for candidate: Candidate) -> VectorHit? {
+        ids[Int(candidate.slot)].map { VectorHit(id: $0, score: candidate.score) }
+    }
+
+    // MARK: - Insertion
+
+    private mutating func insert(_ vector: [Float], for id: UUID) {
+        let level = randomLevel()
+        let slot: Int32
+        if let reused = freeSlots.popLast() {
+            slot = reused
+            vectors.replace(row: Int(slot), with: vector)
+            ids[Int(slot)] = id
+            neighbors[Int(slot)] = Array(repeating: [], count: level + 1)
+            inEdges[Int(slot)] = Array(repeating: [], count: level + 1)
+        } else {
+            slot = Int32(ids.count)
+            vectors.append(vector)
+            ids.append(id)
+            neighbors.append(Array(repeating: [], count: level + 1))
+            inEdges.append(Array(repeating: [], count: level + 1))
+        }
+        slotByID[id] = slot
+
+        guard entryPoint >= 0 else {
+            entryPoint = slot
+            topLayer = level
+            return
+        }
+        let query = vectors.prepare(vector)
+
+        // Greedy descent through the layers above the new node's level.
+        var entry: Candidate = (entryPoint, similarity(entryPoint, to: query))
+        var layer = topLayer
+        while layer > level {
+            entry = searchLayer(query, from: entry, ef: 1, layer: layer)[0]
+            layer -= 1
+        }
+
+        // Link into every layer the node lives on.
+        layer = min(level, topLayer)
+        while layer >= 0 {
+            let found = searchLayer(query, from: entry, ef: efConstruction, layer: layer)
+                .filter { $0.slot != slot }
+            let chosen = selectNeighbors(from: found, limit: maxConnections)
+            setEdges(of: slot, on: layer, to: chosen)
+            for n in chosen {
+                link(n, to: slot, on: layer)
+            }
+            if let best = found.first {
+                entry = best
+            }
+            layer -= 1
+        }
+
+        if level > topLayer {
+            entryPoint = slot
+            topLayer = level
+        }
+    }
+
+    /// Add the edge `node → target`, shrinking the list with the heuristic if it overflows.
+    private mutating func link(_ node: Int32, to target: Int32, on layer: Int) {
+        guard isLive(node, on: layer) else { return }
+        var edges = neighbors[Int(node)][layer]
+        edges.append(target)
+        if edges.count > connectionLimit(on: layer) {
+            edges = selectNeighbors(of: node, from: Set(edges), on: layer)
+        }
+        setEdges(of: node, on: layer, to: edges)
+    }
+
+    /// Replace `node`'s adjacency list on `layer`, updating the in-edge lists
+    /// of the targets it gains and loses.
+    private mutating func setEdges(of node: Int32, on layer: Int, to edges: [Int32]) {
+        let n = Int(node)
+        let old = neighbors[n][layer]
+        for target in old where !edges.contains(target) {
+            let t = Int(target)
+            if layer < inEdges[t].count, let i = inEdges[t][layer].firstIndex(of: node) {
+                inEdges[t][layer].swapAt(i, inEdges[t][layer].count - 1)
+                inEdges[t][layer].removeLast()
+            }
+        }
+        for target in edges where !old.contains(target) {
+            inEdges[Int(target)][layer].append(node)
+        }
+        neighbors[n][layer] = edges
+    }
+
+    // MARK: - Graph Search
+
+    /// Best-first search on one layer. Returns up to `ef` candidates, best first.
+    private func searchLayer(_ query: VectorCodes.Query, from entry: Candidate, ef: Int, layer: Int) -> [Candidate] {
+        var visited: Set<Int32> = [entry.slot]
+        var candidates = CandidateQueue()
+        var results = TopKSelector<Int32>(k: ef)
+        candidates.push(entry)
+        results.insert(entry.slot, score: Double(entry.score))
+
+        while let current = candidates.popBest() {
+            if let worst = results.threshold, Double(current.score) < worst { break }
+            let c = Int(current.slot)
+            guard layer < neighbors[c].count else { continue }
+            for n in neighbors[c][layer] where visited.insert(n).inserted {
+                guard isLive(n, on: layer) else { continue }
+                let score = similarity(n, to: query)
+                if let worst = results.threshold, Double(score) <= worst { continue }
+                candidates.push((n, score))
+                results.insert(n, score: Double(score))
+            }
+        }
+
+        return results.sortedDescending().map { (slot: $0.element, score: Float($0.score)) }
+    }
+
+    /// Neighbour selection heuristic: keep a candidate only if it is closer to the
+    /// base than to every neighbour already kept, then top up with the closest
+    /// pruned ones. `candidates` must be sorted best first.
+    private func selectNeighbors(from candidates: [Candidate], limit: Int) -> [Int32] {
+        var selected: [Int32] = []
+        var pruned: [Int32] = []
+        selected.reserveCapacity(limit)
+        for candidate in candidates {
+            if selected.count >= limit { break }
+            let diverse = selected.allSatisfy { similarity(candidate.slot, $0) <= candidate.score }
+            if diverse {
+                selected.append(candidate.slot)
+            } else {
+                pruned.append(candidate.slot)
+            }
+        }
+        for slot in pruned where selected.count < limit {
+            selected.append(slot)
+        }
+        return selected
+    }
+
+    /// Re-select `node`'s edges on `layer` from `pool`, dropping dead slots.
+    private func selectNeighbors(of node: Int32, from pool: Set<Int32>, on layer: Int) -> [Int32] {
+        let candidates = pool
+            .filter { $0 != node && isLive($0, on: layer) }
+            .map { (slot: $0, score: similarity($0, node)) }
+            .sorted { $0.score > $1.score }
+        return selectNeighbors(from: candidates, limit: connectionLimit(on: layer))
+    }
+
+    // MARK: - Helpers
+
+    private func connectionLimit(on layer: Int) -> Int {
+        layer == 0 ? 2 * maxConnections : maxConnections
+    }
+
+    /// Whether `slot` holds a live node that exists on `layer`.
+    private func isLive(_ slot: Int32, on layer: Int) -> Bool {
+        let s = Int(slot)
+        return ids[s] != nil && layer < neighbors[s].count
+    }
+
+    private func similarity(_ slot: Int32, to query: VectorCodes.Query) -> Float {
+        vectors.score(row: Int(slot), query)
+    }
+
+    private func similarity(_ a: Int32, _ b: Int32) -> Float {
+        vectors.score(row: Int(a), row: Int(b))
+    }
+
+    private mutating func randomLevel() -> Int {
+        let uniform = Double(rng.next() >> 11) * 0x1.0p-53
+        return Int(-log(max(uniform, .leastNonzeroMagnitude)) * levelMultiplier)
+    }
+
+    /// Promote the live node with the most layers after the entry point is removed.
+    private mutating func electEntryPoint() {
+        entryPoint = -1
+        topLayer = -1
+        for slot in slotByID.values where neighbors[Int(slot)].count - 1 > topLayer {
+            entryPoint = slot
+            topLayer = neighbors[Int(slot)].count - 1
+        }
+    }
+
+    private mutating func reset(dimension: Int) {
+        vectors.reset(dimension: dimension)
+        ids = []
+        slotByID = [:]
+        neighbors = []
+        inEdges = []
+        freeSlots = []
+        entryPoint = -1
+        topLayer = -1
+    }
+}
+
+// MARK: - Candidate Queue
+
+/// Max-heap of graph candidates, best score on top.
+private struct CandidateQueue {
+
+    private var heap: [(slot: Int32, score: Float)] = []
+
+    mutating func push(_ candidate: (slot: Int32, score: Float)) {
+        heap.append(candidate)
+        var child = heap.count - 1
+        while child > 0 {
+            let parent = (child - 1) / 2
+            guard heap[child].score > heap[parent].score else { break }
+            heap.swapAt(child, parent)
+            child = parent
+        }
+    }
+
+    mutating func popBest() -> (slot: Int32, score: Float)? {
+        guard !heap.isEmpty else { return nil }
+        heap.swapAt(0, heap.count - 1)
+        let best = heap.removeLast()
+        var parent = 0
+        while true {
+            let left = 2 * parent + 1
+            let right = left + 1
+            var largest = parent
+            if left < heap.count, heap[left].score > heap[largest].score { largest = left }
+            if right < heap.count, heap[right].score > heap[largest].score { largest = right }
+            guard largest != parent else { break }
+            heap.swapAt(parent, largest)
+            parent = largest
+        }
+        return best
+    }
+}
+
+// MARK: - Random Numbers
+
+/// Small seedable generator so index construction is reproducible.
+struct SplitMix64: RandomNumberGenerator {
+
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
@@ -0,0 +1,222 @@
+//
+//  KeywordIndex.swift
+//  treehacks
+//
+//  Incrementally maintained inverted index (term → posting list of clip
+//  slots with term frequencies) over clip keywords and descriptions,
+//  including OCR "text: …" keywords. A keyword query touches only the
+//  posting lists of its own terms instead of re-tokenizing the text of
+//  every clip, and document lengths are tracked for BM25 scoring.
+//
+
+import Foundation
+
+struct KeywordIndex {
+
+    /// Corpus-wide BM25 inputs, so several indexes (e.g. time partitions)
+    /// can score against the statistics of their union.
+    struct CorpusStatistics {
+        var documentCount = 0
+        var totalLength = 0
+        /// Number of documents containing each query term.
+        var documentFrequency: [String: Int] = [:]
+
+        mutating func merge(_ other: CorpusStatistics) {
+            documentCount += other.documentCount
+            totalLength += other.totalLength
+            documentFrequency.merge(other.documentFrequency, uniquingKeysWith: +)
+        }
+    }
+
+    private struct Posting {
+        let slot: Int32
+        var frequency: Int32
+    }
+
+    /// BM25 term-frequency saturation and length normalization.
+    private static let k1 = 1.2
+    private static let b = 0.75
+
+    /// Term → clips containing it, with occurrence counts (unordered).
+    private var postings: [String: [Posting]] = [:]
+    /// Term frequencies indexed for each slot, so removal only touches its own postings.
+    private var termsBySlot: [[String: Int32]] = []
+    /// Total term occurrences per slot (BM25 document length).
+    private var lengthBySlot: [Int32] = []
+    private var totalLength = 0
+    private var idBySlot: [UUID?] = []
+    private var slotByID: [UUID: Int32] = [:]
+    private var freeSlots: [Int32] = []
+
+    var count: Int { slotByID.count }
+
+    // MARK: - Tokenization
+
+    /// Lowercased words longer than two characters, split on whitespace and punctuation.
+    /// Shared by clips and queries so both sides tokenize identically.
+    static func terms(in text: String) -> Set<String> {
+        Set(tokens(in: text))
+    }
+
+    /// Every term occurrence in `text`, in order.
+    private static func tokens(in text: String) -> [String] {
+        text.lowercased()
+            .components(separatedBy: .whitespacesAndNewlines)
+            .flatMap { $0.components(separatedBy: .punctuationCharacters) }
+            .filter { $0.count > 2 }  // Skip tiny words
+    }
+
+    /// Occurrence count of each searchable term of a clip: its keywords plus its description.
+    static func termFrequencies(keywords: Set<String>, description: String) -> [String: Int32] {
+        var result: [String: Int32] = [:]
+        for token in tokens(in: description) {
+            result[token, default: 0] += 1
+        }
+        for keyword in keywords {
+            for token in tokens(in: keyword) {
+                result[token, default: 0] += 1
+            }
+        }
+        return result
+    }
+
+    // MARK: - Mutation
+
+    /// Index (or re-index) a clip's keywords and description.
+    mutating func update(id: UUID, keywords: Set<String>, description: String) {
+        let newTerms = Self.termFrequencies(keywords: keywords, description: description)
+
+        let slot: Int32
+        if let existing = slotByID[id] {
+            slot = existing
+            let oldTerms = termsBySlot[Int(slot)]
+            for term in oldTerms.keys where newTerms[term] == nil {
+                removePosting(slot, for: term)
+            }
+            for (term, frequency) in newTerms {
+                if let old = oldTerms[term] {
+                    if old != frequency {
+                        setFrequency(frequency, of: slot, for: term)
+                    }
+                } else {
+                    postings[term, default: []].append(Posting(slot: slot, frequency: frequency))
+                }
+            }
+        } else {
+            if let reused = freeSlots.popLast() {
+                slot = reused
+                idBySlot[Int(slot)] = id
+            } else {
+                slot = Int32(idBySlot.count)
+                idBySlot.append(id)
+                termsBySlot.append([:])
+                lengthBySlot.append(0)
+            }
+            slotByID[id] = slot
+            for (term, frequency) in newTerms {
+                postings[term, default: []].append(Posting(slot: slot, frequency: frequency))
+            }
+        }
+        termsBySlot[Int(slot)] = newTerms
+        let length = newTerms.values.reduce(0, +)
+        totalLength += Int(length - lengthBySlot[Int(slot)])
+        lengthBySlot[Int(slot)] = length
+    }
+
+    /// Drop a clip and its postings.
+    mutating func remove(_ id: UUID) {
+        guard let slot = slotByID.removeValue(forKey: id) else { return }
+        for term in termsBySlot[Int(slot)].keys {
+            removePosting(slot, for: term)
+        }
+        termsBySlot[Int(slot)] = [:]
+        totalLength -= Int(lengthBySlot[Int(slot)])
+        lengthBySlot[Int(slot)] = 0
+        idBySlot[Int(slot)] = nil
+        freeSlots.append(slot)
+    }
+
+    private mutating func removePosting(_ slot: Int32, for term: String) {
+        // Take the list out so it is uniquely referenced and edited without a copy.
+        guard var list = postings.removeValue(forKey: term) else { return }
+        if let i = list.firstIndex(where: { $0.slot == slot }) {
+            list.swapAt(i, list.count - 1)
+            list.removeLast()
+        }
+        if !list.isEmpty {
+            postings[term] = list
+        }
+    }
+
+    private mutating func setFrequency(_ frequency: Int32, of slot: Int32, for term: String) {
+        guard var list = postings.removeValue(forKey: term) else { return }
+        if let i = list.firstIndex(where: { $0.slot == slot }) {
+            list[i].frequency = frequency
+        }
+        postings[term] = list
+    }
+
+    // MARK: - Query
+
+    /// Number of query terms each matching clip contains.
+    /// Cost is the total length of the query terms' posting lists.
+    func matchCounts(for queryTerms: Set<String>) -> [UUID: Int] {
+        var countsBySlot: [Int32: Int] = [:]
+        for term in queryTerms {
+            guard let list = postings[term] else { continue }
+            for posting in list {
+                countsBySlot[posting.slot, default: 0] += 1
+            }
+        }
+
+        var result: [UUID: Int] = [:]
+        result.reserveCapacity(countsBySlot.count)
+        for (slot, count) in countsBySlot {
+            if let id = idBySlot[Int(slot)] {
+                result[id] = count
+            }
+        }
+        return result
+    }
+
+    /// This index's BM25 statistics for `queryTerms`.
+    func statistics(for queryTerms: Set<String>) -> CorpusStatistics {
+        var stats = CorpusStatistics(documentCount: count, totalLength: totalLength)
+        for term in queryTerms {
+            stats.documentFrequency[term] = postings[term]?.count ?? 0
+        }
+        return stats
+    }
+
+    /// Okapi BM25 score of each clip containing at least one query term.
+    /// Rare terms (such as OCR text) weigh more than ones every clip shares.
+    /// Pass `corpus` to score against statistics wider than this index.
+    func bm25Scores(for queryTerms: Set<String>, corpus: CorpusStatistics? = nil) -> [UUID: Double] {
+        let corpus = corpus ?? statistics(for: queryTerms)
+        guard count > 0, corpus.documentCount > 0 else { return [:] }
+        let documentCount = Double(corpus.documentCount)
+        let averageLength = max(1, Double(corpus.totalLength) / documentCount)
+
+        var scoresBySlot: [Int32: Double] = [:]
+        for term in queryTerms {
+            guard let list = postings[term] else { continue }
+            let matching = Double(corpus.documentFrequency[term] ?? list.count)
+            let idf = log(1 + (documentCount - matching + 0.5) / (matching + 0.5))
+            for posting in list {
+                let tf = Double(posting.frequency)
+                let length = Double(lengthBySlot[Int(posting.slot)])
+                let norm = Self.k1 * (1 - Self.b + Self.b * length / averageLength)
+                scoresBySlot[posting.slot, default: 0] += idf * tf * (Self.k1 + 1) / (tf + norm)
+            }
+        }
+
+        var result: [UUID: Double] = [:]
+        result.reserveCapacity(scoresBySlot.count)
+        for (slot, score) in scoresBySlot {
+            if let id = idBySlot[Int(slot)] {
+                result[id] = score
+            }
+        }
+        return result
+    }
+}
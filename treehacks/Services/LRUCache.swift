@@ -0,0 +1,106 @@
+//
+//  LRUCache.swift
+//  treehacks
+//
+//  Fixed-capacity least-recently-used cache. Entries live in a slot array
+//  threaded by an intrusive doubly linked list, so lookup, promotion and
+//  eviction are O(1) with no per-access allocation. Not thread-safe;
+//  callers provide their own locking.
+//
+
+import Foundation
+
+struct LRUCache<Key: Hashable, Value> {
+
+    private struct Entry {
+        var key: Key
+        var value: Value
+        var previous: Int
+        var next: Int
+    }
+
+    let capacity: Int
+    private var entries: [Entry] = []
+    private var slotByKey: [Key: Int] = [:]
+    /// Most recently used slot (-1 when empty).
+    private var head = -1
+    /// Least recently used slot (-1 when empty).
+    private var tail = -1
+
+    private(set) var hits = 0
+    private(set) var misses = 0
+
+    init(capacity: Int) {
+        self.capacity = max(1, capacity)
+        entries.reserveCapacity(self.capacity)
+        slotByKey.reserveCapacity(self.capacity)
+    }
+
+    var count: Int { entries.count }
+
+    /// Look up `key`, marking it most recently used. Counts a hit or a miss.
+    mutating func value(for key: Key) -> Value? {
+        guard let slot = slotByKey[key] else {
+            misses += 1
+            return nil
+        }
+        hits += 1
+        moveToFront(slot)
+        return entries[slot].value
+    }
+
+    /// Insert or replace `key`, evicting the least recently used entry when full.
+    mutating func insert(_ value: Value, for key: Key) {
+        if let slot = slotByKey[key] {
+            entries[slot].value = value
+            moveToFront(slot)
+            return
+        }
+
+        let slot: Int
+        if entries.count < capacity {
+            slot = entries.count
+            entries.append(Entry(key: key, value: value, previous: -1, next: -1))
+        } else {
+            // Reuse the tail slot for the new entry.
+            slot = tail
+            unlink(slot)
+            slotByKey.removeValue(forKey: entries[slot].key)
+            entries[slot] = Entry(key: key, value: value, previous: -1, next: -1)
+        }
+        slotByKey[key] = slot
+        pushFront(slot)
+    }
+
+    mutating func removeAll() {
+        entries.removeAll(keepingCapacity: true)
+        slotByKey.removeAll(keepingCapacity: true)
+        head = -1
+        tail = -1
+    }
+
+    // MARK: - List
+
+    private mutating func moveToFront(_ slot: Int) {
+        guard slot != head else { return }
+        unlink(slot)
+        pushFront(slot)
+    }
+
+    private mutating func unlink(_ slot: Int) {
+        let previous = entries[slot].previous
+        let next = entries[slot].next
+        if previous >= 0 { entries[previous].next = next } else { head = next }
+        if next >= 0 { entries[next].previous = previous } else { tail = previous }
+        entries[slot].previous = -1
+        entries[slot].next = -1
+    }
+
+    private mutating func pushFront(_ slot: Int) {
+        entries[slot].previous = -1
+        entries[slot].next = head
+        if head >= 0 { entries[head].previous = slot }
+        head = slot
+        if tail < 0 { tail = slot }
+    }
+}
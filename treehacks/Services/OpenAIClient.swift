@@ -15,6 +15,8 @@ struct OpenAIClient {
 
     private static let url = URL(string: "https://api.openai.com/v1/chat/completions")!
     private static let model = "gpt-4o-mini"
+    /// Slightly longer than the default for multi-image requests.
+    static let visionRequestTimeout: TimeInterval = 20
     private static let answerPromptTemplate = """
     Context from what the user recently saw: "%@"
     Question: %@
@@ -33,10 +35,10 @@ struct OpenAIClient {
     Return ONLY the comma-separated keywords, nothing else. Be specific and concrete.
     """
 
-    /// Prompt for multi-image keyword extraction (3 frames from the same clip).
+    /// Prompt for multi-image keyword extraction (several frames from the same clip).
     private static let visionKeywordPromptMulti = """
     You are a keyword tagger for a memory recall app that helps people remember where they placed objects.
-    These images are 3 frames from the same 5-second video clip (beginning, middle, end).
+    These images are frames from the same short video clip, in the order they were captured.
     Look at ALL the images together and list 10-25 comma-separated keywords describing:
     - Every specific OBJECT you can identify across all frames (e.g. keys, phone, wallet, mug, laptop, book)
     - The COLOR of the object (e.g. red, blue, green, yellow, white, black)
@@ -47,6 +49,20 @@ struct OpenAIClient {
     Return ONLY the comma-separated keywords, nothing else. Be specific and concrete.
     """
 
+    /// Prompt for keyword extraction from several clips in one request. Each clip's
+    /// frames follow a "Clip N" label; `%d` is the number of clips.
+    private static let visionKeywordPromptClips = """
+    You are a keyword tagger for a memory recall app that helps people remember where they placed objects.
+    The images below come from %d different short video clips. Each clip's frames follow a "Clip N" label.
+    Tag each clip separately, using only that clip's frames, with 5-15 comma-separated keywords describing:
+    - Every specific OBJECT you can identify (e.g. keys, phone, wallet, mug, laptop, book)
+    - The COLOR of the object (e.g. red, blue, green, yellow, white, black)
+    - The LOCATION or setting (e.g. kitchen table, desk, couch, counter, shelf)
+    - Any visible TEXT (brand names, labels, signs)
+    - Any PEOPLE or ACTIONS (e.g. person sitting, hand holding cup)
+    Return exactly one line per clip in the form "Clip N: keyword, keyword, ...", nothing else.
+    """
+
     // MARK: - API Key
 
     /// Reads OpenAI API key from Secrets.plist in the app bundle. Returns nil if missing.
@@ -111,33 +127,88 @@ struct OpenAIClient {
         var userContent: [[String: Any]] = [
             ["type": "text", "text": prompt]
         ]
-        for jpegData in jpegImages {
-            let base64Image = jpegData.base64EncodedString()
-            userContent.append([
-                "type": "image_url",
-                "image_url": [
-                    "url": "data:image/jpeg;base64,\(base64Image)",
-                    "detail": "low"  // Use low detail to minimize tokens/cost
-                ]
-            ])
+        userContent += jpegImages.map(imageContent)
+
+        print("[OpenAIClient] Sending vision request with \(jpegImages.count) image(s)...")
+        // More tokens for richer keywords from 3 images
+        guard let content = try await visionCompletion(apiKey: apiKey, content: userContent, maxTokens: 200) else {
+            return nil
+        }
+        let keywords = parseKeywords(content)
+        print("[OpenAIClient] Vision keywords (\(keywords.count)): \(keywords)")
+        return keywords.isEmpty ? nil : keywords
+    }
+
+    /// Describes several clips in one API call. `clips` holds each clip's JPEG frames;
+    /// the result holds each clip's keywords, in the same order and empty for a clip
+    /// the response skipped. Returns nil if no API key is configured or the request fails.
+    static func describeClips(_ clips: [[Data]]) async throws -> [[String]]? {
+        guard !clips.isEmpty else { return nil }
+        if clips.count == 1 {
+            return try await describeImages(clips[0]).map { [$0] }
+        }
+        guard let apiKey = loadAPIKey() else {
+            print("[OpenAIClient] No API key, skipping vision")
+            return nil
+        }
+
+        var userContent: [[String: Any]] = [
+            ["type": "text", "text": String(format: visionKeywordPromptClips, clips.count)]
+        ]
+        for (i, images) in clips.enumerated() {
+            userContent.append(["type": "text", "text": "Clip \(i + 1)"])
+            userContent += images.map(imageContent)
         }
 
+        let imageCount = clips.reduce(0) { $0 + $1.count }
+        print("[OpenAIClient] Sending vision request for \(clips.count) clips with \(imageCount) image(s)...")
+        guard let content = try await visionCompletion(apiKey: apiKey, content: userContent,
+                                                       maxTokens: 120 * clips.count) else {
+            return nil
+        }
+
+        // "Clip N: a, b, c" lines; anything else is ignored.
+        var keywords = [[String]](repeating: [], count: clips.count)
+        for line in content.components(separatedBy: .newlines) {
+            let parts = line.split(separator: ":", maxSplits: 1)
+            guard parts.count == 2 else { continue }
+            let label = parts[0].trimmingCharacters(in: CharacterSet(charactersIn: " *-#")).lowercased()
+            guard label.hasPrefix("clip"),
+                  let number = Int(label.dropFirst(4).trimmingCharacters(in: .whitespaces)),
+                  keywords.indices.contains(number - 1) else { continue }
+            keywords[number - 1] = parseKeywords(String(parts[1]))
+        }
+        print("[OpenAIClient] Vision keywords for \(keywords.filter { !$0.isEmpty }.count)/\(clips.count) clips")
+        return keywords
+    }
+
+    private static func imageContent(_ jpegData: Data) -> [String: Any] {
+        [
+            "type": "image_url",
+            "image_url": [
+                "url": "data:image/jpeg;base64,\(jpegData.base64EncodedString())",
+                "detail": "low"  // Use low detail to minimize tokens/cost
+            ]
+        ]
+    }
+
+    /// Sends one multimodal user message and returns the reply text, or nil on failure.
+    private static func visionCompletion(apiKey: String, content: [[String: Any]], maxTokens: Int) async throws -> String? {
         var request = URLRequest(url: url)
         request.httpMethod = "POST"
         request.setValue("Bearer \(apiKey)", forHTTPHeaderField: "Authorization")
         request.setValue("application/json", forHTTPHeaderField: "Content-Type")
-        request.timeoutInterval = 20  // Slightly longer for multiple images
+        request.timeoutInterval = visionRequestTimeout
 
         let body: [String: Any] = [
             "model": model,
             "messages": [
-                ["role": "user", "content": userContent]
+                ["role": "user", "content": content]
             ],
-            "max_tokens": 200  // More tokens for richer keywords from 3 images
+            "max_tokens": maxTokens
         ]
         request.httpBody = try JSONSerialization.data(withJSONObject: body)
 
-        print("[OpenAIClient] Sending vision request with \(jpegImages.count) image(s)...")
         let (data, response) = try await URLSession.shared.data(for: request)
         guard let http = response as? HTTPURLResponse else {
             print("[OpenAIClient] Vision: no HTTP response")
@@ -159,15 +230,15 @@ struct OpenAIClient {
             print("[OpenAIClient] Vision: could not parse response")
             return nil
         }
+        return content
+    }
 
-        // Parse comma-separated keywords from the response
-        let keywords = content
+    /// Parse comma-separated keywords from a response.
+    private static func parseKeywords(_ content: String) -> [String] {
+        content
             .components(separatedBy: ",")
             .map { $0.trimmingCharacters(in: .whitespacesAndNewlines).lowercased() }
             .filter { !$0.isEmpty && $0.count > 1 }
-
-        print("[OpenAIClient] Vision keywords (\(keywords.count)): \(keywords)")
-        return keywords.isEmpty ? nil : keywords
     }
 
     /// Convenience: send a single image.
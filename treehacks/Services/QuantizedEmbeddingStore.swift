@@ -0,0 +1,96 @@
+//
+//  QuantizedEmbeddingStore.swift
+//  treehacks
+//
+//  Exact-scan `VectorIndex` over int8 or Float16 codes. Every row is
+//  scored on its codes; the best `rerankCount` candidates can then be
+//  re-ranked against the unquantized query to recover the ordering that
+//  quantization blurs.
+//
+
+import Foundation
+
+struct QuantizedEmbeddingStore: VectorIndex {
+
+    /// Candidates re-ranked with the full-precision query (0 disables re-ranking).
+    var rerankCount: Int
+
+    private var codes: VectorCodes
+    private var rowIDs: [UUID] = []
+    private var rowByID: [UUID: Int] = [:]
+
+    init(encoding: VectorCodes.Encoding = .int8, rerankCount: Int = 32) {
+        codes = VectorCodes(encoding: encoding)
+        self.rerankCount = max(0, rerankCount)
+    }
+
+    var count: Int { rowIDs.count }
+    var encoding: VectorCodes.Encoding { codes.encoding }
+
+    /// Bytes held by vector codes and scales.
+    var vectorBytes: Int { count * codes.bytesPerRow }
+
+    // MARK: - VectorIndex
+
+    @discardableResult
+    mutating func upsert(_ unit: [Float], for id: UUID) -> Bool {
+        guard !unit.isEmpty else { return false }
+        if count == 0 { codes.reset(dimension: unit.count) }
+        guard unit.count == codes.dimension else { return false }
+
+        if let row = rowByID[id] {
+            codes.replace(row: row, with: unit)
+        } else {
+            rowByID[id] = rowIDs.count
+            rowIDs.append(id)
+            codes.append(unit)
+        }
+        return true
+    }
+
+    /// Remove the row for `id`, moving the last row into its place to keep storage dense.
+    mutating func remove(_ id: UUID) {
+        guard let row = rowByID.removeValue(forKey: id) else { return }
+        let last = rowIDs.count - 1
+        if row != last {
+            let movedID = rowIDs[last]
+            rowIDs[row] = movedID
+            rowByID[movedID] = row
+            codes.copyRow(last, to: row)
+        }
+        rowIDs.removeLast()
+        codes.removeLast()
+    }
+
+    func search(_ unitQuery: [Float], k: Int) -> [VectorHit] {
+        guard count > 0, k > 0, unitQuery.count == codes.dimension else { return [] }
+        let query = codes.prepare(unitQuery)
+
+        var candidates = TopKSelector<Int>(k: max(k, rerankCount))
+        for row in 0..<count {
+            let score = Double(codes.score(row: row, query))
+            if let worst = candidates.threshold, score <= worst { continue }
+            candidates.insert(row, score: score)
+        }
+
+        guard rerankCount > 0, codes.encoding != .float32 else {
+            return candidates.sortedDescending().prefix(k).map {
+                VectorHit(id: rowIDs[$0.element], score: Float($0.score))
+            }
+        }
+
+        var reranked = TopKSelector<Int>(k: k)
+        for candidate in candidates.sortedDescending() {
+            reranked.insert(candidate.element, score: Double(codes.rescore(row: candidate.element, query)))
+        }
+        return reranked.sortedDescending().map {
+            VectorHit(id: rowIDs[$0.element], score: Float($0.score))
+        }
+    }
+
+    func similarities(of ids: [UUID], to unitQuery: [Float]) -> [Float?] {
+        guard count > 0, unitQuery.count == codes.dimension else { return ids.map { _ in nil } }
+        let query = codes.prepare(unitQuery)
+        return ids.map { id in rowByID[id].map { codes.rescore(row: $0, query) } }
+    }
+}
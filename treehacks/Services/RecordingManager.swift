@@ -9,97 +9,42 @@ import AVFoundation
 import Combine
 import Foundation
 
-/// Manages rolling video recording in 30-second segments.
-/// Keeps the last N segments (configurable, default 5 minutes worth).
-/// Provides time-based retrieval for memory recall playback.
-class RecordingManager: NSObject, ObservableObject {
+/// The rolling recall buffer: the last 5 minutes of fragments saved by the
+/// camera's FragmentedRecorder, the same files ClipManager indexes as clips.
+/// The recorder writes and deletes the files; this keeps them in a
+/// RecordingTimeline for time-based retrieval and stitched playback during
+/// memory recall.
+class RecordingManager: ObservableObject {
 
     // MARK: - Configuration
 
-    /// Duration of each recording segment in seconds
-    let segmentDuration: TimeInterval = 30
-
     /// Maximum total duration of recordings to keep (seconds)
-    let maxTotalDuration: TimeInterval = 300 // 5 minutes
+    let maxTotalDuration: TimeInterval
 
     // MARK: - Published State
 
-    @Published var isRecording = false
     @Published var segments: [RecordingSegment] = []
     @Published var oldestAvailableDate: Date?
     @Published var totalRecordedDuration: TimeInterval = 0
 
     // MARK: - Private
 
-    private weak var cameraManager: CameraManager?
-    private var currentSegment: RecordingSegment?
-    private var segmentTimer: Timer?
-    private let recordingsDirectory: URL
+    private let timeline = RecordingTimeline()
+    private var fragmentSubscription: AnyCancellable?
 
     // MARK: - Init
 
-    init(cameraManager: CameraManager) {
-        self.cameraManager = cameraManager
-
-        // Create recordings directory
-        let docs = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first!
-        self.recordingsDirectory = docs.appendingPathComponent("recordings", isDirectory: true)
-
-        super.init()
-
-        // Create directory if needed
-        try? FileManager.default.createDirectory(at: recordingsDirectory, withIntermediateDirectories: true)
-
-        // Set ourselves as the recording delegate
-        cameraManager.recordingDelegate = self
-
-        // Clean up old recordings from previous sessions
-        cleanupOldFiles()
-    }
-
-    // MARK: - Recording Control
-
-    func startRollingRecording() {
-        guard !isRecording else { return }
-        isRecording = true
-        startNewSegment()
-        scheduleSegmentRotation()
-    }
-
-    func stopRollingRecording() {
-        isRecording = false
-        segmentTimer?.invalidate()
-        segmentTimer = nil
-        cameraManager?.stopRecording()
-    }
-
-    // MARK: - Segment Management
-
-    private func startNewSegment() {
-        let timestamp = Date()
-        let fileName = "segment_\(Int(timestamp.timeIntervalSince1970)).mov"
-        let fileURL = recordingsDirectory.appendingPathComponent(fileName)
-
-        currentSegment = RecordingSegment(fileURL: fileURL, startTime: timestamp)
-        cameraManager?.startRecording(to: fileURL)
-    }
-
-    private func scheduleSegmentRotation() {
-        segmentTimer?.invalidate()
-        segmentTimer = Timer.scheduledTimer(withTimeInterval: segmentDuration, repeats: true) { [weak self] _ in
-            self?.rotateSegment()
-        }
-    }
-
-    private func rotateSegment() {
-        // Stop current recording (will trigger delegate callback)
-        cameraManager?.stopRecording()
-
-        // Start new segment after a brief delay to allow file finalization
-        DispatchQueue.main.asyncAfter(deadline: .now() + 0.5) { [weak self] in
-            guard let self = self, self.isRecording else { return }
-            self.startNewSegment()
-        }
+    init(recorder: FragmentedRecorder) {
+        maxTotalDuration = recorder.retention
+        fragmentSubscription = recorder.fragments
+            .receive(on: DispatchQueue.main)
+            .sink { [weak self] fragment in
+                self?.timeline.insert(fragment)
+                self?.pruneOldSegments()
+            }
+        // The timeline ignores fragments it already has from this snapshot.
+        recorder.savedFragments.forEach(timeline.insert)
+        updateMetadata()
     }
 
     // MARK: - Retrieval
@@ -112,43 +57,26 @@ class RecordingManager: NSObject, ObservableObject {
         return getRecording(at: targetDate)
     }
 
+    /// Map a past time to the fragment holding it and the media time to seek to.
+    /// Fragments tile the recording, so every time from the oldest fragment's
+    /// start to the newest one's end resolves; a time in a gap where recording
+    /// was stopped snaps forward to the next fragment's first frame. Times in the
+    /// last few seconds are not saved yet and return nil until their fragment is.
     func getRecording(at date: Date) -> (url: URL, seekTime: TimeInterval)? {
-        // Find the segment that contains this date
-        for segment in segments {
-            let endTime = segment.endTime ?? Date()
-            if date >= segment.startTime && date <= endTime {
-                let seekTime = date.timeIntervalSince(segment.startTime)
-                // Verify file exists
-                if FileManager.default.fileExists(atPath: segment.fileURL.path) {
-                    return (segment.fileURL, seekTime)
-                }
-            }
-        }
-        return nil
+        timeline.recording(at: date)
     }
 
     /// Get all segment URLs in chronological order for continuous playback from a given time.
     func getRecordings(from secondsAgo: TimeInterval) -> [(url: URL, seekTime: TimeInterval)] {
-        let targetDate = Date().addingTimeInterval(-secondsAgo)
-        var results: [(url: URL, seekTime: TimeInterval)] = []
-
-        let sortedSegments = segments.sorted { $0.startTime < $1.startTime }
-
-        for segment in sortedSegments {
-            let endTime = segment.endTime ?? Date()
-            guard FileManager.default.fileExists(atPath: segment.fileURL.path) else { continue }
-
-            if segment.startTime <= targetDate && targetDate <= endTime {
-                // This is the first segment - seek into it
-                let seekTime = targetDate.timeIntervalSince(segment.startTime)
-                results.append((segment.fileURL, seekTime))
-            } else if segment.startTime > targetDate {
-                // Subsequent segments - play from beginning
-                results.append((segment.fileURL, 0))
-            }
-        }
+        timeline.recordings(from: Date().addingTimeInterval(-secondsAgo))
+    }
 
-        return results
+    /// A player item stitching the whole buffer and the time in it to seek to.
+    /// Playback continues across fragments, and seeking to any other time in the
+    /// buffer is a seek within the same item. Nil while the fragment holding
+    /// that time is still being added; fall back to `getRecording(secondsAgo:)`.
+    func playback(secondsAgo: TimeInterval) -> (item: AVPlayerItem, seekTime: CMTime)? {
+        timeline.playback(at: Date().addingTimeInterval(-secondsAgo))
     }
 
     /// Maximum seconds we can go back
@@ -159,72 +87,15 @@ class RecordingManager: NSObject, ObservableObject {
 
     // MARK: - Cleanup
 
+    /// Forget segments the recorder has deleted.
     private func pruneOldSegments() {
-        let cutoff = Date().addingTimeInterval(-maxTotalDuration)
-        let old = segments.filter { $0.startTime < cutoff }
-
-        for segment in old {
-            try? FileManager.default.removeItem(at: segment.fileURL)
-        }
-
-        segments.removeAll { $0.startTime < cutoff }
+        timeline.removeSegments(endingBefore: Date().addingTimeInterval(-maxTotalDuration))
         updateMetadata()
     }
 
-    private func cleanupOldFiles() {
-        // Remove any leftover recording files from previous sessions
-        guard let files = try? FileManager.default.contentsOfDirectory(
-            at: recordingsDirectory,
-            includingPropertiesForKeys: nil
-        ) else { return }
-
-        for file in files {
-            try? FileManager.default.removeItem(at: file)
-        }
-    }
-
     private func updateMetadata() {
+        segments = timeline.segments
         oldestAvailableDate = segments.first?.startTime
         totalRecordedDuration = segments.reduce(0) { $0 + $1.duration }
     }
 }
-
-// MARK: - AVCaptureFileOutputRecordingDelegate
-
-extension RecordingManager: AVCaptureFileOutputRecordingDelegate {
-    func fileOutput(
-        _ output: AVCaptureFileOutput,
-        didStartRecordingTo fileURL: URL,
-        from connections: [AVCaptureConnection]
-    ) {
-        DispatchQueue.main.async {
-            // Segment recording started
-        }
-    }
-
-    func fileOutput(
-        _ output: AVCaptureFileOutput,
-        didFinishRecordingTo outputFileURL: URL,
-        from connections: [AVCaptureConnection],
-        error: Error?
-    ) {
-        DispatchQueue.main.async { [weak self] in
-            guard let self = self else { return }
-
-            if let error = error {
-                print("Recording error: \(error.localizedDescription)")
-                return
-            }
-
-            // Finalize the current segment
-            if var segment = self.currentSegment, segment.fileURL == outputFileURL {
-                segment.endTime = Date()
-                self.segments.append(segment)
-                self.currentSegment = nil
-            }
-
-            // Prune old segments
-            self.pruneOldSegments()
-        }
-    }
-}
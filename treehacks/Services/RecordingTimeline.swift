@@ -0,0 +1,283 @@
+//
+//  RecordingTimeline.swift
+//  treehacks
+//
+//  The recall buffer's fragments sorted by start time, so a past time
+//  resolves to its fragment with a binary search instead of a scan with a
+//  file check per fragment (the recorder owns the files, and a fragment
+//  is listed exactly while its file exists). Alongside, each fragment's
+//  video is appended to one AVMutableComposition as it arrives, and its
+//  range is cut out again when it expires. Recall playback gets a copy of
+//  that prepared composition, so seeking across fragment boundaries is a
+//  seek within one item rather than a new player per file. Fragments
+//  recorded in different device orientations carry different transforms,
+//  so the copy plays through a video composition that turns each
+//  fragment's range upright.
+//
+
+import AVFoundation
+import Foundation
+
+final class RecordingTimeline {
+
+    private struct Entry {
+        let segment: RecordingSegment
+
+        var end: Date { segment.endTime ?? segment.startTime }
+    }
+
+    /// A fragment's current time range in the composition, and how to show it upright.
+    private struct Placement {
+        let id: UUID
+        let end: Date
+        var range: CMTimeRange
+        let transform: CGAffineTransform
+        let naturalSize: CGSize
+    }
+
+    /// Fragments by start time. Guarded by `lock`.
+    private let lock = NSLock()
+    private var entries: [Entry] = []
+
+    // Composition state below is only touched on `queue`.
+    private let queue = DispatchQueue(label: "com.treehacks.recordingTimeline", qos: .utility)
+    private let composition = AVMutableComposition()
+    private let videoTrack: AVMutableCompositionTrack?
+    /// Fragments in the composition, in composition order.
+    private var placements: [Placement] = []
+    /// Current composition length.
+    private var compositionEnd = CMTime.zero
+    /// Fragments waiting for their track to load, oldest first.
+    private var waiting: [RecordingSegment] = []
+    private var isLoading = false
+
+    init() {
+        videoTrack = composition.addMutableTrack(withMediaType: .video, preferredTrackID: kCMPersistentTrackID_Invalid)
+    }
+
+    var segments: [RecordingSegment] {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.map(\.segment)
+    }
+
+    // MARK: - Updates
+
+    /// Add a saved fragment and queue it for the composition.
+    func insert(_ segment: RecordingSegment) {
+        lock.lock()
+        let i = insertionPoint(for: segment.startTime)
+        let isDuplicate = i < entries.count && entries[i].segment.startTime == segment.startTime
+        if !isDuplicate {
+            entries.insert(Entry(segment: segment), at: i)
+        }
+        lock.unlock()
+        guard !isDuplicate else { return }
+
+        queue.async {
+            self.waiting.append(segment)
+            self.loadNext()
+        }
+    }
+
+    /// Drop fragments that ended before `cutoff`, cutting their video out of the composition.
+    func removeSegments(endingBefore cutoff: Date) {
+        lock.lock()
+        let expired = entries.prefix { $0.end < cutoff }.count
+        entries.removeFirst(expired)
+        lock.unlock()
+        guard expired > 0 else { return }
+
+        queue.async {
+            self.waiting.removeAll { ($0.endTime ?? $0.startTime) < cutoff }
+            // Remove exactly the expired ranges, newest first, so the ranges of
+            // earlier placements stay valid; later ones shift back by each cut.
+            for i in self.placements.indices.reversed() where self.placements[i].end < cutoff {
+                let range = self.placements.remove(at: i).range
+                self.composition.removeTimeRange(range)
+                for j in i..<self.placements.count {
+                    self.placements[j].range.start = self.placements[j].range.start - range.duration
+                }
+                self.compositionEnd = self.compositionEnd - range.duration
+            }
+        }
+    }
+
+    // MARK: - Lookup
+
+    /// The fragment holding `date` and the media time in its file. Ranges are
+    /// half-open; a time in a gap snaps forward to the next fragment's first frame.
+    func recording(at date: Date) -> (url: URL, seekTime: TimeInterval)? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let i = entryIndex(containing: date) else { return nil }
+        let segment = entries[i].segment
+        return (segment.fileURL, segment.mediaStartTime + offset(of: date, in: segment))
+    }
+
+    /// The fragment holding `date` and every later one, for playing on from `date`.
+    func recordings(from date: Date) -> [(url: URL, seekTime: TimeInterval)] {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let first = entryIndex(containing: date) else { return [] }
+        return entries[first...].map { entry in
+            (entry.segment.fileURL, entry.segment.mediaStartTime + offset(of: date, in: entry.segment))
+        }
+    }
+
+    /// A player item over every fragment inserted so far and the time in it for
+    /// `date`, or nil when `date`'s fragment is not in the composition yet.
+    func playback(at date: Date) -> (item: AVPlayerItem, seekTime: CMTime)? {
+        queue.sync {
+            lock.lock()
+            let entry = entryIndex(containing: date).map { entries[$0] }
+            lock.unlock()
+            guard let entry = entry,
+                  let placement = placements.first(where: { $0.id == entry.segment.id }),
+                  let snapshot = composition.copy() as? AVComposition else { return nil }
+            let into = CMTime(seconds: offset(of: date, in: entry.segment), preferredTimescale: 600)
+            let item = AVPlayerItem(asset: snapshot)
+            item.videoComposition = uprightComposition()
+            return (item, placement.range.start + min(into, placement.range.duration))
+        }
+    }
+
+    // MARK: - Search
+
+    /// Position of the first entry starting at or after `start`. Caller holds `lock`.
+    private func insertionPoint(for start: Date) -> Int {
+        var low = 0
+        var high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            if entries[mid].segment.startTime < start {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low
+    }
+
+    /// The first entry ending after `date`, if `date` is within the timeline.
+    /// Fragments do not overlap, so end times are sorted too. Caller holds `lock`.
+    private func entryIndex(containing date: Date) -> Int? {
+        guard let first = entries.first, date >= first.segment.startTime else { return nil }
+        var low = 0
+        var high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            if entries[mid].end <= date {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low < entries.count ? low : nil
+    }
+
+    private func offset(of date: Date, in segment: RecordingSegment) -> TimeInterval {
+        max(0, date.timeIntervalSince(segment.startTime))
+    }
+
+    // MARK: - Composition
+
+    /// Load the oldest waiting fragment's track and append it (queue only).
+    /// One at a time, so fragments enter the composition in arrival order.
+    private func loadNext() {
+        guard !isLoading, !waiting.isEmpty else { return }
+        let segment = waiting.removeFirst()
+        isLoading = true
+
+        Task {
+            let asset = AVURLAsset(url: segment.fileURL)
+            let source = try? await asset.loadTracks(withMediaType: .video).first
+            let properties = try? await source?.load(.preferredTransform, .naturalSize)
+            self.queue.async {
+                if !self.append(segment, from: source, transform: properties?.0 ?? .identity,
+                                naturalSize: properties?.1 ?? .zero) {
+                    self.drop(segment)
+                }
+                self.isLoading = false
+                self.loadNext()
+            }
+        }
+    }
+
+    /// Append `segment`'s video at the end of the composition. Returns false
+    /// if it could not be added.
+    private func append(_ segment: RecordingSegment, from source: AVAssetTrack?,
+                        transform: CGAffineTransform, naturalSize: CGSize) -> Bool {
+        guard let videoTrack = videoTrack, let source = source, let end = segment.endTime else { return false }
+        // Expired while its track was loading.
+        lock.lock()
+        let i = insertionPoint(for: segment.startTime)
+        let isListed = i < entries.count && entries[i].segment.id == segment.id
+        lock.unlock()
+        guard isListed else { return true }
+
+        let range = CMTimeRange(
+            start: CMTime(seconds: segment.mediaStartTime, preferredTimescale: 600),
+            duration: CMTime(seconds: end.timeIntervalSince(segment.startTime), preferredTimescale: 600)
+        )
+        do {
+            try videoTrack.insertTimeRange(range, of: source, at: compositionEnd)
+        } catch {
+            print("[RecordingTimeline] Failed to add fragment to composition: \(error)")
+            return false
+        }
+
+        placements.append(Placement(id: segment.id, end: end,
+                                    range: CMTimeRange(start: compositionEnd, duration: range.duration),
+                                    transform: transform, naturalSize: naturalSize))
+        compositionEnd = compositionEnd + range.duration
+        return true
+    }
+
+    /// One instruction per fragment, applying its own transform, fitted to a
+    /// frame oriented like the newest fragment (queue only). Placements tile
+    /// the composition, so the instructions cover it without gaps.
+    private func uprightComposition() -> AVVideoComposition? {
+        guard let videoTrack = videoTrack, let newest = placements.last else { return nil }
+        let renderSize = Self.orientedBounds(of: newest).size
+        guard renderSize.width > 0, renderSize.height > 0 else { return nil }
+
+        let instructions: [AVMutableVideoCompositionInstruction] = placements.map { placement in
+            let bounds = Self.orientedBounds(of: placement)
+            let scale = bounds.width > 0 && bounds.height > 0
+                ? min(renderSize.width / bounds.width, renderSize.height / bounds.height) : 1
+            let fitted = placement.transform
+                .concatenating(CGAffineTransform(translationX: -bounds.minX, y: -bounds.minY))
+                .concatenating(CGAffineTransform(scaleX: scale, y: scale))
+                .concatenating(CGAffineTransform(translationX: (renderSize.width - bounds.width * scale) / 2,
+                                                 y: (renderSize.height - bounds.height * scale) / 2))
+            let layer = AVMutableVideoCompositionLayerInstruction(assetTrack: videoTrack)
+            layer.setTransform(fitted, at: placement.range.start)
+            let instruction = AVMutableVideoCompositionInstruction()
+            instruction.timeRange = placement.range
+            instruction.layerInstructions = [layer]
+            return instruction
+        }
+
+        let videoComposition = AVMutableVideoComposition()
+        videoComposition.renderSize = renderSize
+        videoComposition.frameDuration = CMTime(value: 1, timescale: 30)
+        videoComposition.instructions = instructions
+        return videoComposition
+    }
+
+    private static func orientedBounds(of placement: Placement) -> CGRect {
+        CGRect(origin: .zero, size: placement.naturalSize).applying(placement.transform)
+    }
+
+    /// Unlist a fragment whose video never made it into the composition, so
+    /// lookups do not resolve to a time recall cannot play.
+    private func drop(_ segment: RecordingSegment) {
+        lock.lock()
+        let i = insertionPoint(for: segment.startTime)
+        if i < entries.count && entries[i].segment.id == segment.id {
+            entries.remove(at: i)
+        }
+        lock.unlock()
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  SceneChangeDetector.swift
+//  treehacks
+//
+//  Cheap scene-change gate for the clip pipeline. Each checked frame is
+//  box-filtered to a 9×8 luma thumbnail by the ImageKernels SIMD
+//  downscale, then compared with the last frame that was analyzed: a
+//  difference hash (`ik_dhash`) catches layout changes and the mean luma
+//  difference catches lighting changes the hash ignores. While neither
+//  moves, the scene is static and Vision analysis and vision enhancement
+//  can be skipped.
+//
+
+import CoreVideo
+import Foundation
+import ImageKernels
+
+struct SceneChangeDetector {
+
+    /// Compact description of a frame.
+    struct Signature {
+        /// Bit `r * 8 + c` is set when thumbnail cell (r, c) is brighter than (r, c + 1).
+        let hash: UInt64
+        /// 9×8 luma thumbnail, row-major.
+        let luma: [UInt8]
+    }
+
+    /// Work the gate avoided, for debug display.
+    struct Stats {
+        var framesChecked = 0
+        var staticFrames = 0
+        /// Classification and text-recognition requests not run.
+        var visionCallsSaved = 0
+        /// Clips whose scene never changed, so were not sent for enhancement.
+        var openAIRequestsSaved = 0
+    }
+
+    static let thumbnailWidth = 9
+    static let thumbnailHeight = 8
+
+    /// Hash bits that must differ for a change.
+    var hashThreshold = 10
+    /// Mean absolute luma difference (0–255) that counts as a change.
+    var lumaThreshold = 12
+
+    private var reference: Signature?
+
+    /// Whether `signature` differs from the last changed frame. A changed frame
+    /// becomes the new reference, so slow drift still registers once it adds up.
+    mutating func isChange(_ signature: Signature) -> Bool {
+        guard let reference = reference else {
+            self.reference = signature
+            return true
+        }
+        let bits = (signature.hash ^ reference.hash).nonzeroBitCount
+        var lumaDifference = 0
+        for (a, b) in zip(signature.luma, reference.luma) {
+            lumaDifference += abs(Int(a) - Int(b))
+        }
+        let changed = bits >= hashThreshold
+            || lumaDifference >= lumaThreshold * signature.luma.count
+        if changed {
+            self.reference = signature
+        }
+        return changed
+    }
+
+    /// Forget the reference, so the next frame counts as a change.
+    mutating func reset() {
+        reference = nil
+    }
+
+    // MARK: - Signatures
+
+    /// Signature of a bi-planar YCbCr (ARKit's capture format) or 32BGRA frame;
+    /// nil for other formats or frames smaller than the thumbnail.
+    static func signature(of pixelBuffer: CVPixelBuffer) -> Signature? {
+        CVPixelBufferLockBaseAddress(pixelBuffer, .readOnly)
+        defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, .readOnly) }
+
+        var luma = [UInt8](repeating: 0, count: thumbnailWidth * thumbnailHeight)
+        let status: Int32 = luma.withUnsafeMutableBufferPointer { luma in
+            switch CVPixelBufferGetPixelFormatType(pixelBuffer) {
+            case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange, kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange:
+                guard let base = CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, 0) else { return -1 }
+                return ik_downscale_box(base.assumingMemoryBound(to: UInt8.self),
+                                        CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, 0),
+                                        CVPixelBufferGetWidthOfPlane(pixelBuffer, 0),
+                                        CVPixelBufferGetHeightOfPlane(pixelBuffer, 0), 1,
+                                        luma.baseAddress, thumbnailWidth, thumbnailWidth, thumbnailHeight)
+            case kCVPixelFormatType_32BGRA:
+                guard let base = CVPixelBufferGetBaseAddress(pixelBuffer) else { return -1 }
+                // Average the pixels, then take the luma of each cell.
+                var cells = [UInt8](repeating: 0, count: thumbnailWidth * thumbnailHeight * 4)
+                return cells.withUnsafeMutableBufferPointer { cells in
+                    let status = ik_downscale_box(base.assumingMemoryBound(to: UInt8.self),
+                                                  CVPixelBufferGetBytesPerRow(pixelBuffer),
+                                                  CVPixelBufferGetWidth(pixelBuffer),
+                                                  CVPixelBufferGetHeight(pixelBuffer), 4,
+                                                  cells.baseAddress, thumbnailWidth * 4, thumbnailWidth, thumbnailHeight)
+                    ik_bgra_to_luma(cells.baseAddress, thumbnailWidth * 4,
+                                    luma.baseAddress, thumbnailWidth, thumbnailWidth, thumbnailHeight)
+                    return status
+                }
+            default:
+                return -1
+            }
+        }
+        return status == 0 ? signature(ofThumbnail: luma) : nil
+    }
+
+    /// dHash of a row-major 9×8 luma thumbnail. `ik_dhash` box-filters its
+    /// input to 9×8 first, a no-op here, so this equals the hash of the frame.
+    static func signature(ofThumbnail luma: [UInt8]) -> Signature {
+        let hash = luma.withUnsafeBufferPointer {
+            ik_dhash($0.baseAddress, thumbnailWidth, thumbnailWidth, thumbnailHeight)
+        }
+        return Signature(hash: hash, luma: luma)
+    }
+}
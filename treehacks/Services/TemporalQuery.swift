@@ -0,0 +1,158 @@
+//
+//  TemporalQuery.swift
+//  treehacks
+//
+//  Splits a spoken search query into what to look for and when, e.g.
+//  "where did I put my keys this morning" → text "where did I put my
+//  keys", range 05:00–12:00 today. Amounts may be digits or number words
+//  ("2 hours ago", "three days ago"). Only the first time phrase is used;
+//  queries without one search all history.
+//
+
+import Foundation
+
+struct TemporalQuery {
+
+    /// The query with its time phrase removed.
+    let text: String
+    /// When matching clips must have ended, or nil for any time.
+    let range: DateInterval?
+
+    init(_ query: String, now: Date = Date(), calendar: Calendar = .current) {
+        for rule in Self.rules {
+            guard let match = rule.pattern.firstMatch(
+                in: query, range: NSRange(query.startIndex..., in: query)),
+                  let phrase = Range(match.range, in: query),
+                  let range = rule.range(match, query, now, calendar) else { continue }
+            let remainder = query.replacingCharacters(in: phrase, with: " ")
+                .components(separatedBy: .whitespacesAndNewlines)
+                .filter { !$0.isEmpty }
+                .joined(separator: " ")
+            // A query that is only a time phrase ("what happened just now") keeps its words.
+            text = KeywordIndex.terms(in: remainder).isEmpty ? query : remainder
+            self.range = range
+            return
+        }
+        text = query
+        range = nil
+    }
+
+    // MARK: - Rules
+
+    private struct Rule {
+        let pattern: NSRegularExpression
+        let range: (NSTextCheckingResult, String, Date, Calendar) -> DateInterval?
+
+        init(_ pattern: String, range: @escaping (NSTextCheckingResult, String, Date, Calendar) -> DateInterval?) {
+            // Patterns are literals; a bad one is a programming error.
+            self.pattern = try! NSRegularExpression(pattern: "\\b(?:" + pattern + ")\\b", options: [.caseInsensitive])
+            self.range = range
+        }
+
+        /// The last `seconds` up to now.
+        init(_ pattern: String, last seconds: TimeInterval) {
+            self.init(pattern) { _, _, now, _ in
+                DateInterval(start: now.addingTimeInterval(-seconds), end: now)
+            }
+        }
+
+        /// Today between two hours, clipped to now.
+        init(_ pattern: String, today fromHour: Int, to toHour: Int) {
+            self.init(pattern) { _, _, now, calendar in
+                TemporalQuery.interval(on: now, from: fromHour, to: toHour, calendar: calendar, clippedTo: now)
+            }
+        }
+
+        /// Yesterday between two hours.
+        init(_ pattern: String, yesterday fromHour: Int, to toHour: Int) {
+            self.init(pattern) { _, _, now, calendar in
+                calendar.date(byAdding: .day, value: -1, to: now).flatMap { yesterday in
+                    TemporalQuery.interval(on: yesterday, from: fromHour, to: toHour, calendar: calendar, clippedTo: now)
+                }
+            }
+        }
+    }
+
+    /// Number words accepted as amounts. "a" and "one" are left to the vaguer
+    /// rules ("a minute ago" means recently, not exactly one minute).
+    private static let numberWords: [String: Double] = [
+        "two": 2, "three": 3, "four": 4, "five": 5, "six": 6, "seven": 7, "eight": 8,
+        "nine": 9, "ten": 10, "eleven": 11, "twelve": 12, "fifteen": 15, "twenty": 20,
+        "thirty": 30, "forty": 40, "forty-five": 45, "fifty": 50, "sixty": 60,
+    ]
+
+    /// Alternation of `numberWords`, longest first.
+    private static let numberPattern = numberWords.keys.sorted { $0.count > $1.count }.joined(separator: "|")
+    /// Captures an amount: digits or a number word.
+    private static let amountPattern = "(\\d+|" + numberPattern + ")"
+
+    /// The amount captured by group 1 of `match`, if positive. `extra` adds
+    /// words a single rule accepts.
+    private static func amount(_ match: NSTextCheckingResult, in query: String,
+                               counting extra: [String: Double] = [:]) -> Double? {
+        guard let group = Range(match.range(at: 1), in: query) else { return nil }
+        let word = query[group].lowercased()
+        guard let value = Double(word) ?? numberWords[word] ?? extra[word], value > 0 else { return nil }
+        return value
+    }
+
+    /// Half the interval again on either side of `seconds` ago: "10 minutes ago"
+    /// covers 5–15 minutes ago.
+    private static func interval(around seconds: TimeInterval, before now: Date) -> DateInterval {
+        let center = now.addingTimeInterval(-seconds)
+        return DateInterval(start: center.addingTimeInterval(-seconds / 2),
+                            end: min(now, center.addingTimeInterval(seconds / 2)))
+    }
+
+    /// Checked in order, so longer phrases come before the phrases they contain.
+    private static let rules: [Rule] = [
+        Rule(amountPattern + " (?:minutes?|mins?) ago") { match, query, now, _ in
+            TemporalQuery.amount(match, in: query).map { TemporalQuery.interval(around: $0 * 60, before: now) }
+        },
+        Rule(amountPattern + " (?:hours?|hrs?) ago") { match, query, now, _ in
+            TemporalQuery.amount(match, in: query).map { TemporalQuery.interval(around: $0 * 60 * 60, before: now) }
+        },
+        Rule("(\\d+|a|one|" + numberPattern + ") days? ago") { match, query, now, calendar in
+            // That whole calendar day; "a day ago" is yesterday.
+            guard let days = TemporalQuery.amount(match, in: query, counting: ["a": 1, "one": 1]),
+                  let day = calendar.date(byAdding: .day, value: -Int(days), to: now) else { return nil }
+            let start = calendar.startOfDay(for: day)
+            guard let end = calendar.date(byAdding: .day, value: 1, to: start) else { return nil }
+            return DateInterval(start: start, end: end)
+        },
+        Rule("(?:a )?(?:moment ago|just now|second ago|few seconds ago)", last: 2 * 60),
+        Rule("(?:a|one|a couple of|a few|few) minutes? ago", last: 5 * 60),
+        Rule("(?:the )?(?:last|past) hour", last: 60 * 60),
+        Rule("(?:an|one) hour ago", last: 2 * 60 * 60),
+        Rule("(?:a couple of|a few|few) hours ago|(?:the )?(?:last|past) (?:couple of|few) hours", last: 4 * 60 * 60),
+        Rule("yesterday morning", yesterday: 5, to: 12),
+        Rule("yesterday afternoon", yesterday: 12, to: 17),
+        Rule("yesterday evening", yesterday: 17, to: 24),
+        Rule("this morning", today: 5, to: 12),
+        Rule("this afternoon", today: 12, to: 17),
+        Rule("this evening|tonight", today: 17, to: 24),
+        Rule("(?:earlier )?today") { _, _, now, calendar in
+            DateInterval(start: calendar.startOfDay(for: now), end: now)
+        },
+        Rule("last night") { _, _, now, calendar in
+            guard let yesterday = calendar.date(byAdding: .day, value: -1, to: now) else { return nil }
+            // 18:00 yesterday until 05:00 today.
+            let start = calendar.startOfDay(for: yesterday).addingTimeInterval(18 * 60 * 60)
+            return DateInterval(start: start, end: max(start, min(now, start.addingTimeInterval(11 * 60 * 60))))
+        },
+        Rule("yesterday") { _, _, now, calendar in
+            guard let yesterday = calendar.date(byAdding: .day, value: -1, to: now) else { return nil }
+            let start = calendar.startOfDay(for: yesterday)
+            return DateInterval(start: start, end: calendar.startOfDay(for: now))
+        },
+    ]
+
+    private static func interval(on day: Date, from fromHour: Int, to toHour: Int,
+                                 calendar: Calendar, clippedTo now: Date) -> DateInterval? {
+        let midnight = calendar.startOfDay(for: day)
+        guard let start = calendar.date(byAdding: .hour, value: fromHour, to: midnight),
+              let end = calendar.date(byAdding: .hour, value: toHour, to: midnight),
+              start < now else { return nil }
+        return DateInterval(start: start, end: min(end, now))
+    }
+}
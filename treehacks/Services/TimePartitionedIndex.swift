@@ -0,0 +1,267 @@
+//
+//  TimePartitionedIndex.swift
+//  treehacks
+//
+//  Clip index split into hour-long segments, each with its own vector
+//  index, keyword postings and per-minute buckets of clip IDs. Queries
+//  with a time range skip segments and minutes outside it before any
+//  vector math, and expiring history drops whole segments without
+//  touching their clips one by one; only the hour straddling the cutoff
+//  is trimmed clip by clip.
+//
+
+import Foundation
+
+struct TimePartitionedIndex {
+
+    static let segmentDuration: TimeInterval = 60 * 60
+    static let bucketDuration: TimeInterval = 60
+    private static let bucketsPerSegment = Int(segmentDuration / bucketDuration)
+    /// In a partly covered segment, up to this many in-range clips are scored
+    /// exactly from their minute buckets; more than that searches the segment index.
+    private static let exactScanLimit = 256
+
+    /// A search hit with the end time needed to locate its clip.
+    struct Hit {
+        let id: UUID
+        let endTime: Date
+        let score: Double
+    }
+
+    private struct Segment {
+        let start: Date
+        var vectors: any VectorIndex
+        var keywords = KeywordIndex()
+        var endTimes: [UUID: Date] = [:]
+        /// Clip IDs by minute of the hour they ended in.
+        var buckets = [[UUID]](repeating: [], count: TimePartitionedIndex.bucketsPerSegment)
+
+        var end: Date { start.addingTimeInterval(TimePartitionedIndex.segmentDuration) }
+
+        func bucket(for endTime: Date) -> Int {
+            let minute = Int(endTime.timeIntervalSince(start) / TimePartitionedIndex.bucketDuration)
+            return min(TimePartitionedIndex.bucketsPerSegment - 1, max(0, minute))
+        }
+
+        func isCovered(by range: DateInterval) -> Bool {
+            range.start <= start && end <= range.end
+        }
+
+        /// In-range clips, visiting only the minute buckets that overlap `range`.
+        func clips(in range: DateInterval) -> [(id: UUID, endTime: Date)] {
+            var result: [(id: UUID, endTime: Date)] = []
+            for minute in bucket(for: range.start)...bucket(for: range.end) {
+                for id in buckets[minute] {
+                    if let endTime = endTimes[id], range.contains(endTime) {
+                        result.append((id, endTime))
+                    }
+                }
+            }
+            return result
+        }
+    }
+
+    private let makeVectorIndex: () -> any VectorIndex
+    /// Segments ordered by start time; gaps where nothing was recorded have none.
+    private var segments: [Segment] = []
+
+    /// Number of indexed clips.
+    private(set) var count = 0
+
+    /// - Parameter makeVectorIndex: Creates the vector index for each new segment.
+    init(makeVectorIndex: @escaping () -> any VectorIndex) {
+        self.makeVectorIndex = makeVectorIndex
+    }
+
+    func contains(_ id: UUID, endTime: Date) -> Bool {
+        segmentIndex(containing: endTime).map { segments[$0].endTimes[id] != nil } ?? false
+    }
+
+    // MARK: - Mutation
+
+    /// Insert or refresh a clip. A nil `unitVector` indexes its keywords only.
+    mutating func upsert(id: UUID, endTime: Date, keywords: Set<String>, description: String, unitVector: [Float]?) {
+        let s = segmentIndex(forInserting: endTime)
+        if segments[s].endTimes.updateValue(endTime, forKey: id) == nil {
+            segments[s].buckets[segments[s].bucket(for: endTime)].append(id)
+            count += 1
+        }
+        segments[s].keywords.update(id: id, keywords: keywords, description: description)
+        if let unitVector = unitVector, segments[s].vectors.upsert(unitVector, for: id) {
+            return
+        }
+        segments[s].vectors.remove(id)
+    }
+
+    /// Drop every clip that ended before `cutoff`. Whole segments that end by
+    /// `cutoff` are released at once; only the segment straddling it has its
+    /// expired clips removed one by one, so `count` matches what is still live.
+    /// Returns the number of clips dropped.
+    @discardableResult
+    mutating func removeClips(endingBefore cutoff: Date) -> Int {
+        let expired = segments.prefix { $0.end <= cutoff }.count
+        var dropped = segments[..<expired].reduce(0) { $0 + $1.endTimes.count }
+        segments.removeFirst(expired)
+
+        // Take the straddling segment out while trimming it, so its indexes
+        // are edited in place rather than copied.
+        if !segments.isEmpty, segments[0].start < cutoff {
+            var segment = segments.removeFirst()
+            for minute in 0...segment.bucket(for: cutoff) {
+                let bucket = segment.buckets[minute]
+                let expiredIDs = bucket.filter { segment.endTimes[$0].map { $0 < cutoff } ?? false }
+                guard !expiredIDs.isEmpty else { continue }
+                for id in expiredIDs {
+                    segment.endTimes.removeValue(forKey: id)
+                    segment.keywords.remove(id)
+                    segment.vectors.remove(id)
+                }
+                segment.buckets[minute] = bucket.filter { segment.endTimes[$0] != nil }
+                dropped += expiredIDs.count
+            }
+            if !segment.endTimes.isEmpty {
+                segments.insert(segment, at: 0)
+            }
+        }
+        count -= dropped
+        return dropped
+    }
+
+    // MARK: - Query
+
+    /// Up to `k` nearest clips ending within `range` (anywhere when nil), best first.
+    func search(_ unitQuery: [Float], k: Int, in range: DateInterval?) -> [Hit] {
+        guard k > 0 else { return [] }
+        var best = TopKSelector<Hit>(k: k)
+        for segment in segments(overlapping: range) {
+            for hit in search(segment, unitQuery, k: k, in: range) {
+                best.insert(hit, score: hit.score)
+            }
+        }
+        return best.sortedDescending().map(\.element)
+    }
+
+    private func search(_ segment: Segment, _ unitQuery: [Float], k: Int, in range: DateInterval?) -> [Hit] {
+        guard let range = range, !segment.isCovered(by: range) else {
+            return segment.vectors.search(unitQuery, k: k).compactMap { hit in
+                segment.endTimes[hit.id].map { Hit(id: hit.id, endTime: $0, score: Double(hit.score)) }
+            }
+        }
+
+        let inRange = segment.clips(in: range)
+        if inRange.count <= Self.exactScanLimit {
+            var best = TopKSelector<Hit>(k: k)
+            let scores = segment.vectors.similarities(of: inRange.map(\.id), to: unitQuery)
+            for (clip, score) in zip(inRange, scores) {
+                guard let score = score else { continue }
+                best.insert(Hit(id: clip.id, endTime: clip.endTime, score: Double(score)), score: Double(score))
+            }
+            return best.sortedDescending().map(\.element)
+        }
+
+        // Over-fetch by the out-of-range clips so an exact index still yields k in range.
+        let fetch = k + segment.endTimes.count - inRange.count
+        var hits: [Hit] = []
+        for hit in segment.vectors.search(unitQuery, k: fetch) {
+            guard let endTime = segment.endTimes[hit.id], range.contains(endTime) else { continue }
+            hits.append(Hit(id: hit.id, endTime: endTime, score: Double(hit.score)))
+            if hits.count == k { break }
+        }
+        return hits
+    }
+
+    /// Similarity of specific clips to the query (nil entries are omitted).
+    func similarities(of clips: [(id: UUID, endTime: Date)], to unitQuery: [Float]) -> [UUID: Float] {
+        var bySegment: [Int: [UUID]] = [:]
+        for clip in clips {
+            if let s = segmentIndex(containing: clip.endTime) {
+                bySegment[s, default: []].append(clip.id)
+            }
+        }
+        var result: [UUID: Float] = [:]
+        for (s, ids) in bySegment {
+            for (id, score) in zip(ids, segments[s].vectors.similarities(of: ids, to: unitQuery)) {
+                result[id] = score
+            }
+        }
+        return result
+    }
+
+    /// BM25 score of clips ending within `range` that contain a query term.
+    /// Term statistics span every segment, so scores are comparable across ranges.
+    func bm25Scores(for queryTerms: Set<String>, in range: DateInterval?) -> [Hit] {
+        var corpus = KeywordIndex.CorpusStatistics()
+        for segment in segments {
+            corpus.merge(segment.keywords.statistics(for: queryTerms))
+        }
+        var hits: [Hit] = []
+        for segment in segments(overlapping: range) {
+            for (id, score) in segment.keywords.bm25Scores(for: queryTerms, corpus: corpus) {
+                guard let endTime = segment.endTimes[id], range?.contains(endTime) ?? true else { continue }
+                hits.append(Hit(id: id, endTime: endTime, score: score))
+            }
+        }
+        return hits
+    }
+
+    /// Number of query terms each matching clip within `range` contains.
+    func matchCounts(for queryTerms: Set<String>, in range: DateInterval?) -> [Hit] {
+        var hits: [Hit] = []
+        for segment in segments(overlapping: range) {
+            for (id, matches) in segment.keywords.matchCounts(for: queryTerms) {
+                guard let endTime = segment.endTimes[id], range?.contains(endTime) ?? true else { continue }
+                hits.append(Hit(id: id, endTime: endTime, score: Double(matches)))
+            }
+        }
+        return hits
+    }
+
+    // MARK: - Segments
+
+    private static func segmentStart(for date: Date) -> Date {
+        let seconds = date.timeIntervalSinceReferenceDate
+        return Date(timeIntervalSinceReferenceDate: (seconds / segmentDuration).rounded(.down) * segmentDuration)
+    }
+
+    /// Position of the first segment starting at or after `start`.
+    private func insertionPoint(for start: Date) -> Int {
+        var low = 0
+        var high = segments.count
+        while low < high {
+            let mid = (low + high) / 2
+            if segments[mid].start < start {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low
+    }
+
+    private func segmentIndex(containing date: Date) -> Int? {
+        let start = Self.segmentStart(for: date)
+        let i = insertionPoint(for: start)
+        return i < segments.count && segments[i].start == start ? i : nil
+    }
+
+    private mutating func segmentIndex(forInserting date: Date) -> Int {
+        let start = Self.segmentStart(for: date)
+        let i = insertionPoint(for: start)
+        if i < segments.count, segments[i].start == start {
+            return i
+        }
+        segments.insert(Segment(start: start, vectors: makeVectorIndex()), at: i)
+        return i
+    }
+
+    /// Segments that can hold clips ending within `range` (all when nil).
+    private func segments(overlapping range: DateInterval?) -> ArraySlice<Segment> {
+        guard let range = range else { return segments[...] }
+        let first = insertionPoint(for: Self.segmentStart(for: range.start))
+        var last = first
+        while last < segments.count, segments[last].start <= range.end {
+            last += 1
+        }
+        return segments[first..<last]
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  TopKSelector.swift
+//  treehacks
+//
+//  Bounded min-heap that keeps the k highest-scoring elements of a stream.
+//  Selecting from n candidates costs O(n log k) and holds at most k
+//  elements, instead of materializing and sorting all n.
+//
+
+import Foundation
+
+struct TopKSelector<Element> {
+
+    let k: Int
+    private var heap: [(element: Element, score: Double)] = []
+
+    init(k: Int) {
+        self.k = max(0, k)
+        heap.reserveCapacity(self.k)
+    }
+
+    var count: Int { heap.count }
+
+    /// Lowest score currently kept, once the selector is full.
+    /// Candidates at or below this can be skipped without calling `insert`.
+    var threshold: Double? {
+        heap.count == k ? heap.first?.score : nil
+    }
+
+    /// Offer a candidate. Ties keep the element that arrived first.
+    mutating func insert(_ element: Element, score: Double) {
+        guard k > 0 else { return }
+        if heap.count < k {
+            heap.append((element, score))
+            siftUp(from: heap.count - 1)
+        } else if score > heap[0].score {
+            heap[0] = (element, score)
+            siftDown(from: 0)
+        }
+    }
+
+    /// The selected elements, highest score first.
+    func sortedDescending() -> [(element: Element, score: Double)] {
+        heap.sorted { $0.score > $1.score }
+    }
+
+    // MARK: - Heap
+
+    private mutating func siftUp(from index: Int) {
+        var child = index
+        while child > 0 {
+            let parent = (child - 1) / 2
+            guard heap[child].score < heap[parent].score else { return }
+            heap.swapAt(child, parent)
+            child = parent
+        }
+    }
+
+    private mutating func siftDown(from index: Int) {
+        var parent = index
+        while true {
+            let left = 2 * parent + 1
+            let right = left + 1
+            var smallest = parent
+            if left < heap.count, heap[left].score < heap[smallest].score { smallest = left }
+            if right < heap.count, heap[right].score < heap[smallest].score { smallest = right }
+            guard smallest != parent else { return }
+            heap.swapAt(parent, smallest)
+            parent = smallest
+        }
+    }
+}
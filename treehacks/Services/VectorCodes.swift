@@ -0,0 +1,252 @@
+//
+//  VectorCodes.swift
+//  treehacks
+//
+//  Row-addressed storage for unit vectors as Float32, Float16 or int8
+//  codes with one scale factor per row. Quantized rows are scored
+//  directly on their codes (integer or half-precision dot products), and
+//  `rescore` re-ranks candidates against the unquantized query.
+//
+//  Bytes per 512-dim vector: int8 516, float16 1028, float32 2052
+//  (versus 4096 plus an array header for the [Double] NLEmbedding output).
+//
+
+import Foundation
+
+struct VectorCodes {
+
+    enum Encoding: String, CaseIterable {
+        case float32, float16, int8
+
+        var bytesPerComponent: Int {
+            switch self {
+            case .float32: return MemoryLayout<Float>.size
+            case .float16: return MemoryLayout<Float16>.size
+            case .int8:    return MemoryLayout<Int8>.size
+            }
+        }
+    }
+
+    /// A query encoded once per search, so every row comparison runs on codes.
+    struct Query {
+        fileprivate let unit: [Float]
+        fileprivate let int8: [Int8]
+        fileprivate let half: [Float16]
+        fileprivate let scale: Float
+    }
+
+    let encoding: Encoding
+    private(set) var dimension: Int
+
+    private var floats: [Float] = []
+    private var halves: [Float16] = []
+    private var bytes: [Int8] = []
+    /// Per-row dequantization factor: component ≈ code × scale.
+    private var scales: [Float] = []
+
+    init(encoding: Encoding, dimension: Int = 0) {
+        self.encoding = encoding
+        self.dimension = dimension
+    }
+
+    var rowCount: Int { scales.count }
+
+    /// Storage cost of one row, codes plus scale.
+    var bytesPerRow: Int { dimension * encoding.bytesPerComponent + MemoryLayout<Float>.size }
+
+    // MARK: - Mutation
+
+    /// Append a row. `unit` must have `dimension` components.
+    mutating func append(_ unit: [Float]) {
+        let row = rowCount
+        switch encoding {
+        case .float32: floats.append(contentsOf: repeatElement(0, count: dimension))
+        case .float16: halves.append(contentsOf: repeatElement(0, count: dimension))
+        case .int8:    bytes.append(contentsOf: repeatElement(0, count: dimension))
+        }
+        scales.append(1)
+        encode(unit, into: row)
+    }
+
+    /// Overwrite `row` in place.
+    mutating func replace(row: Int, with unit: [Float]) {
+        encode(unit, into: row)
+    }
+
+    /// Copy row `source` over row `destination` (used for swap-removal).
+    mutating func copyRow(_ source: Int, to destination: Int) {
+        guard source != destination else { return }
+        let dim = dimension
+        switch encoding {
+        case .float32: Self.copy(&floats, source * dim, destination * dim, dim)
+        case .float16: Self.copy(&halves, source * dim, destination * dim, dim)
+        case .int8:    Self.copy(&bytes, source * dim, destination * dim, dim)
+        }
+        scales[destination] = scales[source]
+    }
+
+    mutating func removeLast() {
+        switch encoding {
+        case .float32: floats.removeLast(dimension)
+        case .float16: halves.removeLast(dimension)
+        case .int8:    bytes.removeLast(dimension)
+        }
+        scales.removeLast()
+    }
+
+    /// Drop every row and adopt a new dimension.
+    mutating func reset(dimension: Int) {
+        self.dimension = dimension
+        floats = []
+        halves = []
+        bytes = []
+        scales = []
+    }
+
+    // MARK: - Scoring
+
+    /// Encode a unit-length query with this store's encoding.
+    func prepare(_ unit: [Float]) -> Query {
+        switch encoding {
+        case .float32:
+            return Query(unit: unit, int8: [], half: [], scale: 1)
+        case .float16:
+            let scale = Self.halfScale(unit)
+            return Query(unit: unit, int8: [], half: unit.map { Float16($0 / scale) }, scale: scale)
+        case .int8:
+            let scale = Self.int8Scale(unit)
+            return Query(unit: unit, int8: unit.map { Self.int8Code($0, scale: scale) }, half: [], scale: scale)
+        }
+    }
+
+    /// Approximate similarity of `row` to `query`, computed on the codes.
+    func score(row: Int, _ query: Query) -> Float {
+        let dim = dimension
+        let offset = row * dim
+        switch encoding {
+        case .float32:
+            return floats.withUnsafeBufferPointer { f in
+                query.unit.withUnsafeBufferPointer { q in
+                    VectorMath.dot(f.baseAddress! + offset, q.baseAddress!, count: dim)
+                }
+            }
+        case .float16:
+            let dot = halves.withUnsafeBufferPointer { h in
+                query.half.withUnsafeBufferPointer { q in
+                    VectorMath.dot(h.baseAddress! + offset, q.baseAddress!, count: dim)
+                }
+            }
+            return dot * scales[row] * query.scale
+        case .int8:
+            let dot = bytes.withUnsafeBufferPointer { b in
+                query.int8.withUnsafeBufferPointer { q in
+                    VectorMath.dot(b.baseAddress! + offset, q.baseAddress!, count: dim)
+                }
+            }
+            return Float(dot) * scales[row] * query.scale
+        }
+    }
+
+    /// Similarity of `row` to the unquantized query. Only the stored side
+    /// carries quantization error, so this is the re-ranking score.
+    func rescore(row: Int, _ query: Query) -> Float {
+        let dim = dimension
+        let offset = row * dim
+        switch encoding {
+        case .float32:
+            return score(row: row, query)
+        case .float16:
+            let dot = halves.withUnsafeBufferPointer { h in
+                query.unit.withUnsafeBufferPointer { q in
+                    VectorMath.dot(q.baseAddress!, h.baseAddress! + offset, count: dim)
+                }
+            }
+            return dot * scales[row]
+        case .int8:
+            let dot = bytes.withUnsafeBufferPointer { b in
+                query.unit.withUnsafeBufferPointer { q in
+                    VectorMath.dot(q.baseAddress!, b.baseAddress! + offset, count: dim)
+                }
+            }
+            return dot * scales[row]
+        }
+    }
+
+    /// Approximate similarity between two stored rows.
+    func score(row a: Int, row b: Int) -> Float {
+        let dim = dimension
+        switch encoding {
+        case .float32:
+            return floats.withUnsafeBufferPointer { f in
+                VectorMath.dot(f.baseAddress! + a * dim, f.baseAddress! + b * dim, count: dim)
+            }
+        case .float16:
+            let dot = halves.withUnsafeBufferPointer { h in
+                VectorMath.dot(h.baseAddress! + a * dim, h.baseAddress! + b * dim, count: dim)
+            }
+            return dot * scales[a] * scales[b]
+        case .int8:
+            let dot = bytes.withUnsafeBufferPointer { c in
+                VectorMath.dot(c.baseAddress! + a * dim, c.baseAddress! + b * dim, count: dim)
+            }
+            return Float(dot) * scales[a] * scales[b]
+        }
+    }
+
+    // MARK: - Encoding
+
+    private mutating func encode(_ unit: [Float], into row: Int) {
+        let offset = row * dimension
+        switch encoding {
+        case .float32:
+            floats.replaceSubrange(offset..<offset + dimension, with: unit)
+            scales[row] = 1
+        case .float16:
+            let scale = Self.halfScale(unit)
+            halves.withUnsafeMutableBufferPointer { h in
+                for (i, x) in unit.enumerated() {
+                    h[offset + i] = Float16(x / scale)
+                }
+            }
+            scales[row] = scale
+        case .int8:
+            let scale = Self.int8Scale(unit)
+            bytes.withUnsafeMutableBufferPointer { b in
+                for (i, x) in unit.enumerated() {
+                    b[offset + i] = Self.int8Code(x, scale: scale)
+                }
+            }
+            scales[row] = scale
+        }
+    }
+
+    /// Int8 codes and scale for `unit`, in the same format as `.int8` rows.
+    /// Used by the on-disk clip index so persisted rows score like in-memory ones.
+    static func int8Encode(_ unit: [Float]) -> (codes: [Int8], scale: Float) {
+        let scale = int8Scale(unit)
+        return (unit.map { int8Code($0, scale: scale) }, scale)
+    }
+
+    /// Largest magnitude maps to 1.0, keeping small components out of the subnormal range.
+    private static func halfScale(_ v: [Float]) -> Float {
+        let maxMagnitude = v.reduce(0) { max($0, abs($1)) }
+        return maxMagnitude > 0 ? maxMagnitude : 1
+    }
+
+    /// Largest magnitude maps to ±127 (symmetric, so zero stays exactly zero).
+    private static func int8Scale(_ v: [Float]) -> Float {
+        let maxMagnitude = v.reduce(0) { max($0, abs($1)) }
+        return maxMagnitude > 0 ? maxMagnitude / 127 : 1
+    }
+
+    private static func int8Code(_ x: Float, scale: Float) -> Int8 {
+        Int8(max(-127, min(127, (x / scale).rounded())))
+    }
+
+    private static func copy<T>(_ array: inout [T], _ from: Int, _ to: Int, _ count: Int) {
+        array.withUnsafeMutableBufferPointer { buffer in
+            let base = buffer.baseAddress!
+            (base + to).update(from: base + from, count: count)
+        }
+    }
+}
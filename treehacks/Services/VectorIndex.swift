@@ -0,0 +1,39 @@
+//
+//  VectorIndex.swift
+//  treehacks
+//
+//  Pluggable nearest-neighbour backend for clip embedding search.
+//  `EmbeddingMatrix` is the exact Float32 full scan,
+//  `QuantizedEmbeddingStore` scans int8/Float16 codes, and `HNSWIndex`
+//  is the approximate graph index used once history grows to days.
+//  All vectors are unit length, so similarity is a plain dot product.
+//
+
+import Foundation
+
+/// A search hit: the clip ID and its cosine similarity to the query.
+struct VectorHit {
+    let id: UUID
+    let score: Float
+}
+
+protocol VectorIndex {
+
+    /// Number of live vectors.
+    var count: Int { get }
+
+    /// Insert a vector, or replace it in place if `id` is already indexed.
+    /// Returns false if the vector's dimension does not match the index.
+    @discardableResult
+    mutating func upsert(_ unitVector: [Float], for id: UUID) -> Bool
+
+    /// Remove `id` if present.
+    mutating func remove(_ id: UUID)
+
+    /// Up to `k` most similar vectors, best first.
+    func search(_ unitQuery: [Float], k: Int) -> [VectorHit]
+
+    /// Similarity of each listed vector to the query, nil where `id` is not indexed.
+    /// Lets hybrid ranking score lexical matches that the search did not return.
+    func similarities(of ids: [UUID], to unitQuery: [Float]) -> [Float?]
+}
@@ -0,0 +1,202 @@
+//
+//  VectorMath.swift
+//  treehacks
+//
+//  Float32 vector and matrix kernels shared by clip search and face matching.
+//  Uses Accelerate on Apple platforms and a portable 8-lane SIMD loop
+//  everywhere else, so the same code builds and benchmarks on Linux.
+//
+
+import Foundation
+#if canImport(Accelerate)
+import Accelerate
+#endif
+
+enum VectorMath {
+
+    // MARK: - Dot Products
+
+    /// Dot product of two `count`-length vectors.
+    static func dot(_ a: UnsafePointer<Float>, _ b: UnsafePointer<Float>, count: Int) -> Float {
+        #if canImport(Accelerate)
+        var result: Float = 0
+        vDSP_dotpr(a, 1, b, 1, &result, vDSP_Length(count))
+        return result
+        #else
+        return portableDot(a, b, count: count)
+        #endif
+    }
+
+    /// Dot product of two equal-length arrays (0 when the lengths differ).
+    static func dot(_ a: [Float], _ b: [Float]) -> Float {
+        guard a.count == b.count, !a.isEmpty else { return 0 }
+        return a.withUnsafeBufferPointer { pa in
+            b.withUnsafeBufferPointer { pb in
+                dot(pa.baseAddress!, pb.baseAddress!, count: a.count)
+            }
+        }
+    }
+
+    /// Scalar-reference dot product using two 8-wide accumulators.
+    /// Always compiled so benchmarks can compare it against Accelerate.
+    static func portableDot(_ a: UnsafePointer<Float>, _ b: UnsafePointer<Float>, count: Int) -> Float {
+        let ra = UnsafeRawPointer(a)
+        let rb = UnsafeRawPointer(b)
+        let stride = MemoryLayout<Float>.stride
+        var acc0 = SIMD8<Float>()
+        var acc1 = SIMD8<Float>()
+        var i = 0
+        while i + 16 <= count {
+            acc0 += ra.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float>.self)
+                  * rb.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float>.self)
+            acc1 += ra.loadUnaligned(fromByteOffset: (i + 8) * stride, as: SIMD8<Float>.self)
+                  * rb.loadUnaligned(fromByteOffset: (i + 8) * stride, as: SIMD8<Float>.self)
+            i += 16
+        }
+        var sum = (acc0 + acc1).sum()
+        while i < count {
+            sum += a[i] * b[i]
+            i += 1
+        }
+        return sum
+    }
+
+    // MARK: - Matrix-Vector
+
+    /// `out[r] = dot(matrix[r], vector)` for a row-major `rows × columns` matrix.
+    static func gemv(
+        _ matrix: UnsafePointer<Float>, rows: Int, columns: Int,
+        _ vector: UnsafePointer<Float>, into out: UnsafeMutablePointer<Float>
+    ) {
+        guard rows > 0, columns > 0 else { return }
+        #if canImport(Accelerate)
+        vDSP_mmul(matrix, 1, vector, 1, out, 1, vDSP_Length(rows), 1, vDSP_Length(columns))
+        #else
+        for r in 0..<rows {
+            out[r] = portableDot(matrix + r * columns, vector, count: columns)
+        }
+        #endif
+    }
+
+    /// `out = a · b` for a row-major `rows × inner` matrix `a` and `inner × columns`
+    /// matrix `b`. To score rows against rows, pass the second set transposed.
+    static func gemm(
+        _ a: UnsafePointer<Float>, rows: Int, inner: Int,
+        _ b: UnsafePointer<Float>, columns: Int,
+        into out: UnsafeMutablePointer<Float>
+    ) {
+        guard rows > 0, inner > 0, columns > 0 else { return }
+        #if canImport(Accelerate)
+        vDSP_mmul(a, 1, b, 1, out, 1, vDSP_Length(rows), vDSP_Length(columns), vDSP_Length(inner))
+        #else
+        for i in 0..<rows {
+            let row = out + i * columns
+            row.initialize(repeating: 0, count: columns)
+            for k in 0..<inner {
+                let scale = a[i * inner + k]
+                let bRow = b + k * columns
+                for j in 0..<columns {
+                    row[j] += scale * bRow[j]
+                }
+            }
+        }
+        #endif
+    }
+
+    // MARK: - Quantized Codes
+
+    /// Integer dot product of two int8 code vectors, accumulated in Int32.
+    /// Products are widened before summing, so any `count` up to 2^17 is exact.
+    static func dot(_ a: UnsafePointer<Int8>, _ b: UnsafePointer<Int8>, count: Int) -> Int32 {
+        let ra = UnsafeRawPointer(a)
+        let rb = UnsafeRawPointer(b)
+        var acc = SIMD16<Int32>()
+        var i = 0
+        while i + 16 <= count {
+            let va = SIMD16<Int16>(truncatingIfNeeded: ra.loadUnaligned(fromByteOffset: i, as: SIMD16<Int8>.self))
+            let vb = SIMD16<Int16>(truncatingIfNeeded: rb.loadUnaligned(fromByteOffset: i, as: SIMD16<Int8>.self))
+            acc &+= SIMD16<Int32>(truncatingIfNeeded: va &* vb)
+            i += 16
+        }
+        var sum = acc.wrappedSum()
+        while i < count {
+            sum &+= Int32(a[i]) * Int32(b[i])
+            i += 1
+        }
+        return sum
+    }
+
+    /// Dot product of two half-precision vectors, accumulated in Float32.
+    static func dot(_ a: UnsafePointer<Float16>, _ b: UnsafePointer<Float16>, count: Int) -> Float {
+        let ra = UnsafeRawPointer(a)
+        let rb = UnsafeRawPointer(b)
+        let stride = MemoryLayout<Float16>.stride
+        var acc = SIMD8<Float>()
+        var i = 0
+        while i + 8 <= count {
+            acc += SIMD8<Float>(ra.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float16>.self))
+                 * SIMD8<Float>(rb.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float16>.self))
+            i += 8
+        }
+        var sum = acc.sum()
+        while i < count {
+            sum += Float(a[i]) * Float(b[i])
+            i += 1
+        }
+        return sum
+    }
+
+    /// Dot product of a Float32 vector with int8 codes (codes are not rescaled).
+    static func dot(_ a: UnsafePointer<Float>, _ codes: UnsafePointer<Int8>, count: Int) -> Float {
+        let ra = UnsafeRawPointer(a)
+        let rc = UnsafeRawPointer(codes)
+        let stride = MemoryLayout<Float>.stride
+        var acc = SIMD8<Float>()
+        var i = 0
+        while i + 8 <= count {
+            acc += ra.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float>.self)
+                 * SIMD8<Float>(rc.loadUnaligned(fromByteOffset: i, as: SIMD8<Int8>.self))
+            i += 8
+        }
+        var sum = acc.sum()
+        while i < count {
+            sum += a[i] * Float(codes[i])
+            i += 1
+        }
+        return sum
+    }
+
+    /// Dot product of a Float32 vector with half-precision codes.
+    static func dot(_ a: UnsafePointer<Float>, _ codes: UnsafePointer<Float16>, count: Int) -> Float {
+        let ra = UnsafeRawPointer(a)
+        let rc = UnsafeRawPointer(codes)
+        let stride = MemoryLayout<Float>.stride
+        let halfStride = MemoryLayout<Float16>.stride
+        var acc = SIMD8<Float>()
+        var i = 0
+        while i + 8 <= count {
+            acc += ra.loadUnaligned(fromByteOffset: i * stride, as: SIMD8<Float>.self)
+                 * SIMD8<Float>(rc.loadUnaligned(fromByteOffset: i * halfStride, as: SIMD8<Float16>.self))
+            i += 8
+        }
+        var sum = acc.sum()
+        while i < count {
+            sum += a[i] * Float(codes[i])
+            i += 1
+        }
+        return sum
+    }
+
+    // MARK: - Normalization
+
+    /// Convert a Double vector (as returned by NLEmbedding) to a unit-length Float32 vector.
+    /// Returns nil for empty or all-zero input.
+    static func normalized(_ vector: [Double]) -> [Float]? {
+        guard !vector.isEmpty else { return nil }
+        var sumSquares: Double = 0
+        for x in vector { sumSquares += x * x }
+        guard sumSquares > 0 else { return nil }
+        let scale = 1 / sumSquares.squareRoot()
+        return vector.map { Float($0 * scale) }
+    }
+}
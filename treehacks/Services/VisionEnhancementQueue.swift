@@ -0,0 +1,193 @@
+//
+//  VisionEnhancementQueue.swift
+//  treehacks
+//
+//  Schedules GPT-4o-mini vision enhancement of finalized clips. At most
+//  `maxInFlight` requests run at once and a token bucket caps the request
+//  rate. While either limit holds clips back they wait, and the next
+//  request packs several of them (newest first) into one multi-image call
+//  whose keywords are mapped back per clip. Waiting is bounded: a clip that
+//  has waited long is downgraded to a single frame, and one that would be
+//  pruned before its result could arrive, or that overflows the backlog,
+//  is dropped.
+//
+
+import Foundation
+
+final class VisionEnhancementQueue {
+
+    /// A clip waiting for enhancement.
+    struct Job {
+        let clipID: UUID
+        /// Frames in capture order.
+        let jpegImages: [Data]
+        /// On-device keywords the result is merged with.
+        let existingKeywords: Set<String>
+        /// When the clip leaves the searchable index.
+        let expires: Date
+        var enqueued = Date()
+    }
+
+    /// Counters for debug display.
+    struct Stats {
+        var requests = 0
+        /// Clips that shared a request with other clips.
+        var clipsPacked = 0
+        var clipsEnhanced = 0
+        /// Clips sent with one frame because they waited too long.
+        var downgraded = 0
+        /// Clips never sent: about to be pruned or pushed out of a full backlog.
+        var dropped = 0
+        /// Clips whose request failed or whose keywords the response left out.
+        var failed = 0
+    }
+
+    let maxInFlight: Int
+    let maxClipsPerRequest: Int
+    /// Images per request across all packed clips.
+    let maxImagesPerRequest = 9
+    /// Requests allowed back to back after idling.
+    let burst: Double
+    /// Sustained request rate, per second.
+    let refillRate: Double
+    /// Clips waiting longer than this are sent with one frame.
+    let downgradeAfter: TimeInterval = 30
+    /// Clips waiting beyond this many drop the oldest.
+    let maxPending = 20
+
+    /// Called off the main thread with each enhanced clip and its new keywords.
+    var onKeywords: ((Job, [String]) -> Void)?
+
+    private let queue = DispatchQueue(label: "com.treehacks.visionEnhancement", qos: .utility)
+    private let describe: ([[Data]]) async throws -> [[String]]?
+
+    // State below is only touched on `queue`.
+    private var pending: [Job] = []
+    private var inFlight = 0
+    private var tokens: Double
+    private var lastRefill = Date()
+    private var isWakeScheduled = false
+    private var state = Stats()
+
+    /// - Parameter describe: Keywords for each clip's frames, in order; nil on failure.
+    init(maxInFlight: Int = 2, maxClipsPerRequest: Int = 3, requestsPerMinute: Double = 12, burst: Double = 3,
+         describe: @escaping ([[Data]]) async throws -> [[String]]? = OpenAIClient.describeClips) {
+        self.maxInFlight = max(1, maxInFlight)
+        self.maxClipsPerRequest = max(1, maxClipsPerRequest)
+        self.burst = max(1, burst)
+        self.refillRate = max(1, requestsPerMinute) / 60
+        self.tokens = self.burst
+        self.describe = describe
+    }
+
+    var stats: Stats {
+        queue.sync { state }
+    }
+
+    func enqueue(_ job: Job) {
+        guard !job.jpegImages.isEmpty else { return }
+        queue.async {
+            self.pending.append(job)
+            if self.pending.count > self.maxPending {
+                self.pending.removeFirst(self.pending.count - self.maxPending)
+                self.state.dropped += 1
+            }
+            self.pump()
+        }
+    }
+
+    // MARK: - Scheduling
+
+    /// One request's clips and the frames sent for each.
+    private struct Batch {
+        var jobs: [Job] = []
+        var images: [[Data]] = []
+        var imageCount: Int { images.reduce(0) { $0 + $1.count } }
+    }
+
+    /// Start as many requests as the limits allow.
+    private func pump() {
+        let now = Date()
+        tokens = min(burst, tokens + now.timeIntervalSince(lastRefill) * refillRate)
+        lastRefill = now
+
+        // A result takes up to a request timeout; clips pruned by then are not worth it.
+        let deadline = now.addingTimeInterval(OpenAIClient.visionRequestTimeout)
+        let live = pending.filter { $0.expires > deadline }
+        state.dropped += pending.count - live.count
+        pending = live
+
+        while inFlight < maxInFlight, !pending.isEmpty {
+            guard tokens >= 1 else {
+                scheduleWake(after: (1 - tokens) / refillRate)
+                return
+            }
+            tokens -= 1
+            inFlight += 1
+            send(takeBatch(now: now))
+        }
+    }
+
+    /// Remove and return the newest pending clips that fit in one request.
+    private func takeBatch(now: Date) -> Batch {
+        var batch = Batch()
+        var index = pending.count - 1
+        while index >= 0, batch.jobs.count < maxClipsPerRequest {
+            let job = pending[index]
+            var images = job.jpegImages
+            let downgrade = now.timeIntervalSince(job.enqueued) > downgradeAfter && images.count > 1
+            if downgrade {
+                images = [images[images.count / 2]]
+            }
+            // The first clip always goes, even if it alone is over the image limit.
+            if batch.jobs.isEmpty || batch.imageCount + images.count <= maxImagesPerRequest {
+                batch.jobs.append(job)
+                batch.images.append(images)
+                pending.remove(at: index)
+                if downgrade {
+                    state.downgraded += 1
+                }
+            }
+            index -= 1
+        }
+        return batch
+    }
+
+    private func send(_ batch: Batch) {
+        state.requests += 1
+        if batch.jobs.count > 1 {
+            state.clipsPacked += batch.jobs.count
+        }
+        Task {
+            let results: [[String]]?
+            do {
+                results = try await self.describe(batch.images)
+            } catch {
+                print("[VisionEnhancementQueue] Vision request failed: \(error.localizedDescription)")
+                results = nil
+            }
+
+            var enhanced = 0
+            for (job, keywords) in zip(batch.jobs, results ?? []) where !keywords.isEmpty {
+                self.onKeywords?(job, keywords)
+                enhanced += 1
+            }
+
+            self.queue.async {
+                self.inFlight -= 1
+                self.state.clipsEnhanced += enhanced
+                self.state.failed += batch.jobs.count - enhanced
+                self.pump()
+            }
+        }
+    }
+
+    private func scheduleWake(after delay: TimeInterval) {
+        guard !isWakeScheduled else { return }
+        isWakeScheduled = true
+        queue.asyncAfter(deadline: .now() + delay) {
+            self.isWakeScheduled = false
+            self.pump()
+        }
+    }
+}
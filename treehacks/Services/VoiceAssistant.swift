@@ -47,7 +47,8 @@ final class VoiceAssistant {
     private let taskStore: TaskStore
     private let contactStore: ContactStore
 
-    /// Populated if a `search_memory` tool call succeeds during processing.
+    /// Populated if a `search_memory` tool call succeeds during processing: the
+    /// best match whose video still exists, else the best match.
     private var lastClipResult: ClipSearchResult?
 
     // MARK: - API Configuration
@@ -55,6 +56,9 @@ final class VoiceAssistant {
     private static let apiURL = URL(string: "https://api.openai.com/v1/chat/completions")!
     private static let model = "gpt-4o-mini"
 
+    /// How many ranked clips `search_memory` hands back to the model in one call.
+    private static let searchMemoryCandidateCount = 3
+
     // MARK: - System Prompt
 
     private static func systemPrompt() -> String {
@@ -88,7 +92,8 @@ final class VoiceAssistant {
 
         Guidelines:
         - Be helpful, warm, and concise (2-4 sentences).
-        - When searching memory, describe what was found naturally.
+        - When searching memory, describe what was found naturally. If the memory's \
+        `video_available` is false, mention that its video is no longer available to replay.
         - When managing tasks, confirm the action and briefly repeat what changed.
         - When looking up contacts, share the relevant details.
         - When starting a Zoom call, confirm the call is being started.
@@ -110,7 +115,7 @@ final class VoiceAssistant {
                 "type": "function",
                 "function": {
                     "name": "search_memory",
-                    "description": "Search through recent video clips recorded by the smart glasses to find a specific memory. Use when the user asks about something they saw, where they placed an object, or wants to recall a recent event.",
+                    "description": "Search through recent video clips recorded by the smart glasses to find a specific memory. Use when the user asks about something they saw, where they placed an object, or wants to recall a recent event. Returns the best match plus a ranked list of candidates.",
                     "parameters": {
                         "type": "object",
                         "properties": {
@@ -296,7 +301,7 @@ final class VoiceAssistant {
     /// Process a voice query through the assistant.
     /// Runs a function-calling loop (up to 6 round-trips) and returns
     /// the final text response plus an optional clip result.
-    func process(query: String, clips: [IndexedClip]) async throws -> VoiceAssistantResponse {
+    func process(query: String, clips: ClipStore) async throws -> VoiceAssistantResponse {
         guard let apiKey = OpenAIClient.loadAPIKey() else {
             throw VoiceAssistantError.noAPIKey
         }
@@ -391,7 +396,7 @@ final class VoiceAssistant {
 
     // MARK: - Tool Dispatch
 
-    private func executeTool(name: String, argumentsJSON: String, clips: [IndexedClip]) async -> String {
+    private func executeTool(name: String, argumentsJSON: String, clips: ClipStore) async -> String {
         let args: [String: Any]
         if let data = argumentsJSON.data(using: .utf8),
            let parsed = try? JSONSerialization.jsonObject(with: data) as? [String: Any] {
@@ -416,28 +421,45 @@ final class VoiceAssistant {
 
     // MARK: - Tool: search_memory
 
-    private func executeSearchMemory(args: [String: Any], clips: [IndexedClip]) -> String {
+    private func executeSearchMemory(args: [String: Any], clips: ClipStore) -> String {
         guard let query = args["query"] as? String, !query.isEmpty else {
             return jsonString(["error": "No query provided"])
         }
 
-        guard let result = searchEngine.findBestClip(for: query, in: clips) else {
+        // Look further down for playback, since older matches may have lost their video.
+        let ranked = searchEngine.findTopClips(
+            for: query, k: max(Self.searchMemoryCandidateCount, ClipSearchEngine.playbackCandidates), in: clips)
+        let results = Array(ranked.prefix(Self.searchMemoryCandidateCount))
+        guard let best = results.first else {
             return jsonString([
                 "found": false,
-                "message": "No matching memory clips were found in the last 60 seconds of recording."
+                "message": "No matching memory clips were found in the recorded history."
             ] as [String: Any])
         }
 
-        // Store for the caller
-        lastClipResult = result
+        // Store the match to play back for the caller
+        lastClipResult = ClipSearchEngine.bestForPlayback(ranked)
+
+        let candidates: [[String: Any]] = results.map { result in
+            [
+                "description": result.clip.description,
+                "time_ago":    result.clip.timeAgoLabel,
+                "score":       result.score,
+                "method":      result.method,
+                "keywords":    Array(result.clip.keywords).joined(separator: ", "),
+                "video_available": result.clip.hasVideo
+            ] as [String: Any]
+        }
 
         return jsonString([
             "found":       true,
-            "description": result.clip.description,
-            "time_ago":    result.clip.timeAgoLabel,
-            "score":       result.score,
-            "method":      result.method,
-            "keywords":    Array(result.clip.keywords).joined(separator: ", ")
+            "description": best.clip.description,
+            "time_ago":    best.clip.timeAgoLabel,
+            "score":       best.score,
+            "method":      best.method,
+            "keywords":    Array(best.clip.keywords).joined(separator: ", "),
+            "video_available": best.clip.hasVideo,
+            "candidates":  candidates
         ] as [String: Any])
     }
 
@@ -29,9 +29,23 @@ class CameraViewController: UIViewController, ARSessionDelegate {
 
     /// Prevents overlapping Vision requests.
     private var isProcessingFrame = false
-    /// Throttle: minimum interval between frame processing (seconds).
+    /// Throttle: minimum interval between face tracking updates (seconds).
     private var lastProcessedTime: TimeInterval = 0
-    private let processingInterval: TimeInterval = 0.5
+    private let processingInterval: TimeInterval = 1.0 / 15
+    /// Full face detection runs this often; in between, each track's box is
+    /// followed by a cheap object tracker. Recognition runs less often still,
+    /// as `faceTracks` schedules it per track.
+    private let detectionInterval: TimeInterval = 0.5
+    /// Tracker results below this confidence wait for the next detection.
+    private static let minimumTrackingConfidence: VNConfidence = 0.3
+
+    /// Face tracks and their cached identities (faceQueue only).
+    private var faceTracks = FaceTrackCache<Person>()
+    private let faceQueue = DispatchQueue(label: "com.treehacks.faceTracking", qos: .userInitiated)
+    /// Object trackers following each track between detections (faceQueue only).
+    private let sequenceHandler = VNSequenceRequestHandler()
+    private var trackingRequests: [UUID: VNTrackObjectRequest] = [:]
+    private var lastDetectionTime: TimeInterval = -.infinity
 
     /// Called on every AR frame for external processing (e.g. clip indexing).
     var onFrameCaptured: ((CVPixelBuffer, CMTime) -> Void)?
@@ -97,9 +111,14 @@ extension CameraViewController: ARSCNViewDelegate {
         lastProcessedTime = currentTime
         isProcessingFrame = true
 
-        // Run face detection off the main thread
-        DispatchQueue.global(qos: .userInitiated).async { [weak self] in
-            self?.processFaceDetection(frame: frame)
+        // Run face detection or tracking off the main thread
+        faceQueue.async { [weak self] in
+            guard let self = self else { return }
+            if frame.timestamp - self.lastDetectionTime >= self.detectionInterval {
+                self.processFaceDetection(frame: frame)
+            } else {
+                self.processFaceTracking(frame: frame)
+            }
         }
     }
 }
@@ -108,29 +127,22 @@ extension CameraViewController: ARSCNViewDelegate {
 
 extension CameraViewController {
 
+    /// A detected face, its track and the track's cached identity.
+    struct TrackedFace {
+        let trackID: UUID
+        /// The detected face, or the tracker's estimate between detections.
+        let observation: VNDetectedObjectObservation
+        let person: Person?
+    }
+
+    /// Detect and track every face in the frame (on faceQueue). Faces whose track
+    /// needs recognition get one landmarks request on the detection's handler and
+    /// a batched gallery match; the others reuse their track's identity. Only the
+    /// results go to the main thread.
     func processFaceDetection(frame: ARFrame) {
+        lastDetectionTime = frame.timestamp
         let pixelBuffer = frame.capturedImage
-
-        // Create face detection request
-        let faceDetectionRequest = VNDetectFaceRectanglesRequest { [weak self] request, error in
-            guard let self = self else { return }
-
-            if let error = error {
-                print("[FaceDetection] Error: \(error)")
-                self.isProcessingFrame = false
-                return
-            }
-
-            guard let observations = request.results as? [VNFaceObservation] else {
-                self.isProcessingFrame = false
-                return
-            }
-
-            DispatchQueue.main.async {
-                self.handleFaceDetections(observations, frame: frame)
-                self.isProcessingFrame = false
-            }
-        }
+        let faceDetectionRequest = VNDetectFaceRectanglesRequest()
 
         // ARKit captures in landscape-right orientation
         let handler = VNImageRequestHandler(cvPixelBuffer: pixelBuffer, orientation: .right, options: [:])
@@ -138,78 +150,102 @@ extension CameraViewController {
             try handler.perform([faceDetectionRequest])
         } catch {
             print("[FaceDetection] Failed to perform detection: \(error)")
-            isProcessingFrame = false
+            DispatchQueue.main.async { self.isProcessingFrame = false }
+            return
         }
-    }
 
-    func handleFaceDetections(_ faces: [VNFaceObservation], frame: ARFrame) {
-        // Draw 2D bounding boxes around all detected faces
-        drawBoundingBoxes(for: faces)
+        let observations = faceDetectionRequest.results ?? []
+        let trackIndices = faceTracks.update(with: observations.map(\.boundingBox))
+
+        // Full recognition only for new, unrecognized, or re-verifying tracks
+        let time = frame.timestamp
+        let pending = observations.indices.filter { faceTracks.needsRecognition(trackIndices[$0], at: time) }
+        if !pending.isEmpty {
+            let recognized = faceRecognitionModel.recognizeFaces(pending.map { observations[$0] }, using: handler)
+            print("[FaceDetection] Recognized \(pending.count) of \(observations.count) face(s)")
+            for (index, face) in zip(pending, recognized) {
+                faceTracks.record(face.person, similarity: face.similarity, forTrack: trackIndices[index], at: time)
+                if Self.logDetectedFaceEmbeddings {
+                    logDetectedFaceFeatures(face.hasFeatures, faceIndex: index, boundingBox: face.observation.boundingBox)
+                }
+            }
+        }
 
-        print("[FaceDetection] Detected \(faces.count) face(s)")
+        let faces = observations.indices.map { i in
+            let track = faceTracks.tracks[trackIndices[i]]
+            return TrackedFace(trackID: track.id, observation: observations[i], person: track.identity)
+        }
 
-        var newLabels: [UUID: (person: Person, position: SCNVector3)] = [:]
+        // Restart the trackers from this detection.
+        trackingRequests = Dictionary(uniqueKeysWithValues: faces.map { face in
+            let request = VNTrackObjectRequest(detectedObjectObservation: face.observation)
+            request.trackingLevel = .fast
+            return (face.trackID, request)
+        })
 
-        for (index, face) in faces.enumerated() {
-            // Extract facial features for this face and log them
-            let features = faceRecognitionModel.extractFaceFeatures(face, from: frame)
-            if Self.logDetectedFaceEmbeddings {
-                logDetectedFaceFeatures(features, faceIndex: index, boundingBox: face.boundingBox)
-            }
-
-            // Convert face bounding box to world position
-            guard let worldPosition = getWorldPosition(for: face, in: frame) else { continue }
+        finishFaceFrame(faces, frame: frame)
+    }
 
-            // Attempt recognition using pre-extracted features (avoids re-extraction)
-            var person: Person? = nil
-            if let features = features {
-                person = faceRecognitionModel.matchPerson(for: features)
+    /// Follow every tracked face from the last detection (on faceQueue): one
+    /// object tracker per track on a sequence handler, with no detection or
+    /// recognition. A tracker that loses its face stops until the next detection.
+    func processFaceTracking(frame: ARFrame) {
+        var faces: [TrackedFace] = []
+        if !trackingRequests.isEmpty {
+            do {
+                try sequenceHandler.perform(Array(trackingRequests.values), on: frame.capturedImage, orientation: .right)
+            } catch {
+                print("[FaceDetection] Failed to perform tracking: \(error)")
+                trackingRequests.removeAll()
             }
-
-            if let person = person {
-                // Reuse an existing tracked face ID if close enough, otherwise assign a new one
-                let faceID = findClosestExistingFace(at: worldPosition) ?? UUID()
-                newLabels[faceID] = (person, worldPosition)
+        }
+        for (trackID, request) in trackingRequests {
+            guard let observation = request.results?.first as? VNDetectedObjectObservation,
+                  observation.confidence >= Self.minimumTrackingConfidence,
+                  let track = faceTracks.move(trackID, to: observation.boundingBox) else {
+                trackingRequests.removeValue(forKey: trackID)
+                continue
             }
+            request.inputObservation = observation
+            faces.append(TrackedFace(trackID: trackID, observation: observation, person: track.identity))
         }
+        finishFaceFrame(faces, frame: frame)
+    }
 
-        // Update or create labels for active faces
-        let activeFaceIDs = Set(newLabels.keys)
-        for (faceID, info) in newLabels {
-            updateARLabel(for: faceID, person: info.person, at: info.position)
-        }
+    /// Hand a processed frame's faces to the main thread.
+    private func finishFaceFrame(_ faces: [TrackedFace], frame: ARFrame) {
+        // Tracks that lost their identity lose their label too.
+        let liveTrackIDs = Set(faceTracks.tracks.filter { $0.identity != nil }.map(\.id))
 
-        // Remove labels for faces no longer detected
-        removeInactiveLabels(activeFaceIDs: activeFaceIDs)
+        DispatchQueue.main.async {
+            self.handleFaceDetections(faces, liveTrackIDs: liveTrackIDs, frame: frame)
+            self.isProcessingFrame = false
+        }
     }
 
-    /// Log the extracted face embedding array for every detected face.
-    private func logDetectedFaceFeatures(_ features: [Float]?, faceIndex: Int, boundingBox: CGRect) {
-        guard let features = features else {
-            print("[FaceDetection] Face #\(faceIndex + 1): could not extract features")
-            return
+    /// Draw this frame's faces and move each recognized track's label. A label
+    /// stays while its track lives and keeps its identity, even through frames
+    /// that miss its face.
+    func handleFaceDetections(_ faces: [TrackedFace], liveTrackIDs: Set<UUID>, frame: ARFrame) {
+        // Draw 2D bounding boxes around all detected faces
+        drawBoundingBoxes(for: faces.map(\.observation))
+
+        for face in faces {
+            // Convert face bounding box to world position
+            guard let person = face.person,
+                  let worldPosition = getWorldPosition(for: face.observation, in: frame) else { continue }
+            updateARLabel(for: face.trackID, person: person, at: worldPosition)
         }
-        // print("[FaceDetection] Face #\(faceIndex + 1) faceEmbedding: \(features)")
+
+        // Remove labels for faces no longer tracked or no longer recognized
+        removeInactiveLabels(activeFaceIDs: liveTrackIDs)
     }
 
-    /// Match a new detection to an existing tracked face by spatial proximity.
-    func findClosestExistingFace(at position: SCNVector3) -> UUID? {
-        let threshold: Float = 0.3 // 30cm tolerance
-        var closestID: UUID?
-        var closestDistance: Float = threshold
-
-        for (id, node) in labelNodes {
-            let dx = node.position.x - position.x
-            let dy = node.position.y - position.y
-            let dz = node.position.z - position.z
-            let distance = sqrt(dx * dx + dy * dy + dz * dz)
-            if distance < closestDistance {
-                closestDistance = distance
-                closestID = id
-            }
+    /// Log each recognized face whose landmarks yielded no features.
+    private func logDetectedFaceFeatures(_ hasFeatures: Bool, faceIndex: Int, boundingBox: CGRect) {
+        if !hasFeatures {
+            print("[FaceDetection] Face #\(faceIndex + 1): could not extract features")
         }
-
-        return closestID
     }
 }
 
@@ -218,7 +254,7 @@ extension CameraViewController {
 extension CameraViewController {
 
     /// Draw 2D bounding boxes on the overlay for each detected face.
-    func drawBoundingBoxes(for faces: [VNFaceObservation]) {
+    func drawBoundingBoxes(for faces: [VNDetectedObjectObservation]) {
         // Remove previous bounding box layers
         for layer in boundingBoxLayers {
             layer.removeFromSuperlayer()
@@ -264,7 +300,7 @@ extension CameraViewController {
     /// Face scale → distance: bigger face (larger bbox height) = closer.
     private static let distanceFromFaceScale: (min: Float, max: Float, scaleFactor: Float) = (0.7, 3.0, 0.28)
 
-    func getWorldPosition(for face: VNFaceObservation, in frame: ARFrame) -> SCNVector3? {
+    func getWorldPosition(for face: VNDetectedObjectObservation, in frame: ARFrame) -> SCNVector3? {
         let viewportSize = arView.bounds.size
         let b = face.boundingBox
 
@@ -328,6 +364,11 @@ extension CameraViewController {
 extension CameraViewController {
 
     func updateARLabel(for faceID: UUID, person: Person, at position: SCNVector3) {
+        // A track re-verified as someone else gets a new label
+        if let existingNode = labelNodes[faceID], existingNode.name != person.id {
+            existingNode.removeFromParentNode()
+            labelNodes.removeValue(forKey: faceID)
+        }
         if let existingNode = labelNodes[faceID] {
             // Smoothly animate position update
             SCNTransaction.begin()
@@ -337,6 +378,7 @@ extension CameraViewController {
         } else {
             // Create new label node
             let labelNode = createLabelNode(for: person)
+            labelNode.name = person.id
             labelNode.position = position
 
             arView.scene.rootNode.addChildNode(labelNode)
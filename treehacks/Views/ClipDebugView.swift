@@ -2,8 +2,8 @@
 //  ClipDebugView.swift
 //  treehacks
 //
-//  Debug view that displays all indexed video clips with their
-//  keywords, descriptions, embeddings status, and playable video.
+//  Debug view that displays the most recent indexed video clips with
+//  their keywords, descriptions, embeddings status, and playable video.
 //  Useful for testing the clip indexing pipeline.
 //
 
@@ -18,6 +18,16 @@ struct ClipDebugView: View {
     @State private var player: AVPlayer?
     @State private var autoRefreshTimer: Timer?
 
+    /// Rows listed. The index holds days of clips; listing them all would
+    /// rebuild and diff tens of thousands of rows on every new clip.
+    private static let recentClipLimit = 200
+
+    /// The newest clips with their positions in the store, newest first.
+    private var recentClips: [(index: Int, clip: IndexedClip)] {
+        let clips = clipManager.indexedClips
+        return clips.indices.suffix(Self.recentClipLimit).reversed().map { ($0, clips[$0]) }
+    }
+
     var body: some View {
         NavigationStack {
             List {
@@ -44,6 +54,45 @@ struct ClipDebugView: View {
                             .fontWeight(.semibold)
                             .foregroundColor(clipManager.searchEngine.isAvailable ? .green : .red)
                     }
+                    HStack {
+                        Text("Static Frames")
+                        Spacer()
+                        Text("\(clipManager.sceneGateStats.staticFrames) / \(clipManager.sceneGateStats.framesChecked)")
+                            .foregroundColor(.secondary)
+                    }
+                    HStack {
+                        Text("Saved Requests")
+                        Spacer()
+                        Text("\(clipManager.sceneGateStats.visionCallsSaved) Vision, \(clipManager.sceneGateStats.openAIRequestsSaved) OpenAI")
+                            .foregroundColor(.secondary)
+                    }
+                    HStack {
+                        Text("Vision Requests")
+                        Spacer()
+                        Text("\(clipManager.enhancementStats.requests) for \(clipManager.enhancementStats.clipsEnhanced) clips, \(clipManager.enhancementStats.clipsPacked) packed")
+                            .foregroundColor(.secondary)
+                    }
+                    HStack {
+                        Text("Stale Vision Work")
+                        Spacer()
+                        Text("\(clipManager.enhancementStats.downgraded) downgraded, \(clipManager.enhancementStats.dropped) dropped")
+                            .foregroundColor(.secondary)
+                    }
+                    HStack {
+                        Text("Frame Intake")
+                        Spacer()
+                        Text("depth \(clipManager.intakeMetrics.depth) (max \(clipManager.intakeMetrics.maxDepth)), \(clipManager.intakeMetrics.dropped) dropped, \(clipManager.intakeMetrics.analysisSkipped) write-only")
+                            .foregroundColor(.secondary)
+                    }
+                    HStack {
+                        Text("Frame Latency")
+                        Spacer()
+                        Text(String(format: "wait %.1f, write %.1f, analysis %.1f ms",
+                                    clipManager.intakeMetrics.wait.average * 1000,
+                                    clipManager.intakeMetrics.write.average * 1000,
+                                    clipManager.intakeMetrics.analysis.average * 1000))
+                            .foregroundColor(.secondary)
+                    }
                 } header: {
                     Text("Status")
                 }
@@ -84,7 +133,7 @@ struct ClipDebugView: View {
                         .frame(maxWidth: .infinity)
                         .padding(.vertical, 20)
                     } else {
-                        ForEach(Array(clipManager.indexedClips.enumerated().reversed()), id: \.element.id) { index, clip in
+                        ForEach(recentClips, id: \.clip.id) { index, clip in
                             ClipRow(clip: clip, index: index, onPlay: {
                                 playClip(clip)
                             })
@@ -95,7 +144,8 @@ struct ClipDebugView: View {
                         Text("Indexed Clips (\(clipManager.indexedClips.count))")
                         Spacer()
                         if !clipManager.indexedClips.isEmpty {
-                            Text("Newest first")
+                            Text(clipManager.indexedClips.count > Self.recentClipLimit
+                                 ? "Newest \(Self.recentClipLimit)" : "Newest first")
                                 .font(.caption)
                                 .foregroundColor(.secondary)
                         }
@@ -190,9 +240,9 @@ struct ClipRow: View {
                     // Embedding status
                     HStack(spacing: 4) {
                         Circle()
-                            .fill(clip.embedding != nil ? Color.green : Color.red)
+                            .fill(clip.hasEmbedding ? Color.green : Color.red)
                             .frame(width: 8, height: 8)
-                        Text(clip.embedding != nil ? "Embedded" : "No embedding")
+                        Text(clip.hasEmbedding ? "Embedded" : "No embedding")
                             .font(.system(size: 11))
                             .foregroundColor(.secondary)
                     }
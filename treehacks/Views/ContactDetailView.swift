@@ -75,7 +75,7 @@ struct ContactDetailView: View {
                         } else {
                             ForEach(Array(contact.faceEmbeddings.enumerated()), id: \.offset) { index, embedding in
                                 Label(
-                                    "Photo \(index + 1) — \(embedding.count)-dim vector",
+                                    "Photo \(index + 1) — \(embedding.mask.nonzeroBitCount)/\(FaceDescriptor.segmentCount) features",
                                     systemImage: "faceid"
                                 )
                                 .foregroundStyle(.green)
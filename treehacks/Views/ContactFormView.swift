@@ -19,7 +19,7 @@ struct ContactFormView: View {
     @State private var name: String = ""
     @State private var relationship: String = ""
     @State private var phoneNumber: String = ""
-    @State private var faceEmbeddings: [[Float]] = []
+    @State private var faceEmbeddings: [FaceDescriptor] = []
 
     // Photo capture state
     @State private var showingSourcePicker = false
@@ -71,7 +71,7 @@ struct ContactFormView: View {
                         ForEach(Array(faceEmbeddings.enumerated()), id: \.offset) { index, embedding in
                             HStack {
                                 Label(
-                                    "Photo \(index + 1) — \(embedding.count)-dim vector",
+                                    "Photo \(index + 1) — \(embedding.mask.nonzeroBitCount)/\(FaceDescriptor.segmentCount) features",
                                     systemImage: "faceid"
                                 )
                                 .foregroundStyle(.green)
@@ -173,7 +173,7 @@ struct ContactFormView: View {
         Task.detached(priority: .userInitiated) {
             let embedding = FaceEmbeddingExtractor.extractEmbedding(from: photo)
             await MainActor.run {
-                if let embedding, !embedding.isEmpty {
+                if let embedding {
                     faceEmbeddings.append(embedding)
                     extractionError = nil
                 } else {
@@ -29,7 +29,7 @@ struct MainCameraView: View {
     @State private var player: AVPlayer?
     @State private var playerLooper: AVPlayerLooper?
     @State private var assistantAnswer: String?
-    @State private var snapshotClips: [IndexedClip] = []
+    @State private var snapshotClips = ClipStore()
     @State private var showResult = false
     @State private var showNoResult = false
     @State private var recallVideoPaused = false
@@ -152,6 +152,15 @@ struct MainCameraView: View {
                                 if recallVideoPaused { player.pause() } else { player.play() }
                             }
                             .shadow(color: .black.opacity(0.4), radius: 8, y: 4)
+                        } else if searchResult != nil {
+                            // Searchable history outlives the recorded video.
+                            HStack(spacing: 6) {
+                                Image(systemName: "video.slash")
+                                    .font(.system(size: 12))
+                                Text("Video no longer available")
+                                    .font(.system(size: 12, weight: .medium))
+                            }
+                            .foregroundColor(.white.opacity(0.7))
                         }
                     }
                     .padding(.leading, 16)
@@ -281,15 +290,15 @@ struct MainCameraView: View {
 
                 assistantAnswer = response.answer
 
-                // If the assistant found a matching clip, show the video
-                if let clipResult = response.clipResult,
-                   FileManager.default.fileExists(atPath: clipResult.clip.fileURL.path) {
+                // If the assistant found a matching clip, show the video, or
+                // that it has been pruned while the clip stayed searchable
+                searchResult = response.clipResult
+                if let clipResult = response.clipResult, clipResult.clip.hasVideo {
 
                     let audioSession = AVAudioSession.sharedInstance()
                     try? audioSession.setCategory(.playback, mode: .default, options: [])
                     try? audioSession.setActive(true)
 
-                    searchResult = clipResult
                     let item = AVPlayerItem(url: clipResult.clip.fileURL)
                     let queuePlayer = AVQueuePlayer(playerItem: item)
                     let looper = AVPlayerLooper(player: queuePlayer, templateItem: item)
@@ -179,17 +179,24 @@ struct MemoryRecallView: View {
         }
 
         let secondsAgo = selectedMinutesAgo * 60
-        guard let recording = recordingManager.getRecording(secondsAgo: secondsAgo) else {
+        let avPlayer: AVPlayer
+        let seekTime: CMTime
+        if let playback = recordingManager.playback(secondsAgo: secondsAgo) {
+            // One item over the whole buffer, so playback runs on past segment boundaries
+            avPlayer = AVPlayer(playerItem: playback.item)
+            seekTime = playback.seekTime
+        } else if let recording = recordingManager.getRecording(secondsAgo: secondsAgo) {
+            avPlayer = AVPlayer(url: recording.url)
+            seekTime = CMTime(seconds: recording.seekTime, preferredTimescale: 600)
+        } else {
             noRecordingAvailable = true
             return
         }
 
         noRecordingAvailable = false
-        let avPlayer = AVPlayer(url: recording.url)
 
-        // Seek to the correct position within the segment
-        let seekTime = CMTime(seconds: recording.seekTime, preferredTimescale: 600)
-        avPlayer.seek(to: seekTime) { _ in
+        // Seek to the correct position within the recording
+        avPlayer.seek(to: seekTime, toleranceBefore: .zero, toleranceAfter: .zero) { _ in
             avPlayer.play()
         }
 
@@ -4,7 +4,8 @@
 //
 //  Voice-based memory query interface. The user taps a microphone button,
 //  asks a question (e.g. "Where did I put my keys?"), and the app finds
-//  and plays back the most relevant video clip from the last 60 seconds.
+//  and plays back the most relevant video clip. Clips stay searchable for
+//  days after their video is pruned; those show that it is unavailable.
 //
 //  Designed with large, accessible controls for dementia patients.
 //
@@ -32,7 +33,7 @@ struct VoiceQueryView: View {
     /// Debug info
     @State private var debugInfo = ""
     /// Snapshot of clips taken at open time (to survive clip manager stop)
-    @State private var snapshotClips: [IndexedClip] = []
+    @State private var snapshotClips = ClipStore()
 
     var body: some View {
         NavigationStack {
@@ -165,7 +166,7 @@ struct VoiceQueryView: View {
 
                     // Results
                     if hasSearched && !isSearching {
-                        if let result = searchResult, let player = player {
+                        if let result = searchResult {
                             VStack(spacing: 12) {
                                 HStack {
                                     Image(systemName: "checkmark.circle.fill")
@@ -207,10 +208,26 @@ struct VoiceQueryView: View {
                                     )
                                 }
 
-                                // Video player
-                                VideoPlayer(player: player)
-                                    .frame(height: 240)
-                                    .clipShape(RoundedRectangle(cornerRadius: 14))
+                                // Video player, or why there is none
+                                if let player = player {
+                                    VideoPlayer(player: player)
+                                        .frame(height: 240)
+                                        .clipShape(RoundedRectangle(cornerRadius: 14))
+                                } else {
+                                    HStack(spacing: 8) {
+                                        Image(systemName: "video.slash")
+                                            .font(.system(size: 16))
+                                        Text("The video of this memory is no longer available")
+                                            .font(.system(size: 15, weight: .medium))
+                                    }
+                                    .foregroundColor(.secondary)
+                                    .frame(maxWidth: .infinity)
+                                    .padding(.vertical, 16)
+                                    .background(
+                                        RoundedRectangle(cornerRadius: 14)
+                                            .fill(Color(.secondarySystemBackground))
+                                    )
+                                }
 
                                 // Match info
                                 VStack(alignment: .leading, spacing: 4) {
@@ -302,7 +319,7 @@ struct VoiceQueryView: View {
                 // camera from ARKit and freeze the AR preview.
                 clipManager.stop()
 
-                let embeddedCount = snapshotClips.filter { $0.embedding != nil }.count
+                let embeddedCount = snapshotClips.filter(\.hasEmbedding).count
                 debugInfo = "Clips: \(snapshotClips.count) total, \(embeddedCount) with embeddings"
                 debugInfo += "\nSearch engine: \(clipManager.searchEngine.isAvailable ? "Ready" : "UNAVAILABLE")"
 
@@ -356,7 +373,7 @@ struct VoiceQueryView: View {
             showNoTranscriptWarning = false
 
             // Update debug info with current clip state
-            let embeddedCount = snapshotClips.filter { $0.embedding != nil }.count
+            let embeddedCount = snapshotClips.filter(\.hasEmbedding).count
             debugInfo = "Clips: \(snapshotClips.count) total, \(embeddedCount) with embeddings"
             debugInfo += "\nSearch engine: \(clipManager.searchEngine.isAvailable ? "Ready" : "UNAVAILABLE")"
             debugInfo += "\nStarting speech recognition..."
@@ -393,14 +410,14 @@ struct VoiceQueryView: View {
         // Run search on background thread
         DispatchQueue.global(qos: .userInitiated).async {
             let searchEngine = clipManager.searchEngine
-            let result = searchEngine.findBestClip(for: trimmedQuery, in: clips)
+            let result = searchEngine.findBestPlayableClip(for: trimmedQuery, in: clips)
 
             // Build debug scores
-            let allScores = searchEngine.scoreAllClips(for: trimmedQuery, in: clips)
+            let topScores = searchEngine.scoreAllClips(for: trimmedQuery, in: clips, limit: 5)
             var scoreLog = ""
-            for (i, scored) in allScores.prefix(5).enumerated() {
+            for (i, scored) in topScores.enumerated() {
                 let kw = scored.clip.keywords.prefix(3).joined(separator: ", ")
-                scoreLog += "\n  #\(i): score=\(String(format: "%.3f", scored.score)) method=\(scored.clip.embedding != nil ? "emb" : "none") [\(kw)]"
+                scoreLog += "\n  #\(i): score=\(String(format: "%.3f", scored.score)) method=\(scored.clip.hasEmbedding ? "emb" : "none") [\(kw)]"
             }
 
             DispatchQueue.main.async {
@@ -411,14 +428,22 @@ struct VoiceQueryView: View {
                 let resultScore = result?.score ?? 0
                 debugInfo += "\nResult: \(resultMethod) score=\(String(format: "%.3f", resultScore))"
                 debugInfo += "\nTop scores:" + scoreLog
+                let cacheStats = clipManager.searchEngine.queryCacheStats
+                debugInfo += "\nQuery cache: \(cacheStats.hits) hit(s), \(cacheStats.misses) miss(es)"
+                let embeddingMetrics = clipManager.searchEngine.embeddingMetrics
+                debugInfo += String(format: "\nEmbedding: %d busy, %d query/%d indexing queued, query wait avg %.0f ms max %.0f ms",
+                                    embeddingMetrics.busyWorkers,
+                                    embeddingMetrics.interactive.queued, embeddingMetrics.background.queued,
+                                    embeddingMetrics.interactive.averageWait * 1000, embeddingMetrics.interactive.maxWait * 1000)
                 print("[VoiceQueryView] Search result: method=\(resultMethod) score=\(String(format: "%.3f", resultScore))")
 
                 if let result = result {
-                    // Verify clip file exists
-                    let fileExists = FileManager.default.fileExists(atPath: result.clip.fileURL.path)
+                    // The index outlives the video, so the best match may have none left
+                    let fileExists = result.clip.hasVideo
                     debugInfo += "\nFile: \(result.clip.fileURL.lastPathComponent) exists=\(fileExists)"
                     print("[VoiceQueryView] Clip file: \(result.clip.fileURL.lastPathComponent) exists=\(fileExists)")
 
+                    searchResult = result
                     if fileExists {
                         // Set audio session to playback BEFORE creating the player
                         let audioSession = AVAudioSession.sharedInstance()
@@ -431,33 +456,31 @@ struct VoiceQueryView: View {
                             debugInfo += "\n⚠️ Audio session error: \(error.localizedDescription)"
                         }
 
-                        searchResult = result
                         let avPlayer = AVPlayer(url: result.clip.fileURL)
                         self.player = avPlayer
                         avPlayer.play()
                         print("[VoiceQueryView] Playing clip")
+                    } else {
+                        debugInfo += "\n⚠️ Clip video already pruned (index outlives video)"
+                        player = nil
+                    }
 
-                        // Generate natural-language answer via OpenAI when API key is set
-                        let queryForAI = trimmedQuery
-                        Task { @MainActor in
-                            isGeneratingAnswer = true
-                            defer { isGeneratingAnswer = false }
-                            do {
-                                if let answer = try await OpenAIClient.generateAnswer(
-                                    memory: result.clip.description,
-                                    question: queryForAI
-                                ) {
-                                    openAIAnswer = answer
-                                }
-                            } catch {
-                                // No answer shown; user still has the video and clip description
-                                print("[VoiceQueryView] OpenAI error: \(error)")
+                    // Generate natural-language answer via OpenAI when API key is set
+                    let queryForAI = trimmedQuery
+                    Task { @MainActor in
+                        isGeneratingAnswer = true
+                        defer { isGeneratingAnswer = false }
+                        do {
+                            if let answer = try await OpenAIClient.generateAnswer(
+                                memory: result.clip.description,
+                                question: queryForAI
+                            ) {
+                                openAIAnswer = answer
                             }
+                        } catch {
+                            // No answer shown; user still has the video and clip description
+                            print("[VoiceQueryView] OpenAI error: \(error)")
                         }
-                    } else {
-                        debugInfo += "\n❌ ERROR: Clip file was deleted!"
-                        searchResult = nil
-                        player = nil
                     }
                 } else {
                     searchResult = nil
@@ -0,0 +1,167 @@
+//
+//  FaceFeatureBuilderTests.swift
+//  treehacksTests
+//
+
+import Testing
+@testable import treehacks
+
+struct FaceFeatureBuilderTests {
+
+    private typealias Region = FaceDescriptor.Region
+
+    private func descriptor(_ fixture: [[Double]]) -> FaceDescriptor {
+        FaceDescriptor { builder in
+            for (region, points) in zip(Region.allCases, fixture) {
+                points.withUnsafeBufferPointer { builder.add(region, points: $0) }
+            }
+        }
+    }
+
+    private func slots(_ descriptor: FaceDescriptor, _ region: Region) -> ArraySlice<Float> {
+        let offset = FaceDescriptor.segmentOffsets[region.rawValue]
+        return descriptor.values[offset..<offset + region.pointCount * 2]
+    }
+
+    private func measure(_ descriptor: FaceDescriptor, _ measure: FaceDescriptor.Measure) -> Float {
+        descriptor.values[FaceDescriptor.segmentOffsets[Region.allCases.count + measure.rawValue]]
+    }
+
+    @Test func fixturesMatchLayout() {
+        #expect(FaceLandmarkFixtures.regionNames.count == Region.allCases.count)
+        for fixture in FaceLandmarkFixtures.all {
+            #expect(fixture.count == Region.allCases.count)
+        }
+    }
+
+    @Test func fullFaceFillsEverySlot() {
+        let face = FaceLandmarkFixtures.frontal
+        let built = descriptor(face)
+
+        #expect(built.values.count == FaceDescriptor.dimension)
+        #expect(FaceDescriptor.dimension % 8 == 0)
+        #expect(built.mask == FaceDescriptor.fullMask)
+        for region in Region.allCases {
+            #expect(Array(slots(built, region)) == face[region.rawValue].map { Float($0) })
+        }
+        #expect(built.values[FaceDescriptor.usedLength...].allSatisfy { $0 == 0 })
+    }
+
+    @Test func geometricMeasures() {
+        let face = FaceLandmarkFixtures.frontal
+        let built = descriptor(face)
+
+        func xs(_ region: Region) -> [Double] { stride(from: 0, to: face[region.rawValue].count, by: 2).map { face[region.rawValue][$0] } }
+        func ys(_ region: Region) -> [Double] { stride(from: 1, to: face[region.rawValue].count, by: 2).map { face[region.rawValue][$0] } }
+        func width(_ region: Region) -> Double { xs(region).max()! - xs(region).min()! }
+        func height(_ region: Region) -> Double { ys(region).max()! - ys(region).min()! }
+        func meanY(_ region: Region) -> Double { ys(region).reduce(0, +) / Double(ys(region).count) }
+
+        #expect(abs(measure(built, .eyeWidthRatio) - Float(width(.leftEye) / width(.rightEye))) < 1e-6)
+        #expect(abs(measure(built, .pupilDistance) - Float(xs(.rightPupil)[0] - xs(.leftPupil)[0])) < 1e-6)
+        #expect(abs(measure(built, .noseToMouth) - Float(abs(meanY(.outerLips) - meanY(.nose)))) < 1e-6)
+        #expect(abs(measure(built, .faceAspect) - Float(width(.faceContour) / height(.faceContour))) < 1e-6)
+        #expect(abs(measure(built, .mouthWidth) - Float(width(.outerLips))) < 1e-6)
+    }
+
+    @Test func missingRegionsStayZeroAndUnmasked() {
+        let built = descriptor(FaceLandmarkFixtures.frontalRetake)
+
+        for region in [Region.leftPupil, .rightPupil] {
+            #expect(built.mask & FaceDescriptor.bit(region) == 0)
+            #expect(slots(built, region).allSatisfy { $0 == 0 })
+        }
+        #expect(built.mask & FaceDescriptor.bit(.pupilDistance) == 0)
+        #expect(measure(built, .pupilDistance) == 0)
+        #expect(built.mask & FaceDescriptor.bit(.mouthWidth) != 0)
+    }
+
+    @Test func resamplesOtherPointCounts() {
+        let contour = FaceLandmarkFixtures.frontalRetake[Region.faceContour.rawValue]
+        #expect(contour.count / 2 != Region.faceContour.pointCount)
+
+        let built = descriptor(FaceLandmarkFixtures.frontalRetake)
+        let resampled = slots(built, .faceContour)
+        #expect(resampled.count == Region.faceContour.pointCount * 2)
+        // The outline keeps its endpoints.
+        #expect(resampled.prefix(2).elementsEqual(contour.prefix(2).map { Float($0) }))
+        #expect(resampled.suffix(2).elementsEqual(contour.suffix(2).map { Float($0) }))
+    }
+
+    @Test func overwritesReusedBuffer() {
+        let buffer = UnsafeMutablePointer<Float>.allocate(capacity: FaceDescriptor.dimension)
+        defer { buffer.deallocate() }
+        buffer.initialize(repeating: 7, count: FaceDescriptor.dimension)
+
+        var builder = FaceFeatureBuilder(writingInto: buffer)
+        FaceLandmarkFixtures.frontal[Region.nose.rawValue].withUnsafeBufferPointer {
+            builder.add(.nose, points: $0)
+        }
+        let mask = builder.finish()
+
+        #expect(mask == FaceDescriptor.bit(.nose))
+        let nose = FaceDescriptor.segmentOffsets[Region.nose.rawValue]
+        for i in 0..<FaceDescriptor.dimension where !(nose..<nose + Region.nose.pointCount * 2).contains(i) {
+            #expect(buffer[i] == 0)
+        }
+    }
+
+    @Test func maskedSimilarityMatchesAcrossMissingRegions() {
+        let enrolled = descriptor(FaceLandmarkFixtures.frontal)
+        let retake = descriptor(FaceLandmarkFixtures.frontalRetake)
+        let other = descriptor(FaceLandmarkFixtures.otherPerson)
+
+        let same = FaceMatcher.maskedSimilarity(enrolled, retake)
+        let different = FaceMatcher.maskedSimilarity(other, retake)
+        #expect(same != nil && different != nil)
+        #expect(same! > FaceMatcher.threshold)
+        #expect(same! > different!)
+
+        let gallery = FaceGallery(galleries: [[other], [enrolled]])
+        let workspace = FaceGallery.Workspace()
+        gallery.match([retake, nil], in: workspace)
+        #expect(workspace.matches.count == 2)
+        #expect(workspace.matches[0]?.owner == 1)
+        #expect(abs((workspace.matches[0]?.similarity ?? 0) - same!) < 1e-4)
+        #expect(workspace.matches[1] == nil)
+    }
+
+    @Test func matchBuildsIntoWorkspace() {
+        let enrolled = descriptor(FaceLandmarkFixtures.frontal)
+        let other = descriptor(FaceLandmarkFixtures.otherPerson)
+        let gallery = FaceGallery(galleries: [[other], [enrolled]])
+        let faces = [FaceLandmarkFixtures.frontalRetake, [], FaceLandmarkFixtures.otherPerson]
+
+        let built = FaceGallery.Workspace()
+        gallery.match(faceCount: faces.count, in: built) { i, builder in
+            for (region, points) in zip(Region.allCases, faces[i]) {
+                points.withUnsafeBufferPointer { builder.add(region, points: $0) }
+            }
+        }
+        let reference = FaceGallery.Workspace()
+        gallery.match(faces.map { $0.isEmpty ? nil : descriptor($0) }, in: reference)
+
+        #expect(built.matches.count == faces.count)
+        for (a, b) in zip(built.matches, reference.matches) {
+            #expect(a?.owner == b?.owner)
+            #expect(abs((a?.similarity ?? 0) - (b?.similarity ?? 0)) < 1e-6)
+        }
+        #expect(built.matches[0]?.owner == 1)
+        #expect(built.matches[1] == nil)
+    }
+
+    @Test func storedAndLegacyRoundTrip() {
+        let built = descriptor(FaceLandmarkFixtures.frontal)
+
+        let stored = FaceDescriptor(stored: built.stored)
+        #expect(stored?.values == built.values)
+        #expect(stored?.mask == built.mask)
+
+        // Version 1 concatenated the present regions, then the measures.
+        let legacy = FaceLandmarkFixtures.frontal.flatMap { $0.map { Float($0) } }
+            + FaceDescriptor.Measure.allCases.map { measure(built, $0) }
+        let migrated = FaceDescriptor(legacy: legacy)
+        #expect(migrated?.values == built.values)
+        #expect(migrated?.mask == built.mask)
+    }
+}
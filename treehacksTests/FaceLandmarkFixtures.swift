@@ -0,0 +1,101 @@
+//
+//  FaceLandmarkFixtures.swift
+//  treehacksTests
+//
+//  Landmark fixtures in Vision's normalized face coordinates: each region's
+//  points in landmark order as x/y interleaved Doubles (the memory layout
+//  of `[CGPoint]`), regions in `FaceDescriptor.Region` order, empty when
+//  absent. No app imports, so the benchmarks package shares this file.
+//
+
+enum FaceLandmarkFixtures {
+
+    /// Region order of every fixture.
+    static let regionNames = ["faceContour", "leftEye", "rightEye", "leftEyebrow", "rightEyebrow", "nose", "noseCrest", "medianLine", "outerLips", "innerLips", "leftPupil", "rightPupil"]
+
+    /// Person A, frontal, every region present.
+    static let frontal: [[Double]] = [
+        // faceContour
+        [0.0800, 0.7200, 0.0881, 0.5912, 0.1120, 0.4674, 0.1508, 0.3533, 0.2030, 0.2533, 0.2667, 0.1712, 0.3393, 0.1102, 0.4181, 0.0727, 0.5000, 0.0600, 0.5819, 0.0727, 0.6607, 0.1102, 0.7333, 0.1712, 0.7970, 0.2533, 0.8492, 0.3533, 0.8880, 0.4674, 0.9119, 0.5912, 0.9200, 0.7200],
+        // leftEye
+        [0.2400, 0.6200, 0.2634, 0.6412, 0.3200, 0.6500, 0.3766, 0.6412, 0.4000, 0.6200, 0.3766, 0.5988, 0.3200, 0.5900, 0.2634, 0.5988],
+        // rightEye
+        [0.6024, 0.6200, 0.6251, 0.6412, 0.6800, 0.6500, 0.7349, 0.6412, 0.7576, 0.6200, 0.7349, 0.5988, 0.6800, 0.5900, 0.6251, 0.5988],
+        // leftEyebrow
+        [0.2000, 0.7300, 0.2440, 0.7476, 0.2880, 0.7585, 0.3320, 0.7585, 0.3760, 0.7476, 0.4200, 0.7300],
+        // rightEyebrow
+        [0.5800, 0.7300, 0.6240, 0.7476, 0.6680, 0.7585, 0.7120, 0.7585, 0.7560, 0.7476, 0.8000, 0.7300],
+        // nose
+        [0.5800, 0.4200, 0.5566, 0.3846, 0.5000, 0.3700, 0.4434, 0.3846, 0.4200, 0.4200, 0.4434, 0.4554, 0.5000, 0.4700, 0.5566, 0.4554],
+        // noseCrest
+        [0.5000, 0.6000, 0.5000, 0.5720, 0.5000, 0.5440, 0.5000, 0.5160, 0.5000, 0.4880, 0.5000, 0.4600],
+        // medianLine
+        [0.5000, 0.9500, 0.5000, 0.8511, 0.5000, 0.7522, 0.5000, 0.6533, 0.5000, 0.5544, 0.5000, 0.4556, 0.5000, 0.3567, 0.5000, 0.2578, 0.5000, 0.1589, 0.5000, 0.0600],
+        // outerLips
+        [0.3500, 0.2400, 0.3649, 0.2639, 0.4065, 0.2830, 0.4666, 0.2936, 0.5334, 0.2936, 0.5935, 0.2830, 0.6351, 0.2639, 0.6500, 0.2400, 0.6351, 0.2161, 0.5935, 0.1970, 0.5334, 0.1864, 0.4666, 0.1864, 0.4065, 0.1970, 0.3649, 0.2161],
+        // innerLips
+        [0.3950, 0.2400, 0.4475, 0.2530, 0.5525, 0.2530, 0.6050, 0.2400, 0.5525, 0.2270, 0.4475, 0.2270],
+        // leftPupil
+        [0.3200, 0.6200],
+        // rightPupil
+        [0.6800, 0.6200],
+    ]
+
+    /// Person A again: small landmark noise, pupils missing and an 11-point contour (Vision's older constellation).
+    static let frontalRetake: [[Double]] = [
+        // faceContour
+        [0.0771, 0.7223, 0.1060, 0.5154, 0.1655, 0.3379, 0.2586, 0.1844, 0.3669, 0.0890, 0.4964, 0.0565, 0.6313, 0.0971, 0.7510, 0.1858, 0.8416, 0.3357, 0.8945, 0.5180, 0.9249, 0.7234],
+        // leftEye
+        [0.2430, 0.6197, 0.2596, 0.6447, 0.3180, 0.6536, 0.3822, 0.6400, 0.3988, 0.6254, 0.3793, 0.5948, 0.3155, 0.5858, 0.2683, 0.6025],
+        // rightEye
+        [0.5982, 0.6239, 0.6309, 0.6431, 0.6782, 0.6506, 0.7304, 0.6354, 0.7633, 0.6218, 0.7352, 0.6040, 0.6792, 0.5945, 0.6290, 0.5953],
+        // leftEyebrow
+        [0.1970, 0.7275, 0.2409, 0.7487, 0.2851, 0.7576, 0.3276, 0.7635, 0.3742, 0.7471, 0.4210, 0.7349],
+        // rightEyebrow
+        [0.5790, 0.7350, 0.6240, 0.7480, 0.6683, 0.7528, 0.7113, 0.7547, 0.7500, 0.7512, 0.7961, 0.7297],
+        // nose
+        [0.5827, 0.4207, 0.5545, 0.3849, 0.5007, 0.3734, 0.4387, 0.3854, 0.4170, 0.4173, 0.4467, 0.4554, 0.5007, 0.4731, 0.5615, 0.4547],
+        // noseCrest
+        [0.5014, 0.6001, 0.5001, 0.5743, 0.4994, 0.5444, 0.4997, 0.5213, 0.5024, 0.4925, 0.5053, 0.4571],
+        // medianLine
+        [0.5007, 0.9553, 0.5041, 0.8468, 0.4955, 0.7515, 0.4949, 0.6502, 0.4949, 0.5565, 0.5034, 0.4603, 0.4959, 0.3593, 0.5019, 0.2535, 0.5046, 0.1645, 0.4966, 0.0654],
+        // outerLips
+        [0.3488, 0.2398, 0.3707, 0.2679, 0.4024, 0.2822, 0.4668, 0.2917, 0.5297, 0.2914, 0.5962, 0.2772, 0.6358, 0.2631, 0.6442, 0.2380, 0.6366, 0.2163, 0.5883, 0.2028, 0.5368, 0.1920, 0.4619, 0.1836, 0.4010, 0.2003, 0.3621, 0.2117],
+        // innerLips
+        [0.3941, 0.2449, 0.4513, 0.2501, 0.5483, 0.2580, 0.6058, 0.2424, 0.5476, 0.2217, 0.4498, 0.2261],
+        // leftPupil
+        [],
+        // rightPupil
+        [],
+    ]
+
+    /// Person B, frontal, every region present.
+    static let otherPerson: [[Double]] = [
+        // faceContour
+        [0.1200, 0.7200, 0.1273, 0.5912, 0.1489, 0.4674, 0.1840, 0.3533, 0.2313, 0.2533, 0.2889, 0.1712, 0.3546, 0.1102, 0.4259, 0.0727, 0.5000, 0.0600, 0.5741, 0.0727, 0.6454, 0.1102, 0.7111, 0.1712, 0.7687, 0.2533, 0.8160, 0.3533, 0.8511, 0.4674, 0.8727, 0.5912, 0.8800, 0.7200],
+        // leftEye
+        [0.2550, 0.5800, 0.2740, 0.6012, 0.3200, 0.6100, 0.3660, 0.6012, 0.3850, 0.5800, 0.3660, 0.5588, 0.3200, 0.5500, 0.2740, 0.5588],
+        // rightEye
+        [0.6170, 0.5800, 0.6354, 0.6012, 0.6800, 0.6100, 0.7246, 0.6012, 0.7430, 0.5800, 0.7246, 0.5588, 0.6800, 0.5500, 0.6354, 0.5588],
+        // leftEyebrow
+        [0.2000, 0.6900, 0.2440, 0.7076, 0.2880, 0.7185, 0.3320, 0.7185, 0.3760, 0.7076, 0.4200, 0.6900],
+        // rightEyebrow
+        [0.5800, 0.6900, 0.6240, 0.7076, 0.6680, 0.7185, 0.7120, 0.7185, 0.7560, 0.7076, 0.8000, 0.6900],
+        // nose
+        [0.5800, 0.4000, 0.5566, 0.3646, 0.5000, 0.3500, 0.4434, 0.3646, 0.4200, 0.4000, 0.4434, 0.4354, 0.5000, 0.4500, 0.5566, 0.4354],
+        // noseCrest
+        [0.5000, 0.5600, 0.5000, 0.5360, 0.5000, 0.5120, 0.5000, 0.4880, 0.5000, 0.4640, 0.5000, 0.4400],
+        // medianLine
+        [0.5000, 0.9500, 0.5000, 0.8511, 0.5000, 0.7522, 0.5000, 0.6533, 0.5000, 0.5544, 0.5000, 0.4556, 0.5000, 0.3567, 0.5000, 0.2578, 0.5000, 0.1589, 0.5000, 0.0600],
+        // outerLips
+        [0.3200, 0.2700, 0.3378, 0.2939, 0.3878, 0.3130, 0.4599, 0.3236, 0.5401, 0.3236, 0.6122, 0.3130, 0.6622, 0.2939, 0.6800, 0.2700, 0.6622, 0.2461, 0.6122, 0.2270, 0.5401, 0.2164, 0.4599, 0.2164, 0.3878, 0.2270, 0.3378, 0.2461],
+        // innerLips
+        [0.3740, 0.2700, 0.4370, 0.2830, 0.5630, 0.2830, 0.6260, 0.2700, 0.5630, 0.2570, 0.4370, 0.2570],
+        // leftPupil
+        [0.3200, 0.5800],
+        // rightPupil
+        [0.6800, 0.5800],
+    ]
+
+    static let all = [frontal, frontalRetake, otherPerson]
+}
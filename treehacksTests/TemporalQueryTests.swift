@@ -0,0 +1,114 @@
+//
+//  TemporalQueryTests.swift
+//  treehacksTests
+//
+
+import Foundation
+import Testing
+@testable import treehacks
+
+struct TemporalQueryTests {
+
+    private let calendar: Calendar = {
+        var calendar = Calendar(identifier: .gregorian)
+        calendar.timeZone = TimeZone(identifier: "UTC")!
+        return calendar
+    }()
+
+    /// Saturday 14 February 2026, 15:30 UTC.
+    private var now: Date { date(day: 14, hour: 15, minute: 30) }
+
+    private func date(day: Int, hour: Int, minute: Int = 0) -> Date {
+        calendar.date(from: DateComponents(year: 2026, month: 2, day: day, hour: hour, minute: minute))!
+    }
+
+    private func ago(_ seconds: TimeInterval) -> Date {
+        now.addingTimeInterval(-seconds)
+    }
+
+    private func parse(_ query: String) -> TemporalQuery {
+        TemporalQuery(query, now: now, calendar: calendar)
+    }
+
+    private func expectRange(_ query: String, from start: Date, to end: Date) {
+        let range = parse(query).range
+        #expect(range?.start == start, "\(query)")
+        #expect(range?.end == end, "\(query)")
+    }
+
+    @Test func noTimePhraseSearchesAllHistory() {
+        let parsed = parse("where are my keys")
+        #expect(parsed.text == "where are my keys")
+        #expect(parsed.range == nil)
+    }
+
+    @Test func minutesAgoCoverHalfTheAmountEitherSide() {
+        let parsed = parse("where are my keys 10 minutes ago")
+        #expect(parsed.text == "where are my keys")
+        #expect(parsed.range == DateInterval(start: ago(15 * 60), end: ago(5 * 60)))
+        expectRange("twenty minutes ago", from: ago(30 * 60), to: ago(10 * 60))
+        expectRange("45 mins ago", from: ago(67.5 * 60), to: ago(22.5 * 60))
+    }
+
+    @Test func hoursAgoCoverHalfTheAmountEitherSide() {
+        let parsed = parse("who did I meet 2 hours ago")
+        #expect(parsed.text == "who did I meet")
+        #expect(parsed.range == DateInterval(start: ago(3 * 3600), end: ago(3600)))
+        expectRange("three hours ago", from: ago(4.5 * 3600), to: ago(1.5 * 3600))
+    }
+
+    @Test func daysAgoCoverThatCalendarDay() {
+        expectRange("3 days ago", from: date(day: 11, hour: 0), to: date(day: 12, hour: 0))
+        expectRange("two days ago", from: date(day: 12, hour: 0), to: date(day: 13, hour: 0))
+        expectRange("a day ago", from: date(day: 13, hour: 0), to: date(day: 14, hour: 0))
+    }
+
+    @Test func vaguePhrasesCoverTheRecentPast() {
+        expectRange("just now", from: ago(2 * 60), to: now)
+        expectRange("a few minutes ago", from: ago(5 * 60), to: now)
+        expectRange("one minute ago", from: ago(5 * 60), to: now)
+        expectRange("in the past hour", from: ago(3600), to: now)
+        expectRange("an hour ago", from: ago(2 * 3600), to: now)
+        expectRange("a couple of hours ago", from: ago(4 * 3600), to: now)
+        expectRange("the last few hours", from: ago(4 * 3600), to: now)
+    }
+
+    @Test func partsOfTodayAreClippedToNow() {
+        expectRange("this morning", from: date(day: 14, hour: 5), to: date(day: 14, hour: 12))
+        expectRange("this afternoon", from: date(day: 14, hour: 12), to: now)
+        expectRange("earlier today", from: date(day: 14, hour: 0), to: now)
+    }
+
+    @Test func partOfTodayNotYetStartedIsIgnored() {
+        let parsed = parse("what is on tonight")
+        #expect(parsed.text == "what is on tonight")
+        #expect(parsed.range == nil)
+    }
+
+    @Test func yesterdayAndItsParts() {
+        expectRange("yesterday", from: date(day: 13, hour: 0), to: date(day: 14, hour: 0))
+        expectRange("yesterday morning", from: date(day: 13, hour: 5), to: date(day: 13, hour: 12))
+        expectRange("yesterday afternoon", from: date(day: 13, hour: 12), to: date(day: 13, hour: 17))
+        expectRange("yesterday evening", from: date(day: 13, hour: 17), to: date(day: 14, hour: 0))
+        expectRange("last night", from: date(day: 13, hour: 18), to: date(day: 14, hour: 5))
+    }
+
+    @Test func earlierRulesWin() {
+        // Longer phrases before the phrases they contain.
+        let morning = parse("Yesterday Morning at the park")
+        #expect(morning.text == "at the park")
+        #expect(morning.range == DateInterval(start: date(day: 13, hour: 5), end: date(day: 13, hour: 12)))
+        expectRange("over the past couple of hours", from: ago(4 * 3600), to: now)
+        // Between two phrases, the one whose rule comes first is used.
+        let both = parse("this morning about 10 minutes ago")
+        #expect(both.text == "this morning about")
+        #expect(both.range == DateInterval(start: ago(15 * 60), end: ago(5 * 60)))
+    }
+
+    @Test func queryThatIsOnlyATimePhraseKeepsItsWords() {
+        let parsed = parse("just now?")
+        #expect(parsed.text == "just now?")
+        #expect(parsed.range == DateInterval(start: ago(2 * 60), end: now))
+        #expect(parse("what happened 5 minutes ago").text == "what happened")
+    }
+}